@@ -0,0 +1,47 @@
+/**
+ * @file datagen.h
+ * @brief Synthetic dataset generator header file
+ *
+ */
+
+#include "../../vehicle/src/vehicle.cpp"
+
+using namespace std;
+
+/**
+ * @struct DatagenOptions
+ * @brief Cardinalities and settings of a generated dataset.
+ */
+struct DatagenOptions {
+    string outputDir = ".";                 ///< Folder the .dat files are written to.
+    uint64_t seed = 1;                      ///< Seed; the same seed always yields the same files.
+    long long vehicles = 1000;              ///< Number of vehicles in customer_vehicle.dat.
+    long long customers = 300;              ///< Number of distinct customers owning the vehicles.
+    int models = 20;                        ///< Number of distinct vehicle models.
+    int partsPerModel = 25;                 ///< Number of parts per model in vehicle_parts.dat.
+    int days = 365;                         ///< Number of calendar days covered by appointments.
+    int appointmentsPerDay = 20;            ///< Mean number of appointments per day.
+    double skew = 1.0;                      ///< Zipf exponent of appointments over days, 0 for uniform.
+    long long historyRecords = 1000;        ///< Number of reports in history.dat.
+    int startYear = 2024;                   ///< First year of the generated calendar.
+    int threads = 0;                        ///< Worker threads, 0 for one per hardware thread.
+};
+
+/**
+ * @brief Number of records one worker renders before its buffer is written out.
+ */
+const long long datagenChunkRecords = 65536;
+
+/**
+ * @brief Random streams, one per generated attribute, so values do not depend on generation order.
+ */
+enum DatagenStream : uint64_t {
+    StreamVehicleCustomer = 1,
+    StreamVehicleModel,
+    StreamPartPrice,
+    StreamDayRank,
+    StreamAppointmentVehicle,
+    StreamHistoryVehicle,
+    StreamHistoryDay,
+    StreamHistoryType
+};
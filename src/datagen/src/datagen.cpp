@@ -0,0 +1,405 @@
+/**
+ * @brief This directive includes the "datagen.h" header file,
+ *        which contains the options of the synthetic dataset generator
+ *        and pulls in the vehicle library whose file formats it produces.
+ */
+#include "../header/datagen.h"
+
+#include <chrono>
+#include <cmath>
+
+/**
+ * @brief First names used to build customer names.
+ */
+const char* firstNames[] = { "Ahmet", "Ayse", "Mehmet", "Fatma", "Mustafa", "Zeynep", "Emre", "Elif", "Can", "Deniz",
+                             "John", "Jane", "Maria", "David", "Sarah", "Omer", "Selin", "Burak", "Ece", "Kerem" };
+
+/**
+ * @brief Last names used to build customer names.
+ */
+const char* lastNames[] = { "Yilmaz", "Kaya", "Demir", "Sahin", "Celik", "Yildiz", "Aydin", "Ozturk", "Arslan", "Dogan",
+                            "Smith", "Johnson", "Brown", "Garcia", "Miller", "Kilic", "Aslan", "Cetin", "Kara", "Koc" };
+
+/**
+ * @brief Brands used to build model names.
+ */
+const char* brands[] = { "Fiat", "Renault", "Toyota", "Ford", "Volkswagen", "Hyundai", "Honda", "Opel", "Peugeot", "Dacia" };
+
+/**
+ * @brief Components used to build part names.
+ */
+const char* components[] = { "BrakePad", "BrakeDisc", "OilFilter", "AirFilter", "FuelFilter", "SparkPlug", "Battery", "Alternator",
+                             "Starter", "Radiator", "WaterPump", "TimingBelt", "Clutch", "ShockAbsorber", "Headlight", "Taillight",
+                             "WiperBlade", "Thermostat", "Turbocharger", "Gearbox", "Exhaust", "Catalyst", "Injector", "Mirror", "Tire" };
+
+/**
+ * @brief Operation types written to the history file.
+ */
+const char* operationTypes[] = { "Repair", "Maintenance", "Inspection", "Warranty" };
+
+/**
+ * @brief Mixes a 64-bit value with the SplitMix64 finalizer.
+ *
+ * @param value The value to mix.
+ * @return The mixed value.
+ */
+uint64_t splitMix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Returns the random value of one attribute of one record.
+ *
+ * The value only depends on the seed, the attribute stream and the record index,
+ * so records can be generated by any thread in any order.
+ *
+ * @param options The generator options holding the seed.
+ * @param stream The attribute stream.
+ * @param index The record index.
+ * @return A uniformly distributed 64-bit value.
+ */
+uint64_t recordRandom(const DatagenOptions& options, DatagenStream stream, uint64_t index) {
+    return splitMix64(splitMix64(options.seed ^ (static_cast<uint64_t>(stream) << 56)) ^ index);
+}
+
+/**
+ * @brief Builds the name of a customer.
+ *
+ * @param customer The customer index.
+ * @return A single-word customer name, unique per customer index.
+ */
+string customerName(long long customer) {
+    const long long names = size(firstNames) * size(lastNames);
+    string name = string(firstNames[customer % size(firstNames)]) + lastNames[customer / size(firstNames) % size(lastNames)];
+    if (customer >= names) {
+        name += to_string(customer / names);
+    }
+    return name;
+}
+
+/**
+ * @brief Builds the name of a model.
+ *
+ * @param model The model index.
+ * @return A single-word model name, unique per model index.
+ */
+string modelName(int model) {
+    return string(brands[model % size(brands)]) + to_string(100 + model / size(brands));
+}
+
+/**
+ * @brief Returns the customer owning a vehicle.
+ *
+ * @param options The generator options.
+ * @param vehicle The vehicle index.
+ * @return The customer index.
+ */
+long long vehicleCustomer(const DatagenOptions& options, long long vehicle) {
+    return static_cast<long long>(recordRandom(options, StreamVehicleCustomer, vehicle) % options.customers);
+}
+
+/**
+ * @brief Builds the calendar of bookable dates.
+ *
+ * The appointment matrix has a cell for every day of a month, so the calendar
+ * runs through whole months, the 31st and 29 February of leap years included.
+ *
+ * @param options The generator options.
+ * @return options.days consecutive dates starting on 1 January of the start year.
+ */
+vector<Date> buildCalendar(const DatagenOptions& options) {
+    vector<Date> calendar;
+    calendar.reserve(options.days);
+    CalendarDay day = CalendarDay::fromCivil(options.startYear, 1, 1);
+    for (int i = 0; i < options.days; ++i) {
+        calendar.push_back(civilDate(day));
+        day = day.addDays(1);
+    }
+    return calendar;
+}
+
+/**
+ * @brief Generates records in parallel and writes them in record order.
+ *
+ * Records are split into chunks of datagenChunkRecords. Each round renders one chunk
+ * per worker into its own buffer, then the buffers are written in chunk order, so the
+ * output is identical for any number of threads.
+ *
+ * @param options The generator options.
+ * @param path The file to write.
+ * @param total The number of records.
+ * @param render Renders records [begin, end) into a buffer.
+ * @param header Bytes written before the records.
+ * @return true if the file was written, false if it could not be opened.
+ */
+bool generateFile(const DatagenOptions& options, const string& path, long long total,
+                  const function<void(long long, long long, string&)>& render, string_view header = {}) {
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cerr << "Cannot open " << path << " for writing" << endl;
+        return false;
+    }
+    file.write(header.data(), header.size());
+
+    int threads = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    vector<string> buffers(threads);
+
+    for (long long roundStart = 0; roundStart < total; roundStart += threads * datagenChunkRecords) {
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            long long begin = roundStart + t * datagenChunkRecords;
+            long long end = min(total, begin + datagenChunkRecords);
+            buffers[t].clear();
+            if (begin < end) {
+                workers.emplace_back([&render, &buffers, t, begin, end]() { render(begin, end, buffers[t]); });
+            }
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const string& buffer : buffers) {
+            file.write(buffer.data(), buffer.size());
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Generates customer_vehicle.dat.
+ *
+ * @param options The generator options.
+ * @return true on success.
+ */
+bool generateVehicles(const DatagenOptions& options) {
+    return generateFile(options, options.outputDir + "/customer_vehicle.dat", options.vehicles,
+        [&options](long long begin, long long end, string& out) {
+            out.reserve((end - begin) * sizeof(VehicleRecord));
+            Vehicle vehicle;
+            for (long long i = begin; i < end; ++i) {
+                long long customer = vehicleCustomer(options, i);
+                vehicle.vehicleID = static_cast<int>(i + 1);
+                vehicle.customerID = 10000000000LL + customer;
+                vehicle.customerName = customerName(customer);
+                vehicle.model = modelName(static_cast<int>(recordRandom(options, StreamVehicleModel, i) % options.models));
+                vehicle.plateNumber = to_string(1 + i % 81) + static_cast<char>('A' + i / 81 % 26) + static_cast<char>('A' + i / 2106 % 26)
+                    + static_cast<char>('A' + i / 54756 % 26) + to_string(100 + i / 1423656 % 900);
+
+                VehicleRecord record = toVehicleRecord(vehicle);
+                out.append(reinterpret_cast<const char*>(&record), sizeof(VehicleRecord));
+            }
+        });
+}
+
+/**
+ * @brief Generates vehicle_parts.dat.
+ *
+ * @param options The generator options.
+ * @return true on success.
+ */
+bool generateParts(const DatagenOptions& options) {
+    long long total = static_cast<long long>(options.models) * options.partsPerModel;
+    return generateFile(options, options.outputDir + "/vehicle_parts.dat", total,
+        [&options](long long begin, long long end, string& out) {
+            ostringstream lines;
+            Part part;
+            for (long long i = begin; i < end; ++i) {
+                int index = static_cast<int>(i % options.partsPerModel);
+                part.name = components[index % size(components)];
+                if (index >= static_cast<int>(size(components))) {
+                    part.name += to_string(index / size(components));
+                }
+                part.compatiblemodel = modelName(static_cast<int>(i / options.partsPerModel));
+
+                // Log-uniform prices between 50 and 20000 cover every labor bracket
+                double unit = static_cast<double>(recordRandom(options, StreamPartPrice, i) >> 11) / 9007199254740992.0;
+                part.price = static_cast<float>(round(50.0 * pow(400.0, unit)));
+
+                formatPartLine(lines, part);
+            }
+            out = lines.str();
+        });
+}
+
+/**
+ * @brief Generates appointments.dat.
+ *
+ * Every day gets a Zipf rank from a seeded shuffle, and its share of the
+ * appointments is proportional to 1 / rank^skew.
+ *
+ * @param options The generator options.
+ * @return true on success.
+ */
+bool generateAppointments(const DatagenOptions& options) {
+    vector<Date> calendar = buildCalendar(options);
+
+    // Assign Zipf ranks to the days with a seeded shuffle
+    vector<int> ranks(calendar.size());
+    for (size_t i = 0; i < ranks.size(); ++i) {
+        ranks[i] = static_cast<int>(i) + 1;
+    }
+    for (size_t i = ranks.size(); i > 1; --i) {
+        swap(ranks[i - 1], ranks[recordRandom(options, StreamDayRank, i) % i]);
+    }
+
+    double weightSum = 0;
+    for (int rank : ranks) {
+        weightSum += 1.0 / pow(rank, options.skew);
+    }
+
+    // Cumulative appointment counts per day
+    double expected = static_cast<double>(options.appointmentsPerDay) * calendar.size();
+    vector<long long> dayEnd(calendar.size());
+    long long total = 0;
+    for (size_t d = 0; d < calendar.size(); ++d) {
+        total += llround(expected / pow(ranks[d], options.skew) / weightSum);
+        dayEnd[d] = total;
+    }
+
+    return generateFile(options, options.outputDir + "/appointments.dat", total,
+        [&options, &calendar, &dayEnd](long long begin, long long end, string& out) {
+            ostringstream lines;
+            Appointment appointment;
+            size_t day = upper_bound(dayEnd.begin(), dayEnd.end(), begin) - dayEnd.begin();
+            for (long long i = begin; i < end; ++i) {
+                while (i >= dayEnd[day]) {
+                    day++;
+                }
+                long long vehicle = static_cast<long long>(recordRandom(options, StreamAppointmentVehicle, i) % options.vehicles);
+                appointment.vehicleID = static_cast<int>(vehicle + 1);
+                appointment.customerName = customerName(vehicleCustomer(options, vehicle));
+
+                formatAppointmentLine(lines, calendar[day], appointment);
+            }
+            out = lines.str();
+        });
+}
+
+/**
+ * @brief Generates history.dat.
+ *
+ * @param options The generator options.
+ * @return true on success.
+ */
+bool generateHistory(const DatagenOptions& options) {
+    vector<Date> calendar = buildCalendar(options);
+    ServiceFileHeader header = serviceFileHeader();
+
+    return generateFile(options, options.outputDir + "/history.dat", options.historyRecords,
+        [&options, &calendar](long long begin, long long end, string& out) {
+            out.reserve((end - begin) * sizeof(ServiceRecord));
+            Appointment appointment;
+            for (long long i = begin; i < end; ++i) {
+                long long vehicle = static_cast<long long>(recordRandom(options, StreamHistoryVehicle, i) % options.vehicles);
+                appointment.vehicleID = static_cast<int>(vehicle + 1);
+                appointment.customerName = customerName(vehicleCustomer(options, vehicle));
+                appointment.appointmentType = operationTypes[recordRandom(options, StreamHistoryType, i) % size(operationTypes)];
+                const Date& date = calendar[recordRandom(options, StreamHistoryDay, i) % calendar.size()];
+
+                // Same record as CreateReport writes
+                ServiceRecord record = makeServiceRecord(ServiceReport, appointment, date, {});
+                out.append(reinterpret_cast<const char*>(&record), sizeof(ServiceRecord));
+            }
+        }, string_view(reinterpret_cast<const char*>(&header), sizeof(ServiceFileHeader)));
+}
+
+/**
+ * @brief Prints the command line usage.
+ */
+void printUsage() {
+    cout << "Usage: vehicleapp_datagen [options]\n"
+         << "  --out DIR                  Output folder (default .)\n"
+         << "  --seed N                   Random seed (default 1)\n"
+         << "  --vehicles N               Vehicles (default 1000)\n"
+         << "  --customers N              Customers (default 300)\n"
+         << "  --models N                 Vehicle models (default 20)\n"
+         << "  --parts-per-model N        Parts per model (default 25)\n"
+         << "  --days N                   Calendar days (default 365)\n"
+         << "  --appointments-per-day N   Mean appointments per day (default 20)\n"
+         << "  --skew S                   Zipf exponent over days, 0 = uniform (default 1.0)\n"
+         << "  --history N                History reports (default 1000)\n"
+         << "  --start-year N             First calendar year (default 2024)\n"
+         << "  --threads N                Worker threads (default: hardware threads)\n";
+}
+
+/**
+ * @brief Parses the command line into generator options.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @param options Receives the parsed options.
+ * @return true if every argument was valid and the calendar ends by 31 December 2050, the last day of the appointment matrix.
+ */
+bool parseOptions(int argc, char** argv, DatagenOptions& options) {
+    for (int i = 1; i < argc; i += 2) {
+        string name = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        string value = argv[i + 1];
+
+        try {
+            if (name == "--out") options.outputDir = value;
+            else if (name == "--seed") options.seed = stoull(value);
+            else if (name == "--vehicles") options.vehicles = stoll(value);
+            else if (name == "--customers") options.customers = stoll(value);
+            else if (name == "--models") options.models = stoi(value);
+            else if (name == "--parts-per-model") options.partsPerModel = stoi(value);
+            else if (name == "--days") options.days = stoi(value);
+            else if (name == "--appointments-per-day") options.appointmentsPerDay = stoi(value);
+            else if (name == "--skew") options.skew = stod(value);
+            else if (name == "--history") options.historyRecords = stoll(value);
+            else if (name == "--start-year") options.startYear = stoi(value);
+            else if (name == "--threads") options.threads = stoi(value);
+            else return false;
+        }
+        catch (const exception&) {
+            return false;
+        }
+    }
+
+    return options.vehicles > 0 && options.customers > 0 && options.models > 0 && options.partsPerModel > 0
+        && options.days > 0 && options.appointmentsPerDay >= 0 && options.skew >= 0 && options.historyRecords >= 0
+        && options.startYear > 0 && options.startYear <= 2050
+        && daysFromCivil(options.startYear, 1, 1) + static_cast<int64_t>(options.days) - 1 <= daysFromCivil(2050, 12, 31);
+}
+
+/**
+ * @brief Main entry point of the dataset generator.
+ *
+ * Generates customer_vehicle.dat, vehicle_parts.dat, appointments.dat and history.dat
+ * in the output folder and prints the time spent on each file.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @return 0 on success, 1 on invalid arguments or write errors.
+ */
+int main(int argc, char** argv) {
+    DatagenOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    const pair<const char*, bool (*)(const DatagenOptions&)> steps[] = {
+        { "customer_vehicle.dat", generateVehicles },
+        { "vehicle_parts.dat", generateParts },
+        { "appointments.dat", generateAppointments },
+        { "history.dat", generateHistory },
+    };
+
+    for (const auto& step : steps) {
+        auto start = chrono::steady_clock::now();
+        if (!step.second(options)) {
+            return 1;
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << step.first << ": " << fixed << setprecision(3) << elapsed.count() << " s" << endl;
+    }
+
+    return 0;
+}
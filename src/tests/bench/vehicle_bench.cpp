@@ -0,0 +1,676 @@
+/**
+ * @file vehicle_bench.cpp
+ * @brief Benchmarks for the hot paths of the vehicle library.
+ *
+ * Every benchmark is parameterized over dataset sizes from 1e2 to 1e6 records.
+ * Unless --benchmark_out is given, results are written to vehicle_bench.json.
+ */
+#include "benchmark/benchmark.h"
+#include "../../vehicleapp/header/vehicleapp.h"
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+/**
+ * @brief Files the benchmarks generate their datasets into.
+ */
+const char* benchVehicleFile = "bench_customer_vehicle.dat";
+const char* benchTempVehicleFile = "bench_temp_customer_vehicle.dat";
+const char* benchPartFile = "bench_vehicle_parts.dat";
+const char* benchAppointmentFile = "bench_appointments.dat";
+const char* benchFeedbackFile = "bench_feedback.txt";
+const char* benchArchiveFile = "bench_archive.col";
+const char* benchHistoryFile = "bench_history.dat";
+const char* benchSnapshotFile = "bench_state.snap";
+
+/**
+ * @brief Number of distinct models used by the generated datasets.
+ */
+const int benchModelCount = 50;
+
+/**
+ * @brief Builds a linked list of vehicles and publishes it as headVehicle and tailVehicle.
+ *
+ * @param count Number of vehicles to create.
+ */
+void buildVehicleList(int count) {
+    Vehicle* previous = nullptr;
+    headVehicle = nullptr;
+    for (int i = 0; i < count; ++i) {
+        Vehicle* vehicle = new Vehicle{ i, 1000 + i % 997, pmr::string("Customer" + to_string(i % 997)), "Model" + to_string(i % benchModelCount), pmr::string("PL" + to_string(i)), nullptr, previous };
+        if (previous) {
+            previous->next = vehicle;
+        }
+        else {
+            headVehicle = vehicle;
+        }
+        previous = vehicle;
+    }
+    tailVehicle = previous;
+}
+
+/**
+ * @brief Frees the vehicle list published as headVehicle.
+ */
+void freeVehicleList() {
+    Vehicle* current = headVehicle;
+    while (current != nullptr) {
+        Vehicle* next = current->next;
+        delete current;
+        current = next;
+    }
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+}
+
+/**
+ * @brief Builds a list of parts spread over benchModelCount models.
+ *
+ * @param count Number of parts to create.
+ * @return The generated parts.
+ */
+vector<Part> buildParts(int count) {
+    vector<Part> parts;
+    parts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        parts.push_back(Part{ i + 1, "Part" + to_string(i), "Model" + to_string(i % benchModelCount), static_cast<float>((i * 37) % 12000) });
+    }
+    return parts;
+}
+
+/**
+ * @brief Writes a parts file in the format read by loadPartsFromFile.
+ *
+ * @param count Number of parts to write.
+ */
+void writePartsFile(int count) {
+    ofstream file(benchPartFile, ios::trunc);
+    for (const Part& part : buildParts(count)) {
+        file << part.name << " " << part.compatiblemodel << " " << part.price << "\n";
+    }
+}
+
+/**
+ * @brief Writes an appointments file in the format read by readAppointmentsFromFile.
+ *
+ * @param count Number of appointments to write.
+ */
+void writeAppointmentsFile(int count) {
+    ofstream file(benchAppointmentFile, ios::trunc);
+    for (int i = 0; i < count; ++i) {
+        file << (i % 28 + 1) << ' ' << (i / 28 % 12 + 1) << ' ' << (2024 + i / 336 % 20) << ' ' << "Customer" << i % 997 << '\n';
+    }
+}
+
+/**
+ * @brief Fills the appointment matrix with generated appointments.
+ *
+ * @param count Number of appointments to add.
+ */
+void fillAppointments(int count) {
+    for (int i = 0; i < count; ++i) {
+        addAppointment(Date{ 2024 + i / 336 % 20, i / 28 % 12 + 1, i % 28 + 1 }, Appointment{ i, "Customer" + to_string(i % 997), "Repair" });
+    }
+}
+
+/**
+ * @brief Empties the appointment queues of the years used by the generated datasets.
+ */
+void clearAppointments() {
+    for (int year = 2024; year < 2044; ++year) {
+        for (auto& month : appointmentMatrix[year]) {
+            for (auto& day : month) {
+                day.clear();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the number of heap bytes in use, or 0 where the allocator does not report it.
+ */
+size_t heapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Benchmark for calculateTotalPrice.
+ */
+static void BM_CalculateTotalPrice(benchmark::State& state) {
+    vector<Part> parts = buildParts(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calculateTotalPrice(parts));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CalculateTotalPrice)->RangeMultiplier(10)->Range(100, 1000000);
+
+/**
+ * @brief Benchmark for initializeAppointmentMatrix, sized by the number of day cells.
+ */
+static void BM_InitializeAppointmentMatrix(benchmark::State& state) {
+    int years = max(1, static_cast<int>(state.range(0) / (13 * 32)));
+
+    for (auto _ : state) {
+        initializeAppointmentMatrix(years, 12, 31);
+        state.PauseTiming();
+        appointmentMatrix.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InitializeAppointmentMatrix)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for readAppointmentsFromFile.
+ */
+static void BM_ReadAppointmentsFromFile(benchmark::State& state) {
+    writeAppointmentsFile(static_cast<int>(state.range(0)));
+    initializeAppointmentMatrix(2050, 12, 31);
+
+    for (auto _ : state) {
+        readAppointmentsFromFile(benchAppointmentFile);
+        state.PauseTiming();
+        clearAppointments();
+        state.ResumeTiming();
+    }
+
+    appointmentMatrix.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadAppointmentsFromFile)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for readAppointmentsFromFile and loadPartsFromFile on a given number of threads.
+ */
+static void BM_ParallelLoad(benchmark::State& state) {
+    writeAppointmentsFile(static_cast<int>(state.range(0)));
+    writePartsFile(static_cast<int>(state.range(0)));
+    initializeAppointmentMatrix(2050, 12, 31);
+
+    for (auto _ : state) {
+        readAppointmentsFromFile(benchAppointmentFile, static_cast<int>(state.range(1)));
+        loadPartsFromFile(benchPartFile, static_cast<int>(state.range(1)));
+        state.PauseTiming();
+        clearAppointments();
+        state.ResumeTiming();
+    }
+
+    appointmentMatrix.clear();
+    partHash.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_ParallelLoad)->Args({ 1000000, 1 })->Args({ 1000000, 2 })->Args({ 1000000, 4 })->Args({ 1000000, 8 })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * @brief Benchmark for parsing the lines of an appointments file without storing them.
+ */
+static void BM_ParseAppointmentLines(benchmark::State& state) {
+    writeAppointmentsFile(static_cast<int>(state.range(0)));
+    string text = readWholeFile(benchAppointmentFile);
+
+    for (auto _ : state) {
+        LineScanner lines(text);
+        string_view line;
+        Date date;
+        Appointment appointment;
+        while (lines.next(line)) {
+            benchmark::DoNotOptimize(parseAppointmentLine(line, date, appointment));
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseAppointmentLines)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for writeAppointmentsToFile.
+ */
+static void BM_WriteAppointmentsToFile(benchmark::State& state) {
+    initializeAppointmentMatrix(2050, 12, 31);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        remove(benchAppointmentFile);
+        fillAppointments(static_cast<int>(state.range(0)));
+        state.ResumeTiming();
+
+        writeAppointmentsToFile(benchAppointmentFile);
+    }
+
+    appointmentMatrix.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteAppointmentsToFile)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for loadVehiclesFromFile.
+ */
+static void BM_LoadVehiclesFromFile(benchmark::State& state) {
+    buildVehicleList(static_cast<int>(state.range(0)));
+    updateVehicleFile(benchTempVehicleFile, benchVehicleFile);
+    freeVehicleList();
+
+    for (auto _ : state) {
+        loadVehiclesFromFile(benchVehicleFile);
+        state.PauseTiming();
+        state.counters["heap_bytes"] = static_cast<double>(heapBytesInUse());
+        clearVehicles();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadVehiclesFromFile)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for updateVehicleFile.
+ */
+static void BM_UpdateVehicleFile(benchmark::State& state) {
+    buildVehicleList(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        updateVehicleFile(benchTempVehicleFile, benchVehicleFile);
+    }
+
+    freeVehicleList();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateVehicleFile)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for loadPartsFromFile.
+ */
+static void BM_LoadPartsFromFile(benchmark::State& state) {
+    writePartsFile(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        loadPartsFromFile(benchPartFile);
+    }
+
+    state.counters["heap_bytes"] = static_cast<double>(heapBytesInUse());
+    partHash.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadPartsFromFile)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for restoring the vehicles and parts from a snapshot image;
+ *        compare with BM_LoadVehiclesFromFile plus BM_LoadPartsFromFile.
+ */
+static void BM_RestoreSnapshot(benchmark::State& state) {
+    buildVehicleList(static_cast<int>(state.range(0)));
+    updateVehicleFile(benchTempVehicleFile, benchVehicleFile);
+    freeVehicleList();
+    writePartsFile(static_cast<int>(state.range(0)));
+    loadVehiclesFromFile(benchVehicleFile);
+    loadPartsFromFile(benchPartFile);
+    saveStateSnapshot(benchSnapshotFile, benchVehicleFile, benchPartFile);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        clearVehicles();
+        partHash.clear();
+        state.ResumeTiming();
+        bool restored = restoreVehicleSnapshot(benchSnapshotFile, benchVehicleFile) && restorePartSnapshot(benchSnapshotFile, benchPartFile);
+        benchmark::DoNotOptimize(restored);
+    }
+
+    state.counters["image_bytes"] = static_cast<double>(filesystem::file_size(benchSnapshotFile));
+    clearVehicles();
+    partHash.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_RestoreSnapshot)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for finding the first free 2 hour slot when every day but the
+ *        last of the range is too fragmented to hold one.
+ */
+static void BM_FindFirstFreeSlot(benchmark::State& state) {
+    SlotScheduler scheduler(serviceBays, slotsPerWorkday);
+    int32_t days = static_cast<int32_t>(state.range(0));
+    for (int32_t day = 0; day < days - 1; ++day) {
+        for (int bay = 0; bay < serviceBays; ++bay) {
+            for (int slot = (day + bay) % 7; slot < slotsPerWorkday; slot += 7) {
+                scheduler.reserve({ day, bay, slot, 1 });
+            }
+        }
+    }
+    scheduler.reserve({ days - 1, 0, 0, 1 });
+
+    SlotBooking found;
+    for (auto _ : state) {
+        bool free = scheduler.findFirstFree(0, appointmentSlots("Repair"), found, days);
+        benchmark::DoNotOptimize(free);
+    }
+
+    state.counters["found_day"] = found.day;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FindFirstFreeSlot)->Arg(30)->Arg(365)->Arg(3650)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark for booking and serving one appointment on a day that already
+ *        holds the given number of appointments of mixed priority.
+ */
+static void BM_DayQueuePushPop(benchmark::State& state) {
+    PriorityQueue<Appointment> day;
+    for (int i = 0; i < state.range(0); ++i) {
+        day.push(Appointment{ i, "Customer", "Repair", i % 3 });
+    }
+
+    int next = 0;
+    for (auto _ : state) {
+        day.push(Appointment{ next, "Customer", "Repair", next % 3 });
+        benchmark::DoNotOptimize(day.front().vehicleID);
+        day.pop();
+        ++next;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DayQueuePushPop)->RangeMultiplier(16)->Range(16, 65536);
+
+/**
+ * @brief Fills the per-vehicle appointment index with appointments of 10000 vehicles spread over 20 years.
+ *
+ * @param count Number of appointments to index.
+ */
+void indexBenchAppointments(int count) {
+    initializeAppointmentMatrix(2050, 12, 31);
+    CalendarDay first = CalendarDay::fromCivil(2024, 1, 1);
+    for (int i = 0; i < count; ++i) {
+        Date date = civilDate(first.addDays((i * 7919) % 7300));
+        indexVehicleAppointment(date, Appointment{ i % 10000 + 1, "Customer", "Repair" });
+    }
+}
+
+/**
+ * @brief Benchmark for the conflict check done when an appointment is booked.
+ */
+static void BM_FindVehicleConflict(benchmark::State& state) {
+    indexBenchAppointments(static_cast<int>(state.range(0)));
+    CalendarDay first = CalendarDay::fromCivil(2024, 1, 1);
+    VehicleAppointment conflict;
+
+    int next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findVehicleConflict(next % 10000 + 1, civilDate(first.addDays(next % 7300)), conflict));
+        next += 7;
+    }
+
+    initializeAppointmentMatrix(2050, 12, 31);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindVehicleConflict)->RangeMultiplier(10)->Range(10000, 1000000);
+
+/**
+ * @brief Benchmark for the conflict report over the whole calendar on a given number of threads.
+ */
+static void BM_FindAllConflicts(benchmark::State& state) {
+    indexBenchAppointments(static_cast<int>(state.range(0)));
+
+    size_t conflicts = 0;
+    for (auto _ : state) {
+        conflicts = findAllConflicts(static_cast<int>(state.range(1))).size();
+    }
+
+    initializeAppointmentMatrix(2050, 12, 31);
+    state.counters["conflicts"] = static_cast<double>(conflicts);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FindAllConflicts)->Args({ 1000000, 1 })->Args({ 1000000, 4 })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * @brief Benchmark for viewing one month of 10 year monthly maintenance contracts for a given number of vehicles.
+ */
+static void BM_RecurringMonthView(benchmark::State& state) {
+    for (int vehicle = 1; vehicle <= state.range(0); ++vehicle) {
+        Recurrence monthly;
+        monthly.start = CalendarDay::fromCivil(2025, vehicle % 12 + 1, vehicle % 28 + 1);
+        monthly.until = monthly.start.addYears(10);
+        addRecurringAppointment({ Appointment{ vehicle, "Fleet", "Maintenance" }, monthly });
+    }
+
+    int month = 0;
+    for (auto _ : state) {
+        Date from{ 2025 + month / 12 % 10, month % 12 + 1, 1 };
+        benchmark::DoNotOptimize(recurringAppointmentsBetween(from, Date{ from.year, from.month, daysInMonth(from.year, from.month) }));
+        month++;
+    }
+
+    recurringAppointments.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RecurringMonthView)->Arg(500)->Arg(5000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark for adding one more of a quoted part to a quote of the given number of parts and removing it again.
+ */
+static void BM_QuoteAddRemove(benchmark::State& state) {
+    vector<Part> parts = buildParts(static_cast<int>(state.range(0)));
+    Quote quote;
+    for (const Part& part : parts) {
+        addQuotePart(quote, part);
+    }
+    const Part& part = parts[parts.size() / 2];
+
+    for (auto _ : state) {
+        addQuotePart(quote, part);
+        removeQuotePart(quote, part.partID);
+        benchmark::DoNotOptimize(quoteTotals(quote));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QuoteAddRemove)->RangeMultiplier(10)->Range(10, 10000);
+
+/**
+ * @brief Benchmark for pricing the same ten part job again, served from the quote cache.
+ */
+static void BM_PriceJobCached(benchmark::State& state) {
+    writePartsFile(100000);
+    loadPartsFromFile(benchPartFile);
+    vector<Part> modelParts = findPartsByModel("Model0");
+    vector<int> job;
+    for (size_t i = 0; i < modelParts.size() && job.size() < 10; ++i) {
+        job.push_back(modelParts[i].partID);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(priceJob("Model0", job));
+    }
+
+    partHash.clear();
+    quoteCache.clear();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PriceJobCached);
+
+/**
+ * @brief Benchmark for the part search by model.
+ */
+static void BM_FindPartsByModel(benchmark::State& state) {
+    writePartsFile(static_cast<int>(state.range(0)));
+    loadPartsFromFile(benchPartFile);
+
+    int model = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findPartsByModel("Model" + to_string(model)));
+        model = (model + 1) % benchModelCount;
+    }
+
+    partHash.clear();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FindPartsByModel)->RangeMultiplier(10)->Range(100, 1000000);
+
+/**
+ * @brief Benchmark for one keystroke of the quick search, alternating prefix and misspelled queries.
+ */
+static void BM_SearchIndexKeystroke(benchmark::State& state) {
+    buildVehicleList(static_cast<int>(state.range(0)));
+    updateVehicleFile(benchTempVehicleFile, benchVehicleFile);
+    freeVehicleList();
+    loadVehiclesFromFile(benchVehicleFile);
+    SearchIndex index = buildSearchIndex();
+
+    const vector<string> queries = { "p", "pl1", "pl12", "cust", "customer9", "custmoer99", "modle4", "lp1234" };
+    size_t query = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.search(queries[query], 12));
+        query = (query + 1) % queries.size();
+    }
+
+    clearVehicles();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SearchIndexKeystroke)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark for a word search over the indexed feedback file.
+ */
+static void BM_SearchTextRecords(benchmark::State& state) {
+    const vector<string> words = { "brakes", "engine", "oil", "tyres", "battery", "clutch", "paint", "noise" };
+    {
+        ofstream out(benchFeedbackFile, ios::trunc | ios::binary);
+        for (long long i = 0; i < state.range(0); ++i) {
+            out << "Customer Feedback: vehicle " << i << " " << words[i % words.size()] << " " << words[(i / 7) % words.size()] << " checked\n\n";
+        }
+    }
+    remove((string(benchFeedbackFile) + ".idx.log").c_str());
+    compactTextIndex(benchFeedbackFile);
+
+    size_t word = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searchTextRecords(benchFeedbackFile, words[word] + " " + words[(word + 3) % words.size()], 10));
+        word = (word + 1) % words.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SearchTextRecords)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for the monthly statistics of one year over an archive spanning ten years.
+ */
+static void BM_MonthlyServiceStats(benchmark::State& state) {
+    vector<ArchiveRow> rows;
+    int32_t firstDay = daysFromCivil(2015, 1, 1);
+    for (long long i = 0; i < state.range(0); ++i) {
+        rows.push_back({ firstDay + static_cast<int32_t>(i * 3650 / state.range(0)), static_cast<int32_t>(i % 997), static_cast<uint8_t>(i % 2 ? ArchiveReport : ArchiveAppointment),
+            static_cast<float>(i % 500), "Repair", "Model" + to_string(i % benchModelCount), "Customer" + to_string(i % 997) });
+    }
+    writeColumnArchive(benchArchiveFile, rows);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(monthlyServiceStats(benchArchiveFile, 2020));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MonthlyServiceStats)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for reading a service history of twelve months, eleven of them in compressed segments.
+ */
+static void BM_ReadServiceSegments(benchmark::State& state) {
+    const vector<string> types = { "Repair", "Maintenance", "Paint", "Inspection" };
+    clearServiceFile(benchHistoryFile);
+    for (int month = 1; month <= 12; ++month) {
+        // Write a month directly under a header dated to it, then let the next record rotate it
+        if (textFileSize(benchHistoryFile) == 0) {
+            ServiceFileHeader header = serviceFileHeader(2023 * 12 + month - 1);
+            ofstream(benchHistoryFile, ios::binary).write(reinterpret_cast<const char*>(&header), sizeof(ServiceFileHeader));
+        }
+        else {
+            int32_t openedMonth = 2023 * 12 + month - 1;
+            fstream header(benchHistoryFile, ios::in | ios::out | ios::binary);
+            header.seekp(offsetof(ServiceFileHeader, openedMonth));
+            header.write(reinterpret_cast<const char*>(&openedMonth), sizeof(openedMonth));
+        }
+        ofstream out(benchHistoryFile, ios::app | ios::binary);
+        long long first = (month - 1) * state.range(0) / 12;
+        long long last = month * state.range(0) / 12;
+        for (long long i = first; i < last; ++i) {
+            ServiceRecord record = makeServiceRecord(ServiceReport, Appointment{ static_cast<int>(i % 100000), "Customer " + to_string(i % 997), types[i % types.size()] },
+                Date{ 2023, month, static_cast<int>(1 + i % 28) }, { Part{ static_cast<int>(i % 500), "Part", "Model", 100.0f } });
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        out.close();
+        if (month == 12) {
+            break;
+        }
+        appendServiceRecord(benchHistoryFile, makeServiceRecord(ServiceReport, Appointment{ 0, "Customer 0", "Repair" }, Date{ 2023, month + 1, 1 }, {}));
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(readServiceRecords(benchHistoryFile));
+    }
+
+    state.counters["compression"] = static_cast<double>(readServiceRecords(benchHistoryFile).size() * sizeof(ServiceRecord)) / serviceFileDiskSize(benchHistoryFile);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadServiceSegments)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark for CountVehicles.
+ */
+static void BM_CountVehicles(benchmark::State& state) {
+    buildVehicleList(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CountVehicles());
+    }
+
+    freeVehicleList();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CountVehicles)->RangeMultiplier(10)->Range(100, 1000000);
+
+/**
+ * @brief The main function of the benchmark program.
+ *
+ * Adds JSON output to vehicle_bench.json unless an output file was requested.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @return int The exit status of the program.
+ */
+int main(int argc, char** argv) {
+    vector<char*> args(argv, argv + argc);
+
+    bool hasOutput = false;
+    for (char* arg : args) {
+        if (string(arg).rfind("--benchmark_out=", 0) == 0) {
+            hasOutput = true;
+        }
+    }
+
+    char defaultOutput[] = "--benchmark_out=vehicle_bench.json";
+    char defaultFormat[] = "--benchmark_out_format=json";
+    if (!hasOutput) {
+        args.push_back(defaultOutput);
+        args.push_back(defaultFormat);
+    }
+
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -14,7 +14,7 @@ protected:
      * @brief Set up function called before each test case.
      */
     void SetUp() override {
-        initializeAppointmentMatrix(2050, 13, 30);
+        initializeAppointmentMatrix(2050, 12, 31);
     }
 
     /**
@@ -95,7 +95,7 @@ TEST_F(VehicleTests, TestListAppointments) {
     std::cout.rdbuf(oldCout);
 
     // Test expectations
-    EXPECT_EQ(outputStream.str(), "Appointments 15.12.2023:\n1. John Doe\n");
+    EXPECT_EQ(outputStream.str(), "Appointments 14.11.2023:\n1. John Doe\n");
 
 }
 
@@ -104,7 +104,7 @@ TEST_F(VehicleTests, TestListAppointments) {
  */
 TEST_F(VehicleTests, TestReadAndWriteAppointments) {
     // Test data
-    initializeAppointmentMatrix(2050, 13, 30);
+    initializeAppointmentMatrix(2050, 12, 31);
     Appointment testAppointment;
     Date testDate;
     testAppointment.vehicleID = 1;
@@ -172,14 +172,11 @@ TEST_F(VehicleTests, TestCreateReport) {
     std::string filePath = "test_report.txt";
     CreateReport(filePath, appointment, date);
 
-    // Open the file and read its content
-    std::ifstream file(filePath);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+    // Render the records stored in the file
+    std::string content = renderServiceFile(filePath);
 
     // Test expectations
-    EXPECT_EQ(buffer.str(), " | The following operation: Repair, performed to the customer : \n | John Doe with vehicle ID 1, on this date: 14/11/2023\n\n");
+    EXPECT_EQ(content, " | The following operation: Repair, performed to the customer : \n | John Doe with vehicle ID 1, on this date: 14/11/2023\n\n");
 
     // Clear the file
     ofstream clearFile("test_report.txt", std::ios::trunc);
@@ -198,14 +195,11 @@ TEST_F(VehicleTests, TestCreateWarranty) {
     std::string filePath = "test_warranty.txt";
     CreateWarranty(filePath, appointment, date);
 
-    // Open the file and read its content
-    std::ifstream file(filePath);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+    // Render the records stored in the file
+    std::string content = renderServiceFile(filePath);
 
     // Test expectations
-    EXPECT_EQ(buffer.str(), " | Repair, performed to the customer : \n | John Doe with vehicle ID 1, on this date: 14/11/2023\n | Warranty for repair valid until: 14/12/2023\n\n");
+    EXPECT_EQ(content, " | Repair, performed to the customer : \n | John Doe with vehicle ID 1, on this date: 14/11/2023\n | Warranty for repair valid until: 14/12/2023\n\n");
 
     // Clear the file
     ofstream clearFile("test_warranty.txt", std::ios::trunc);
@@ -224,14 +218,11 @@ TEST_F(VehicleTests, TestCreateWarranty2) {
     std::string filePath = "test_warranty.txt";
     CreateWarranty(filePath, appointment, date);
 
-    // Open the file and read its content
-    std::ifstream file(filePath);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+    // Render the records stored in the file
+    std::string content = renderServiceFile(filePath);
 
     // Test expectations
-    EXPECT_EQ(buffer.str(), " | Repair, performed to the customer : \n | John Doe with vehicle ID 1, on this date: 14/12/2023\n | Warranty for repair valid until: 14/1/2024\n\n");
+    EXPECT_EQ(content, " | Repair, performed to the customer : \n | John Doe with vehicle ID 1, on this date: 14/12/2023\n | Warranty for repair valid until: 14/1/2024\n\n");
 
     // Clear the file
     ofstream clearFile("test_warranty.txt", std::ios::trunc);
@@ -250,14 +241,11 @@ TEST_F(VehicleTests, TestCreateMaintenance) {
     std::string filePath = "test_maintenance.txt";
     CreateMaintenance(filePath, appointment, date);
 
-    // Open the file and read its content
-    std::ifstream file(filePath);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+    // Render the records stored in the file
+    std::string content = renderServiceFile(filePath);
 
     // Test expectations
-    EXPECT_EQ(buffer.str(), " | Maintenance appointment performed for the customer  \n | John Doe with vehicle ID 1, on this date: 14/11/2023\n | Next maintenance date is : 14/11/2024\n\n");
+    EXPECT_EQ(content, " | Maintenance appointment performed for the customer  \n | John Doe with vehicle ID 1, on this date: 14/11/2023\n | Next maintenance date is : 14/11/2024\n\n");
 
     // Clear the file
     ofstream clearFile("test_maintenance.txt", std::ios::trunc);
@@ -289,6 +277,298 @@ TEST_F(VehicleTests, TestCreateFeedback) {
     clearFile.close();
 }
 
+/**
+ * @brief Test case for the word index over feedback and report files.
+ */
+TEST_F(VehicleTests, TestSearchTextRecords) {
+    // Test data
+    std::string filePath = "test_search_feedback.txt";
+    ofstream(filePath, std::ios::trunc).close();
+    std::filesystem::remove(filePath + ".idx");
+    std::filesystem::remove(filePath + ".idx.log");
+
+    CreateFeedback(filePath, "Customer Feedback: the brakes squeak");
+    CreateFeedback(filePath, "Service feedback : quick oil change");
+    CreateFeedback(filePath, "Customer Feedback: brake pads replaced, oil leak fixed");
+
+    // Test functions
+    vector<string> records = searchTextRecords(filePath, "brake", 10);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0], "Customer Feedback: brake pads replaced, oil leak fixed\n");
+    EXPECT_EQ(records[1], "Customer Feedback: the brakes squeak\n");
+    EXPECT_EQ(searchTextRecords(filePath, "OIL brake", 10).size(), 1);
+    EXPECT_EQ(searchTextRecords(filePath, "brake", 1).size(), 1);
+    EXPECT_TRUE(searchTextRecords(filePath, "tyre", 10).empty());
+
+    // Compacted entries and newly logged ones are searched together
+    compactTextIndex(filePath);
+    EXPECT_FALSE(std::filesystem::exists(filePath + ".idx.log"));
+    CreateFeedback(filePath, "Service feedback : brake fluid topped up");
+    EXPECT_EQ(searchTextRecords(filePath, "brake", 10).size(), 3);
+
+    // Records written around the index are picked up by the next search
+    ofstream(filePath, std::ios::app) << "Reports written by hand mention brakes too\n\n";
+    EXPECT_EQ(searchTextRecords(filePath, "brakes", 10).size(), 2);
+
+    // A rewritten file is indexed again from scratch
+    ofstream(filePath, std::ios::trunc) << "fresh brake report\n\n";
+    records = searchTextRecords(filePath, "brake", 10);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0], "fresh brake report\n");
+
+    // Reports are indexed as well
+    std::string historyPath = "test_search_history.txt";
+    clearServiceFile(historyPath);
+    CreateReport(historyPath, Appointment{ 42, "Jane Doe", "Brake" }, Date{ 2024, 4, 3 });
+    CreateReport(historyPath, Appointment{ 43, "John Roe", "Brake" }, Date{ 2024, 4, 5 });
+    vector<ServiceRecord> reports = searchServiceRecords(historyPath, "jane brake", 10);
+    ASSERT_EQ(reports.size(), 1);
+    EXPECT_EQ(reports[0].vehicleID, 42);
+    EXPECT_EQ(searchServiceRecords(historyPath, "brake", 10).size(), 2);
+}
+
+/**
+ * @brief Test case for the typed service records behind reports, warranties and maintenance.
+ */
+TEST_F(VehicleTests, TestServiceRecords) {
+    // Test data
+    std::string filePath = "test_service_records.dat";
+    clearServiceFile(filePath);
+
+    vector<Part> parts = { Part{ 7, "Brake Pad", "Corolla", 400.0f }, Part{ 9, "Disc", "Corolla", 600.0f } };
+    CreateReport(filePath, Appointment{ 5, "John Doe", "Repair" }, Date{ 2023, 12, 14 }, parts);
+    CreateWarranty(filePath, Appointment{ 5, "John Doe", "Repair" }, Date{ 2023, 12, 14 });
+    CreateMaintenance(filePath, Appointment{ 6, "Jane Doe", "Maintenance" }, Date{ 2024, 2, 29 });
+
+    // Test functions
+    vector<ServiceRecord> records = readServiceRecords(filePath);
+    ASSERT_EQ(records.size(), 3);
+
+    // Records of any date stay in the live file of the month they were written in
+    EXPECT_EQ(serviceSegments(filePath).size(), 0);
+    EXPECT_EQ(textFileSize(filePath), sizeof(ServiceFileHeader) + 3 * sizeof(ServiceRecord));
+
+    // Fields are stored as written
+    EXPECT_EQ(records[0].kind, ServiceReport);
+    EXPECT_EQ(records[0].vehicleID, 5);
+    EXPECT_EQ(records[0].partCount, 2);
+    EXPECT_EQ(records[0].partIDs[1], 9);
+    EXPECT_FLOAT_EQ(records[0].partsAmount, 1000.0f);
+    EXPECT_FLOAT_EQ(records[0].laborAmount, 1000.0f);
+    EXPECT_EQ(serviceAppointment(records[0]).customerName, "John Doe");
+
+    // Due dates are derived from the service date
+    Date due = serviceDueDate(records[1]);
+    EXPECT_EQ(due.year, 2024);
+    EXPECT_EQ(due.month, 1);
+    due = serviceDueDate(records[2]);
+    EXPECT_EQ(due.year, 2025);
+
+    // Parts and amounts are rendered after the report lines
+    EXPECT_EQ(serviceRecordText(records[0]), " | The following operation: Repair, performed to the customer : \n | John Doe with vehicle ID 5, on this date: 14/12/2023\n"
+        " | Parts used: 2, parts amount: 1000, labor fee: 1000\n");
+
+    // A torn record at the end of the file is dropped by the next append
+    ofstream(filePath, std::ios::app | std::ios::binary) << "torn";
+    CreateReport(filePath, Appointment{ 7, "Ann Poe", "Paint" }, Date{ 2024, 3, 1 });
+    records = readServiceRecords(filePath);
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[3].vehicleID, 7);
+    EXPECT_EQ(searchServiceRecords(filePath, "paint", 10).size(), 1);
+
+    // Once the month the live file was started in has passed, the next record rotates it, whatever its date
+    int32_t openedMonth = 2023 * 12 + 11;
+    std::fstream header(filePath, std::ios::in | std::ios::out | std::ios::binary);
+    header.seekp(offsetof(ServiceFileHeader, openedMonth));
+    header.write(reinterpret_cast<const char*>(&openedMonth), sizeof(openedMonth));
+    header.close();
+    CreateWarranty(filePath, Appointment{ 8, "Eve Roe", "Repair" }, Date{ 2023, 1, 5 });
+    vector<string> segments = serviceSegments(filePath);
+    ASSERT_EQ(segments.size(), 1);
+    EXPECT_NE(segments[0].find(".2023-12.seg"), string::npos);
+    EXPECT_EQ(textFileSize(filePath), sizeof(ServiceFileHeader) + sizeof(ServiceRecord));
+    records = readServiceRecords(filePath);
+    ASSERT_EQ(records.size(), 5);
+    EXPECT_EQ(records[4].vehicleID, 8);
+    EXPECT_EQ(searchServiceRecords(filePath, "paint", 10).size(), 1);
+    clearServiceFile(filePath);
+}
+
+/**
+ * @brief Test case for a service file written in the old text format.
+ */
+TEST_F(VehicleTests, TestLegacyServiceFile) {
+    // Test data
+    std::string filePath = "test_legacy_service.dat";
+    std::string legacyText = " | The following operation: Repair, performed to the customer : \n | John Doe with vehicle ID 5, on this date: 14/12/2023\n\n";
+    clearServiceFile(filePath);
+    std::filesystem::remove(filePath + serviceLegacySuffix);
+    std::filesystem::remove(filePath + ".legacy.2.txt");
+    ofstream(filePath, std::ios::binary | std::ios::trunc) << legacyText;
+
+    // Test functions: the text file is moved aside whole before the first record is written
+    CreateReport(filePath, Appointment{ 7, "Ann Poe", "Paint" }, Date{ 2024, 3, 1 });
+
+    // Test expectations
+    EXPECT_EQ(readWholeFile(filePath + serviceLegacySuffix), legacyText);
+    EXPECT_EQ(textFileSize(filePath), sizeof(ServiceFileHeader) + sizeof(ServiceRecord));
+    vector<ServiceRecord> records = readServiceRecords(filePath);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].vehicleID, 7);
+    EXPECT_EQ(searchServiceRecords(filePath, "doe", 10).size(), 0);
+    EXPECT_EQ(searchServiceRecords(filePath, "poe", 10).size(), 1);
+
+    // Reading moves a text file aside too, next to the earlier one
+    ofstream(filePath, std::ios::binary | std::ios::trunc) << legacyText;
+    EXPECT_EQ(readServiceRecords(filePath).size(), 0);
+    EXPECT_EQ(readWholeFile(filePath + ".legacy.2.txt"), legacyText);
+    EXPECT_EQ(renderServiceFile(filePath), "");
+
+    clearServiceFile(filePath);
+    std::filesystem::remove(filePath + serviceLegacySuffix);
+    std::filesystem::remove(filePath + ".legacy.2.txt");
+}
+
+/**
+ * @brief Test case for the columnar archive and the statistics read from it.
+ */
+TEST_F(VehicleTests, TestServiceArchive) {
+    // Test data
+    clearVehicles();
+    int vehicle = registerVehicle(Vehicle{ 0, 8001, "John", "Corolla", "34ARC1", nullptr, nullptr });
+    {
+        ofstream appointments("test_archive_appointments.dat", std::ios::trunc);
+        formatAppointmentLine(appointments, Date{ 2023, 1, 10 }, Appointment{ vehicle, "John", "Repair" });
+        formatAppointmentLine(appointments, Date{ 2023, 1, 20 }, Appointment{ vehicle, "John", "Repair" });
+        formatAppointmentLine(appointments, Date{ 2023, 3, 5 }, Appointment{ 99, "Jane", "Paint" });
+        formatAppointmentLine(appointments, Date{ 2022, 12, 31 }, Appointment{ 0, "Old", "" });
+    }
+    std::string historyPath = "test_archive_history.dat";
+    clearServiceFile(historyPath);
+    CreateReport(historyPath, Appointment{ vehicle, "John", "Repair" }, Date{ 2023, 1, 20 }, { Part{ 1, "Disc", "Corolla", 600.0f } });
+    CreateReport(historyPath, Appointment{ 99, "Jane", "Paint" }, Date{ 2023, 3, 5 }, { Part{ 2, "Paint", "Civic", 100.0f } });
+
+    // Test functions
+    EXPECT_EQ(exportServiceArchive("test_archive.col", "test_archive_appointments.dat", historyPath), 6);
+    EXPECT_TRUE(archiveIsCurrent("test_archive.col", { historyPath }));
+
+    vector<MonthlyServiceStats> stats = monthlyServiceStats("test_archive.col", 2023);
+    ASSERT_EQ(stats.size(), 12);
+    EXPECT_EQ(stats[0].appointments, 2);
+    EXPECT_EQ(stats[0].services, 1);
+    EXPECT_DOUBLE_EQ(stats[0].revenue, 1600.0);
+    EXPECT_EQ(stats[2].appointments, 1);
+    EXPECT_EQ(stats[11].appointments, 0);
+    EXPECT_EQ(monthlyServiceStats("test_archive.col", 2022)[11].appointments, 1);
+
+    vector<pair<string, double>> revenue = revenueByModel("test_archive.col", 2023);
+    ASSERT_EQ(revenue.size(), 2);
+    EXPECT_EQ(revenue[0].first, "Corolla");
+    EXPECT_EQ(revenue[1].first, "");
+
+    vector<pair<string, size_t>> types = serviceTypeCounts("test_archive.col", 2023);
+    ASSERT_EQ(types.size(), 2);
+    EXPECT_EQ(types[0].first, "Repair");
+    EXPECT_EQ(types[0].second, 3);
+
+    // Scans skip blocks outside the day range and decode only the requested columns
+    vector<ArchiveRow> rows;
+    for (size_t i = 0; i < 3 * archiveBlockRows; ++i) {
+        rows.push_back({ daysFromCivil(2020 + static_cast<int>(i / archiveBlockRows), 6, 1), static_cast<int32_t>(i), ArchiveAppointment, 0.0f, "Repair", "", "C" });
+    }
+    ASSERT_TRUE(writeColumnArchive("test_archive_blocks.col", rows));
+    ColumnArchiveReader archive;
+    ASSERT_TRUE(archive.open("test_archive_blocks.col"));
+    EXPECT_EQ(archive.rowCount(), 3 * archiveBlockRows);
+    EXPECT_EQ(archive.blockCount(), 3);
+    size_t scanned = 0;
+    size_t visited = archive.scan(ColumnVehicle, daysFromCivil(2021, 1, 1), daysFromCivil(2021, 12, 31), [&](const ArchiveBlock& block) {
+        EXPECT_TRUE(block.day.empty());
+        EXPECT_EQ(block.vehicleID.front(), static_cast<int32_t>(archiveBlockRows));
+        scanned += block.vehicleID.size();
+    });
+    EXPECT_EQ(visited, 1);
+    EXPECT_EQ(scanned, archiveBlockRows);
+
+    clearVehicles();
+}
+
+/**
+ * @brief Test case for rotating service files into compressed monthly segments.
+ */
+TEST_F(VehicleTests, TestServiceSegments) {
+    // The codec restores repetitive and incompressible data alike
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+        text += "Brake pad replaced for vehicle " + std::to_string(i % 37) + "\n";
+    }
+    std::string noise;
+    uint32_t state = 12345;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 1103515245u + 12345u;
+        noise.push_back(static_cast<char>(state >> 24));
+    }
+    for (const std::string& input : { text, noise, std::string(), std::string(70000, 'x') }) {
+        std::string compressed;
+        std::string restored;
+        lzCompress(input, compressed);
+        ASSERT_TRUE(lzDecompress(compressed, restored));
+        EXPECT_EQ(restored, input);
+    }
+
+    // Test data: three months of reports
+    std::string filePath = "test_service_segments.dat";
+    clearServiceFile(filePath);
+    vector<ServiceRecord> written;
+    for (int month = 1; month <= 3; ++month) {
+        for (int day = 1; day <= 28; ++day) {
+            for (int i = 0; i < 20; ++i) {
+                int vehicle = month * 1000 + day * 20 + i;
+                std::string customer = "Customer " + std::to_string(day * 20 + i);
+                written.push_back(makeServiceRecord(ServiceReport, Appointment{ vehicle, customer, i % 3 ? "Repair" : "Maintenance" },
+                    Date{ 2024, month, day }, { Part{ i, "Part", "Corolla", 100.0f + i } }));
+                appendServiceRecord(filePath, written.back());
+            }
+        }
+
+        // Date the live file back to the month, so the next month's first record rotates it
+        int32_t openedMonth = 2024 * 12 + month - 1;
+        std::fstream header(filePath, std::ios::in | std::ios::out | std::ios::binary);
+        header.seekp(offsetof(ServiceFileHeader, openedMonth));
+        header.write(reinterpret_cast<const char*>(&openedMonth), sizeof(openedMonth));
+    }
+
+    // Test functions: closed months are compressed, the current month stays live
+    vector<string> segments = serviceSegments(filePath);
+    ASSERT_EQ(segments.size(), 2);
+    EXPECT_NE(segments[0].find(".2024-01.seg"), string::npos);
+    EXPECT_NE(segments[1].find(".2024-02.seg"), string::npos);
+    EXPECT_EQ(textFileSize(filePath), sizeof(ServiceFileHeader) + 28 * 20 * sizeof(ServiceRecord));
+    EXPECT_LT(serviceFileDiskSize(filePath) - textFileSize(filePath), 2 * 28 * 20 * sizeof(ServiceRecord) / 10);
+
+    // Reads and renders cover the segments and the live file in order
+    vector<ServiceRecord> records = readServiceRecords(filePath);
+    ASSERT_EQ(records.size(), written.size());
+    EXPECT_EQ(memcmp(records.data(), written.data(), written.size() * sizeof(ServiceRecord)), 0);
+    EXPECT_NE(renderServiceFile(filePath).find(" | Customer 61 with vehicle ID 1061, on this date: 3/1/2024\n"), string::npos);
+
+    // Searches reach into the segments, newest first, with or without their index
+    vector<ServiceRecord> found = searchServiceRecords(filePath, "customer 61", 10);
+    ASSERT_EQ(found.size(), 3);
+    EXPECT_EQ(found[0].vehicleID, 3061);
+    EXPECT_EQ(found[1].vehicleID, 2061);
+    EXPECT_EQ(found[2].vehicleID, 1061);
+    std::filesystem::remove(segments[0] + ".idx");
+    found = searchServiceRecords(filePath, "customer 61", 1);
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_EQ(found[0].vehicleID, 3061);
+    EXPECT_EQ(searchServiceRecords(filePath, "customer 61", 10).size(), 3);
+    EXPECT_TRUE(std::filesystem::exists(segments[0] + ".idx"));
+
+    clearServiceFile(filePath);
+    EXPECT_TRUE(serviceSegments(filePath).empty());
+}
+
 /**
  * @brief Test case for displaying the content of a file.
  */
@@ -305,6 +585,108 @@ TEST_F(VehicleTests, TestDisplayFileContent) {
     // Test expectations
     EXPECT_EQ(content, "Line 1\nLine 2\nLine 3\n");
 }
+/**
+ * @brief Test case for the line and column reported for malformed appointment and part lines.
+ */
+TEST_F(VehicleTests, TestParseErrors) {
+    // Test data
+    Date date;
+    Appointment appointment;
+    ParseError error;
+
+    // Test functions: optional fields, blanks and carriage returns
+    ASSERT_TRUE(parseAppointmentLine("  3 4 2024\tJane 12 Repair\r", date, appointment, &error));
+    EXPECT_EQ(date.day, 3);
+    EXPECT_EQ(date.year, 2024);
+    EXPECT_EQ(appointment.customerName, "Jane");
+    EXPECT_EQ(appointment.vehicleID, 12);
+    EXPECT_EQ(appointment.appointmentType, "Repair");
+    ASSERT_TRUE(parseAppointmentLine("3 4 2024 Jane", date, appointment, &error));
+    EXPECT_EQ(appointment.vehicleID, 0);
+    EXPECT_EQ(appointment.appointmentType, "");
+
+    // The offending field is located
+    EXPECT_FALSE(parseAppointmentLine("3 4x 2024 Jane", date, appointment, &error));
+    EXPECT_EQ(error.column, 3);
+    EXPECT_STREQ(error.expected, "month");
+    EXPECT_FALSE(parseAppointmentLine("3 4 2024   ", date, appointment, &error));
+    EXPECT_EQ(error.column, 12);
+    EXPECT_STREQ(error.expected, "customer name");
+
+    {
+        ofstream appointments("test_parse_appointments.dat", std::ios::trunc);
+        appointments << "1 2 2024 John\n5 6 20x4 Jane\n";
+        ofstream parts("test_parse_parts.dat", std::ios::trunc);
+        parts << "Disc Corolla 600\n\nPad Corolla cheap\nFilter Civic 25.5\n";
+    }
+    stringstream buffer;
+    streambuf* oldcerr = cerr.rdbuf(buffer.rdbuf());
+    readAppointmentsFromFile("test_parse_appointments.dat");
+    loadPartsFromFile("test_parse_parts.dat");
+    cerr.rdbuf(oldcerr);
+
+    // Test expectations
+    EXPECT_NE(buffer.str().find("Incorrect file format: test_parse_appointments.dat:2:5: expected year: 5 6 20x4 Jane\n"), string::npos);
+    EXPECT_NE(buffer.str().find("Incorrect part format: test_parse_parts.dat:3:13: expected price: Pad Corolla cheap\n"), string::npos);
+    EXPECT_EQ(appointmentMatrix[2024][2][1].front().customerName, "John");
+    EXPECT_EQ(CountParts(), 2);
+    EXPECT_FLOAT_EQ(partHash["2"].price, 25.5f);
+    EXPECT_EQ(partHash["2"].compatiblemodel, ModelName("Civic"));
+}
+
+/**
+ * @brief Test case for loading files split into pieces parsed on several threads.
+ */
+TEST_F(VehicleTests, TestParallelLoad) {
+    // Pieces end at line boundaries and cover the whole text
+    std::string text = "a\nbb\nccc\ndddd\n";
+    vector<string_view> pieces = splitAtLines(text, 3);
+    ASSERT_EQ(pieces.size(), 3);
+    EXPECT_EQ(pieces[0], "a\nbb\n");
+    EXPECT_EQ(std::string(pieces[0]) + std::string(pieces[1]) + std::string(pieces[2]), text);
+    EXPECT_EQ(splitAtLines("one line", 4).size(), 1);
+    EXPECT_EQ(parallelChunkCount(10, 8), 1);
+
+    // Test data: enough lines for several pieces, with one malformed line near the end
+    const int count = 20000;
+    {
+        ofstream appointments("test_parallel_appointments.dat", std::ios::trunc);
+        ofstream parts("test_parallel_parts.dat", std::ios::trunc);
+        for (int i = 0; i < count; ++i) {
+            appointments << (i % 3 + 1) << ' ' << (i % 2 + 1) << " 2030 Customer" << i << ' ' << i + 1 << " Repair\n";
+            parts << "Part" << i << " Model" << i / 100 << ' ' << i << "\n";
+        }
+        appointments << "broken line\n";
+    }
+    ASSERT_GT(parallelChunkCount(textFileSize("test_parallel_appointments.dat"), 4), 1);
+
+    // Test functions
+    stringstream buffer;
+    streambuf* oldcerr = cerr.rdbuf(buffer.rdbuf());
+    readAppointmentsFromFile("test_parallel_appointments.dat", 4);
+    loadPartsFromFile("test_parallel_parts.dat", 4);
+    cerr.rdbuf(oldcerr);
+
+    // Test expectations: each day keeps the file order, parts are numbered in file order
+    EXPECT_NE(buffer.str().find("test_parallel_appointments.dat:20001:1: expected day"), string::npos);
+    size_t total = 0;
+    for (int month = 1; month <= 2; ++month) {
+        for (int day = 1; day <= 3; ++day) {
+            int previous = -1;
+            PriorityQueue<Appointment>& booked = appointmentMatrix[2030][month][day];
+            total += booked.size();
+            while (!booked.empty()) {
+                EXPECT_GT(booked.front().vehicleID, previous);
+                previous = booked.front().vehicleID;
+                booked.pop();
+            }
+        }
+    }
+    EXPECT_EQ(total, count);
+    EXPECT_EQ(CountParts(), count);
+    EXPECT_EQ(partHash["12346"].name, "Part12345");
+    EXPECT_EQ(partHash["12346"].compatiblemodel, ModelName("Model123"));
+}
 
 /**
  * @brief Test case for writing and loading parts from a file.
@@ -337,6 +719,7 @@ TEST_F(VehicleTests, TestUpdateVehicleFile) {
 
     // Add vehicles to the linked list
     headVehicle = vehicle1;
+    tailVehicle = vehicle2;
     vehicle1->next = vehicle2;
     vehicle2->prev = vehicle1;
 
@@ -399,6 +782,7 @@ TEST_F(VehicleTests, TestCountVehicles) {
 
     // Set up linked list
     headVehicle = vehicle1;
+    tailVehicle = vehicle2;
     vehicle1->next = vehicle2;
     vehicle2->prev = vehicle1;
 
@@ -413,6 +797,1124 @@ TEST_F(VehicleTests, TestCountVehicles) {
     delete vehicle2;
 }
 
+/**
+ * @brief Test case for registering, finding, updating and removing vehicles.
+ */
+TEST_F(VehicleTests, TestRegisterFindRemoveVehicle) {
+    // Test data
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+    Vehicle* vehicle1 = new Vehicle{ 0, 1001, "John Doe", "ModelX", "ABC123", nullptr, nullptr };
+    Vehicle* vehicle2 = new Vehicle{ 0, 1002, "Jane Doe", "ModelY", "XYZ456", nullptr, nullptr };
+
+    // Test functions
+    int id1 = registerVehicle(vehicle1);
+    int id2 = registerVehicle(vehicle2);
+
+    Vehicle fields{ 0, 2002, "Jane Roe", "ModelZ", "JKL789", nullptr, nullptr };
+    EXPECT_TRUE(updateVehicle(id2, fields));
+
+    // Test expectations
+    Vehicle found;
+    EXPECT_EQ(id2, id1 + 1);
+    EXPECT_TRUE(findVehicle(id2, found));
+    EXPECT_EQ(found.customerName, "Jane Roe");
+    EXPECT_EQ(found.plateNumber, "JKL789");
+
+    EXPECT_TRUE(removeVehicle(id1));
+    EXPECT_FALSE(findVehicle(id1, found));
+    EXPECT_EQ(headVehicle, vehicle2);
+    EXPECT_EQ(tailVehicle, vehicle2);
+    EXPECT_EQ(vehicle2->prev, nullptr);
+    EXPECT_FALSE(removeVehicle(id1));
+
+    // The tail follows a removal from the end of the list
+    Vehicle* vehicle3 = new Vehicle{ 0, 1003, "Jim Doe", "ModelZ", "MNO012", nullptr, nullptr };
+    int id3 = registerVehicle(vehicle3);
+    EXPECT_EQ(tailVehicle, vehicle3);
+    EXPECT_EQ(vehicle3->prev, vehicle2);
+    EXPECT_TRUE(removeVehicle(id3));
+    EXPECT_EQ(tailVehicle, vehicle2);
+    EXPECT_EQ(vehicle2->next, nullptr);
+
+    // Clean up memory
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+    delete vehicle1;
+    delete vehicle2;
+    delete vehicle3;
+}
+
+/**
+ * @brief Test case for vehicles registered by value into the vehicle arena.
+ */
+TEST_F(VehicleTests, TestArenaVehicles) {
+    // Test data
+    clearVehicles();
+    Vehicle fields{ 0, 1001, "John Doe With A Very Long Name", "ModelX", "ABC123", nullptr, nullptr };
+
+    // Test functions
+    int id1 = registerVehicle(fields);
+    Vehicle* first = headVehicle;
+    bool ownedByArena = vehicleArena->owns(first);
+    EXPECT_TRUE(removeVehicle(id1));
+    int id2 = registerVehicle(fields);
+
+    // Test expectations
+    EXPECT_TRUE(ownedByArena);
+    EXPECT_EQ(headVehicle, first); // The removed slot is reused
+    EXPECT_EQ(headVehicle->vehicleID, id2);
+    EXPECT_EQ(headVehicle->customerName, "John Doe With A Very Long Name");
+    EXPECT_EQ(headVehicle->customerName.get_allocator().resource(), vehicleArena->resource());
+
+    clearVehicles();
+    EXPECT_EQ(headVehicle, nullptr);
+    EXPECT_EQ(tailVehicle, nullptr);
+    EXPECT_EQ(CountVehicles(), 0);
+}
+
+/**
+ * @brief Test case for the customer table and customer fleet queries.
+ */
+TEST_F(VehicleTests, TestCustomerFleet) {
+    // Test data
+    clearVehicles();
+    int id1 = registerVehicle(Vehicle{ 0, 5001, "Fleet", "ModelX", "FL001", nullptr, nullptr });
+    int id2 = registerVehicle(Vehicle{ 0, 5002, "Solo", "ModelY", "SO001", nullptr, nullptr });
+    int id3 = registerVehicle(Vehicle{ 0, 5001, "Fleet", "ModelZ", "FL002", nullptr, nullptr });
+
+    addAppointment(Date{ 2024, 5, 20 }, Appointment{ id3, "Fleet", "Repair" });
+    addAppointment(Date{ 2024, 3, 2 }, Appointment{ id3, "Fleet", "Maintenance" });
+    addAppointment(Date{ 2024, 3, 2 }, Appointment{ id3, "Fleet", "Maintenance" }); // Recorded once
+    addAppointment(Date{ 2024, 4, 1 }, Appointment{ id2, "Solo", "Repair" });
+
+    // Test functions
+    vector<Vehicle> fleet = findVehiclesByCustomer(5001);
+    vector<pair<Date, Appointment>> booked = findAppointmentsByCustomer(5001);
+
+    // Test expectations
+    ASSERT_EQ(fleet.size(), 2);
+    EXPECT_EQ(fleet[0].vehicleID, id1);
+    EXPECT_EQ(fleet[1].vehicleID, id3);
+
+    ASSERT_EQ(booked.size(), 2);
+    EXPECT_EQ(booked[0].first.month, 3);
+    EXPECT_EQ(booked[0].second.appointmentType, "Maintenance");
+    EXPECT_EQ(booked[1].first.month, 5);
+    EXPECT_EQ(booked[1].second.vehicleID, id3);
+    EXPECT_EQ(booked[1].second.customerName, "Fleet");
+
+    // Moving a vehicle to another customer and removing one update the fleets
+    EXPECT_TRUE(updateVehicle(id1, Vehicle{ 0, 5002, "Solo", "ModelX", "FL001", nullptr, nullptr }));
+    EXPECT_TRUE(removeVehicle(id3));
+    Customer customer;
+    EXPECT_FALSE(findCustomer(5001, customer));
+    ASSERT_TRUE(findCustomer(5002, customer));
+    EXPECT_EQ(customer.vehicleIDs, (vector<int>{ id2, id1 }));
+
+    // Appointments with a vehicle keep it in the appointments file
+    stringstream line;
+    formatAppointmentLine(line, Date{ 2024, 5, 20 }, Appointment{ id3, "Fleet", "Repair" });
+    EXPECT_EQ(line.str(), "20 5 2024 Fleet " + to_string(id3) + " Repair\n");
+
+    clearVehicles();
+}
+
+/**
+ * @brief Test case for the normalized plate number index.
+ */
+TEST_F(VehicleTests, TestPlateIndex) {
+    // Test data
+    clearVehicles();
+    int id1 = registerVehicle(Vehicle{ 0, 6001, "John", "ModelX", "34 abc-123", nullptr, nullptr });
+    int id2 = registerVehicle(Vehicle{ 0, 6002, "Jane", "ModelY", "06XYZ9", nullptr, nullptr });
+
+    // Test functions
+    Vehicle found;
+    EXPECT_EQ(normalizePlate("34 abc-123"), "34ABC123");
+    ASSERT_TRUE(findVehicleByPlate("34ABC123", found));
+    EXPECT_EQ(found.vehicleID, id1);
+    ASSERT_TRUE(findVehicleByIdOrPlate("06-xyz-9", found));
+    EXPECT_EQ(found.vehicleID, id2);
+    ASSERT_TRUE(findVehicleByIdOrPlate(to_string(id1), found));
+    EXPECT_EQ(found.vehicleID, id1);
+
+    // Updating and removing keep the index current
+    EXPECT_TRUE(updateVehicle(id1, Vehicle{ 0, 6001, "John", "ModelX", "35-DEF-456", nullptr, nullptr }));
+    EXPECT_FALSE(findVehicleByPlate("34ABC123", found));
+    EXPECT_TRUE(findVehicleByPlate("35 def 456", found));
+    EXPECT_TRUE(removeVehicle(id2));
+    EXPECT_FALSE(findVehicleByPlate("06XYZ9", found));
+
+    // Loading rebuilds the index
+    updateVehicleFile("test_temp_plate_vehicle.dat", "test_plate_vehicle.dat");
+    clearVehicles();
+    EXPECT_FALSE(findVehicleByPlate("35DEF456", found));
+    loadVehiclesFromFile("test_plate_vehicle.dat");
+    ASSERT_TRUE(findVehicleByPlate("35DEF456", found));
+    EXPECT_EQ(found.vehicleID, id1);
+
+    clearVehicles();
+}
+
+/**
+ * @brief Test case for listing a page of vehicles.
+ */
+TEST_F(VehicleTests, TestSearchIndex) {
+    // Test data
+    clearVehicles();
+    int id1 = registerVehicle(Vehicle{ 0, 7001, "John Smith", "Corolla", "34 ABC 123", nullptr, nullptr });
+    int id2 = registerVehicle(Vehicle{ 0, 7002, "Jane Doe", "Civic", "06 XYZ 99", nullptr, nullptr });
+    Part part = { 0, "Brake Pad", "Corolla", 120.0f };
+    addPart(part);
+
+    // Test functions
+    SearchIndex index = buildSearchIndex();
+
+    // Prefixes match at any word start of a name
+    vector<SearchHit> hits = index.search("smi", 10);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].kind, SearchKind::Customer);
+    EXPECT_EQ(hits[0].id, 7001);
+    EXPECT_EQ(hits[0].distance, 0);
+
+    hits = index.search("34ab", 10);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].kind, SearchKind::Plate);
+    EXPECT_EQ(hits[0].id, id1);
+
+    hits = index.search("coro", 10);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].kind, SearchKind::Model);
+    EXPECT_EQ(hits[0].text, "Corolla");
+
+    hits = index.search("brake", 10);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].kind, SearchKind::Part);
+    EXPECT_EQ(hits[0].id, part.partID);
+
+    // Typos are tolerated after the prefix hits
+    hits = index.search("jnae d", 10);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].id, 7002);
+    EXPECT_GT(hits[0].distance, 0);
+
+    hits = index.search("06xyz 99", 10);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].id, id2);
+    EXPECT_EQ(hits[0].distance, 1);
+
+    EXPECT_TRUE(index.search("qqqq", 10).empty());
+    EXPECT_EQ(index.search("c", 1).size(), 1);
+
+    partHash.erase(to_string(part.partID));
+    clearVehicles();
+}
+
+TEST_F(VehicleTests, TestListVehiclesPage) {
+    // Test data
+    Vehicle* vehicle1 = new Vehicle{ 1, 1001, "John Doe", "ModelX", "ABC123", nullptr, nullptr };
+    Vehicle* vehicle2 = new Vehicle{ 2, 1002, "Jane Doe", "ModelY", "XYZ456", nullptr, nullptr };
+    Vehicle* vehicle3 = new Vehicle{ 3, 1003, "Jim Doe", "ModelZ", "JKL789", nullptr, nullptr };
+    headVehicle = vehicle1;
+    tailVehicle = vehicle2;
+    vehicle1->next = vehicle2;
+    vehicle2->prev = vehicle1;
+    vehicle2->next = vehicle3;
+    vehicle3->prev = vehicle2;
+    tailVehicle = vehicle3;
+
+    // Test function
+    vector<Vehicle> page = listVehiclesPage(1, 14);
+
+    // Test expectations
+    ASSERT_EQ(page.size(), 2);
+    EXPECT_EQ(page[0].vehicleID, 2);
+    EXPECT_EQ(page[1].vehicleID, 3);
+
+    // Clean up memory
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+    delete vehicle1;
+    delete vehicle2;
+    delete vehicle3;
+}
+
+/**
+ * @brief Test case for adding parts and finding them by model.
+ */
+TEST_F(VehicleTests, TestAddFindParts) {
+    // Test data
+    Part part1{ 0, "Brake", "ModelX", 300.0 };
+    Part part2{ 0, "Filter", "ModelY", 100.0 };
+
+    // Test functions
+    addPart(part1);
+    addPart(part2);
+    vector<Part> found = findPartsByModel("ModelX");
+
+    // Test expectations
+    EXPECT_EQ(CountParts(), 2);
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_EQ(found[0].name, "Brake");
+    EXPECT_EQ(listPartsPage(0, 14).size(), 2);
+}
+
+/**
+ * @brief Test case for interned model names.
+ */
+TEST_F(VehicleTests, TestModelNameInterning) {
+    // Test data
+    ModelName first("ModelX");
+    ModelName second(string("ModelX"));
+    ModelName other("ModelY");
+    ModelName missing;
+
+    // Test expectations
+    EXPECT_EQ(sizeof(ModelName), sizeof(uint32_t));
+    EXPECT_EQ(first.value(), second.value());
+    EXPECT_TRUE(first == second);
+    EXPECT_TRUE(first != other);
+    EXPECT_EQ(first.str(), "ModelX");
+    EXPECT_TRUE(first == "ModelX");
+    EXPECT_EQ(ModelName().str(), "");
+    EXPECT_FALSE(ModelName::find("ModelNeverInterned", missing));
+    EXPECT_TRUE(findPartsByModel("ModelNeverInterned").empty());
+    EXPECT_FALSE(ModelName::find("ModelNeverInterned", missing)); // Searching does not intern
+
+    istringstream input("ModelY");
+    input >> missing;
+    EXPECT_EQ(missing, other);
+}
+
+/**
+ * @brief Test case for concurrent readers and writers on the registries.
+ */
+TEST_F(VehicleTests, TestConcurrentRegistryAccess) {
+    // Test data
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+    const int writes = 200;
+    vector<Vehicle*> vehicles;
+    for (int i = 0; i < writes; ++i) {
+        vehicles.push_back(new Vehicle{ 0, 1000 + i, "Customer", "ModelX", "PLATE", nullptr, nullptr });
+    }
+
+    // Test function
+    atomic<bool> done(false);
+    vector<thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&done]() {
+            while (!done.load()) {
+                CountVehicles();
+                listVehiclesPage(0, 14);
+                collectAppointmentHeads();
+            }
+        });
+    }
+
+    thread writer([&vehicles]() {
+        for (size_t i = 0; i < vehicles.size(); ++i) {
+            registerVehicle(vehicles[i]);
+            addAppointment(Date{ 2024, static_cast<int>(i / 28) + 1, static_cast<int>(i % 28) + 1 }, Appointment{ 1, "Customer", "Repair" });
+        }
+    });
+
+    writer.join();
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    // Test expectations
+    EXPECT_EQ(CountVehicles(), writes);
+    EXPECT_EQ(collectAppointmentHeads().size(), writes);
+
+    // Clean up memory
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+    for (Vehicle* vehicle : vehicles) {
+        delete vehicle;
+    }
+}
+
+/**
+ * @brief Test case for concurrent submissions committed in batches.
+ */
+TEST_F(VehicleTests, TestSubmitAndCommitAppointments) {
+    // Test data
+    const int producers = 4;
+    const int perProducer = 250;
+    ofstream clearFile("test_intake_appointments.dat", std::ios::trunc);
+    clearFile.close();
+
+    // Test function
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                submitAppointment(Date{ 2024, p + 1, i % 28 + 1 }, Appointment{ i, "Customer" + to_string(p), "Repair" });
+            }
+        });
+    }
+    for (auto& producer : threads) {
+        producer.join();
+    }
+
+    size_t committed = 0;
+    size_t batches = 0;
+    size_t batch;
+    while ((batch = commitAppointmentBatch("test_intake_appointments.dat", 100)) > 0) {
+        committed += batch;
+        batches++;
+    }
+
+    // Test expectations
+    EXPECT_EQ(committed, producers * perProducer);
+    EXPECT_EQ(batches, 10);
+    EXPECT_EQ(appointmentMatrix[2024][1][1].front().customerName, "Customer0");
+    EXPECT_EQ(appointmentMatrix[2024][4][1].size(), 9);
+
+    ifstream file("test_intake_appointments.dat");
+    string line;
+    int lines = 0;
+    while (getline(file, line)) {
+        lines++;
+    }
+    EXPECT_EQ(lines, producers * perProducer);
+}
+
+/**
+ * @brief Test case for the appointment committer thread.
+ */
+TEST_F(VehicleTests, TestAppointmentCommitter) {
+    // Test data
+    ofstream clearFile("test_committer_appointments.dat", std::ios::trunc);
+    clearFile.close();
+
+    // Test function
+    startAppointmentCommitter("test_committer_appointments.dat");
+    for (int i = 0; i < 50; ++i) {
+        submitAppointment(Date{ 2025, 3, 7 }, Appointment{ i, "John", "Repair" });
+    }
+    stopAppointmentCommitter();
+
+    // Test expectations
+    EXPECT_TRUE(appointmentIntake.empty());
+    EXPECT_EQ(appointmentMatrix[2025][3][7].size(), 50);
+}
+
+/**
+ * @brief Test case for loading subsystems once, on the prefetch thread or on first use.
+ */
+TEST_F(VehicleTests, TestLazySubsystems) {
+    // Test data
+    LazySubsystem foreground("foreground");
+    LazySubsystem background("background");
+    atomic<int> loads(0);
+    atomic<bool> released(false);
+    vector<string> order;
+    Prefetcher prefetcher;
+
+    // Test functions
+    foreground.ensure([&]() { loads += 1; });
+    foreground.ensure([&]() { loads += 1; });
+
+    prefetcher.hint([&]() {
+        while (!released.load()) {
+            this_thread::yield();
+        }
+    });
+    prefetcher.hint([&]() { order.push_back("normal"); });
+    prefetcher.hint([&]() {
+        order.push_back("urgent");
+        background.ensure([&]() { loads += 10; });
+    }, true);
+    prefetcher.start();
+    released = true;
+    while (!background.isLoaded()) {
+        this_thread::yield();
+    }
+    background.ensure([&]() { loads += 100; });
+    prefetcher.stop();
+
+    // Test expectations
+    EXPECT_EQ(loads.load(), 11);
+    EXPECT_TRUE(foreground.isLoaded());
+    EXPECT_FALSE(foreground.loadedInBackground());
+    EXPECT_TRUE(background.loadedInBackground());
+    EXPECT_EQ(background.waitMilliseconds(), 0.0);
+    ASSERT_FALSE(order.empty());
+    EXPECT_EQ(order.front(), "urgent");
+
+    string report = startupTimingReport(1.5);
+    EXPECT_NE(report.find("first menu: 1.50 ms"), string::npos);
+    EXPECT_NE(report.find("parts: not loaded"), string::npos);
+}
+
+/**
+ * @brief Test case for saving the registries into a snapshot image and restoring them.
+ */
+TEST_F(VehicleTests, TestStateSnapshot) {
+    // Test data
+    clearVehicles();
+    int id1 = registerVehicle(Vehicle{ 0, 7001, "Ayse", "ModelX", "34 snp-001", nullptr, nullptr });
+    int id2 = registerVehicle(Vehicle{ 0, 7001, "Ayse", "SnapModel", "34SNP002", nullptr, nullptr });
+    updateVehicleFile("test_temp_snapshot_vehicle.dat", "test_snapshot_vehicle.dat");
+    ofstream partsFile("test_snapshot_parts.dat", ios::trunc);
+    partsFile << "Brake SnapModel 300\nFilter ModelY 100\n";
+    partsFile.close();
+    loadPartsFromFile("test_snapshot_parts.dat");
+    int nextVehicleID = vehicleID;
+    int nextPartID = partID;
+
+    // Test functions
+    bool saved = saveStateSnapshot("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat");
+    clearVehicles();
+    partHash.clear();
+    modelPartIndex.clear();
+    bool vehiclesRestored = restoreVehicleSnapshot("test_state.snap", "test_snapshot_vehicle.dat");
+    bool partsRestored = restorePartSnapshot("test_state.snap", "test_snapshot_parts.dat");
+
+    // Test expectations
+    ASSERT_TRUE(saved);
+    ASSERT_TRUE(vehiclesRestored);
+    ASSERT_TRUE(partsRestored);
+    EXPECT_TRUE(snapshotIsCurrent("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat"));
+    EXPECT_EQ(CountVehicles(), 2);
+    EXPECT_EQ(vehicleID, nextVehicleID);
+    EXPECT_EQ(partID, nextPartID);
+
+    Vehicle found;
+    ASSERT_TRUE(findVehicleByPlate("34SNP001", found));
+    EXPECT_EQ(found.vehicleID, id1);
+    EXPECT_EQ(found.model, "ModelX");
+    Customer customer;
+    ASSERT_TRUE(findCustomer(7001, customer));
+    EXPECT_EQ(customer.vehicleIDs, (vector<int>{ id1, id2 }));
+
+    vector<Part> parts = findPartsByModel("SnapModel");
+    ASSERT_EQ(parts.size(), 1u);
+    EXPECT_EQ(parts[0].name, "Brake");
+    EXPECT_EQ(parts[0].price, 300.0f);
+
+    // A changed source file makes its registry stale
+    ofstream("test_snapshot_parts.dat", ios::app) << "Pump SnapModel 50\n";
+    EXPECT_FALSE(restorePartSnapshot("test_state.snap", "test_snapshot_parts.dat"));
+    EXPECT_FALSE(snapshotIsCurrent("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat"));
+    EXPECT_TRUE(restoreVehicleSnapshot("test_state.snap", "test_snapshot_vehicle.dat"));
+
+    // A damaged section fails its checksum
+    string image = readWholeFile("test_state.snap");
+    size_t plate = image.find("34 snp-001");
+    ASSERT_NE(plate, string::npos);
+    image[plate] = '5';
+    ofstream("test_state.snap", ios::binary | ios::trunc) << image;
+    EXPECT_FALSE(restoreVehicleSnapshot("test_state.snap", "test_snapshot_vehicle.dat"));
+
+    clearVehicles();
+}
+
+/**
+ * @brief Test case for keeping the booked appointments and bay slots in the state snapshot.
+ */
+TEST_F(VehicleTests, TestAppointmentSnapshot) {
+    // Test data
+    clearVehicles();
+    updateVehicleFile("test_temp_snapshot_vehicle.dat", "test_snapshot_vehicle.dat");
+    ofstream("test_snapshot_parts.dat", ios::trunc) << "Brake SnapModel 300\n";
+    ofstream("test_snapshot_appointments.dat", ios::trunc) << "1 6 2026 Ayse 5 Repair\n1 6 2026 Mert\n";
+    Date date{ 2026, 6, 1 };
+    addAppointment(date, Appointment{ 5, "Ayse", "Repair" });
+    addAppointment(date, Appointment{ 0, "Mert", "" });
+    addAppointment(date, Appointment{ 6, "Deniz", "Warranty", 2 });
+    SlotBooking booking{ dayNumber(date), 1, 2, 3 };
+    bayScheduler.clear();
+    bayScheduler.reserve(booking);
+
+    std::stringstream before;
+    std::streambuf* oldCout = std::cout.rdbuf(before.rdbuf());
+    listAppointments(date);
+    std::cout.rdbuf(oldCout);
+
+    // Test functions
+    bool saved = saveStateSnapshot("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat", "test_snapshot_appointments.dat");
+    appointmentMatrix.clear();
+    initializeAppointmentMatrix(2050, 12, 31);
+    bayScheduler.clear();
+    bool restored = restoreAppointmentSnapshot("test_state.snap", "test_snapshot_appointments.dat");
+
+    // Test expectations
+    ASSERT_TRUE(saved);
+    ASSERT_TRUE(restored);
+    EXPECT_TRUE(snapshotIsCurrent("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat", "test_snapshot_appointments.dat"));
+
+    std::stringstream after;
+    oldCout = std::cout.rdbuf(after.rdbuf());
+    listAppointments(date);
+    std::cout.rdbuf(oldCout);
+    EXPECT_EQ(after.str(), before.str());
+    EXPECT_EQ(appointmentMatrix[2026][6][1].size(), 3u);
+    EXPECT_EQ(appointmentMatrix[2026][6][1].front().customerName, "Deniz");
+    EXPECT_EQ(vehicleAppointments[5].size(), 1u);
+    EXPECT_EQ(vehicleAppointments[6].size(), 1u);
+    EXPECT_EQ(bayScheduler.freeSlots(dayNumber(date)), serviceBays * slotsPerWorkday - 3);
+    EXPECT_FALSE(bayScheduler.reserve(booking));
+
+    // A changed appointments file makes the appointments stale, and an image without them never restores them
+    ofstream("test_snapshot_appointments.dat", ios::app) << "2 6 2026 Ali\n";
+    EXPECT_FALSE(restoreAppointmentSnapshot("test_state.snap", "test_snapshot_appointments.dat"));
+    EXPECT_FALSE(snapshotIsCurrent("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat", "test_snapshot_appointments.dat"));
+    EXPECT_TRUE(snapshotIsCurrent("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat"));
+    ASSERT_TRUE(saveStateSnapshot("test_state.snap", "test_snapshot_vehicle.dat", "test_snapshot_parts.dat"));
+    EXPECT_FALSE(restoreAppointmentSnapshot("test_state.snap", "test_snapshot_appointments.dat"));
+
+    bayScheduler.clear();
+    remove("test_snapshot_appointments.dat");
+}
+
+/**
+ * @brief Test case for booking bay slots and finding the first free one.
+ */
+TEST_F(VehicleTests, TestSlotScheduler) {
+    // Test data
+    SlotScheduler scheduler(2, 8);
+    SlotBooking found;
+    int32_t day = daysFromCivil(2025, 3, 10);
+
+    // Test functions and expectations
+    EXPECT_EQ(runStarts(0b0111'0110, 2), 0b0011'0010u);
+    EXPECT_EQ(runStarts(0b0111'0110, 3), 0b0001'0000u);
+
+    ASSERT_TRUE(scheduler.findFirstFree(day, 3, found));
+    EXPECT_EQ(found.day, day);
+    EXPECT_EQ(found.firstSlot, 0);
+    EXPECT_TRUE(scheduler.reserve({ day, 0, 0, 6 }));
+    EXPECT_FALSE(scheduler.reserve({ day, 0, 5, 2 }));
+    EXPECT_FALSE(scheduler.reserve({ day, 0, 7, 2 }));
+    EXPECT_TRUE(scheduler.reserve({ day, 1, 2, 4 }));
+    EXPECT_EQ(scheduler.freeSlots(day), 6);
+
+    // Bay 0 has slots 6 and 7 left, bay 1 slots 0, 1, 6 and 7
+    ASSERT_TRUE(scheduler.findFreeOnDay(day, 2, found));
+    EXPECT_EQ(found.bay, 1);
+    EXPECT_EQ(found.firstSlot, 0);
+    EXPECT_FALSE(scheduler.findFreeOnDay(day, 3, found));
+
+    // A 3 slot job moves to the next day; a full next day moves it once more
+    ASSERT_TRUE(scheduler.findFirstFree(day, 3, found));
+    EXPECT_EQ(found.day, day + 1);
+    EXPECT_TRUE(scheduler.reserve({ day + 1, 0, 0, 8 }));
+    EXPECT_TRUE(scheduler.reserve({ day + 1, 1, 1, 7 }));
+    ASSERT_TRUE(scheduler.findFirstFree(day, 3, found));
+    EXPECT_EQ(found.day, day + 2);
+    EXPECT_FALSE(scheduler.findFirstFree(day, 3, found, 2));
+    EXPECT_TRUE(scheduler.release({ day, 1, 2, 4 }));
+    EXPECT_FALSE(scheduler.release({ day, 1, 2, 4 }));
+    ASSERT_TRUE(scheduler.findFirstFree(day, 3, found));
+    EXPECT_EQ(found.day, day);
+    EXPECT_EQ(found.bay, 1);
+
+    // Booking through the global scheduler takes the duration of the type
+    {
+        lock_guard<mutex> scheduleLock(bayScheduleMutex);
+        bayScheduler.clear();
+    }
+    Date date{ 2025, 3, 10 };
+    Appointment repair{ 0, "Ayse", "Repair" };
+    SlotBooking booking;
+    VehicleAppointment conflict;
+    for (int i = 0; i < serviceBays * slotsPerWorkday / appointmentSlots("Repair"); ++i) {
+        date = Date{ 2025, 3, 10 };
+        ASSERT_EQ(bookAppointment(date, repair, booking, conflict), BookingConfirmed);
+    }
+    EXPECT_EQ(booking.slotCount, 8);
+    EXPECT_EQ(date.day, 10);
+    ASSERT_EQ(bookAppointment(date, repair, booking, conflict), BookingConfirmed);
+    EXPECT_EQ(date.day, 11);
+    EXPECT_EQ(slotTime(booking.firstSlot), "08:00");
+    EXPECT_EQ(slotTime(6), "09:30");
+
+    PendingAppointment pending;
+    while (appointmentIntake.tryPop(pending)) {
+    }
+    lock_guard<mutex> scheduleLock(bayScheduleMutex);
+    bayScheduler.clear();
+}
+
+/**
+ * @brief Test case for replaying the bay slots recorded in an appointments file.
+ */
+TEST_F(VehicleTests, TestReplayBookedSlots) {
+    // Test data: a booking that did not take the earliest free slots of its day
+    bayScheduler.clear();
+    remove("test_replay_appointments.dat");
+    Date date{ 2025, 3, 10 };
+    int32_t day = dayNumber(date);
+    SlotBooking booking;
+    VehicleAppointment conflict;
+    bayScheduler.reserve({ day, 0, 0, 4 });
+    ASSERT_EQ(bookAppointment(date, Appointment{ 0, "Ayse", "Repair" }, booking, conflict), BookingConfirmed);
+    ASSERT_EQ(commitAppointmentBatch("test_replay_appointments.dat", 16), 1u);
+    std::ostringstream line;
+    formatAppointmentLine(line, date, Appointment{ 0, "Can", "Inspection", 0, 1, 6 });
+
+    // Test functions
+    bayScheduler.clear();
+    size_t overbooked = reserveBookedSlots("test_replay_appointments.dat");
+    Appointment parsed;
+    string written = line.str();
+    ASSERT_TRUE(parseAppointmentLine(string_view(written).substr(0, written.size() - 1), date, parsed));
+
+    // Test expectations: the replay takes the recorded slots, not the earliest free ones
+    EXPECT_EQ(overbooked, 0u);
+    EXPECT_TRUE(bayScheduler.reserve({ day, 0, 0, 4 }));
+    EXPECT_FALSE(bayScheduler.reserve({ day, booking.bay, booking.firstSlot, 1 }));
+    EXPECT_EQ(bayScheduler.freeSlots(day), serviceBays * slotsPerWorkday - 4 - booking.slotCount);
+    EXPECT_EQ(written, "10 3 2025 Can 0 Inspection 0 1 6\n");
+    EXPECT_EQ(parsed.bay, 1);
+    EXPECT_EQ(parsed.firstSlot, 6);
+    ASSERT_TRUE(parseAppointmentLine("10 3 2025 Can 6 Repair 1", date, parsed));
+    EXPECT_EQ(parsed.bay, -1);
+
+    bayScheduler.clear();
+    remove("test_replay_appointments.dat");
+}
+
+TEST_F(VehicleTests, TestPriorityQueue) {
+    // Test data
+    PriorityQueue<Appointment, 2> queue;
+    const char* names[] = { "Ali", "Ayse", "Mehmet", "Zeynep", "Can", "Elif", "Deniz" };
+    const int priorities[] = { 0, 1, 0, 2, 1, 0, 2 };
+    Date date{ 2026, 4, 7 };
+
+    // Test functions: higher priority first, booking order among equals
+    for (int i = 0; i < 7; ++i) {
+        queue.push(Appointment{ i + 1, names[i], "Maintenance", priorities[i] });
+    }
+    string inOrder;
+    queue.forEachInOrder([&inOrder](const Appointment& appointment) { inOrder += appointment.customerName + ' '; });
+    EXPECT_EQ(inOrder, "Zeynep Deniz Ayse Can Ali Mehmet Elif ");
+    EXPECT_EQ(queue.size(), 7u);
+
+    string popped;
+    while (!queue.empty()) {
+        popped += queue.front().customerName + ' ';
+        queue.pop();
+    }
+    EXPECT_EQ(popped, inOrder);
+
+    // Listing leaves the day booked, and priorities survive the file
+    addAppointment(date, Appointment{ 4, "Ali", "Maintenance", appointmentPriority("Maintenance") });
+    addAppointment(date, Appointment{ 5, "Ayse", "Warranty", appointmentPriority("Warranty") });
+    addAppointment(date, Appointment{ 6, "Can", "Repair", appointmentPriority("Repair") });
+
+    std::stringstream outputStream;
+    std::streambuf* oldCout = std::cout.rdbuf(outputStream.rdbuf());
+    listAppointments(date);
+    std::cout.rdbuf(oldCout);
+    EXPECT_NE(outputStream.str().find("1. Ayse\n2. Can\n3. Ali\n"), string::npos);
+    ASSERT_EQ(appointmentMatrix[2026][4][7].size(), 3u);
+
+    writeAppointmentsToFile("test_priority_appointments.dat");
+    appointmentMatrix[2026][4][7].clear();
+    readAppointmentsFromFile("test_priority_appointments.dat");
+    ASSERT_EQ(appointmentMatrix[2026][4][7].size(), 3u);
+    EXPECT_EQ(appointmentMatrix[2026][4][7].front().customerName, "Ayse");
+    EXPECT_EQ(appointmentMatrix[2026][4][7].front().priority, 2);
+
+    Appointment parsed;
+    ASSERT_TRUE(parseAppointmentLine("7 4 2026 Can 6 Repair 1", date, parsed));
+    EXPECT_EQ(parsed.priority, 1);
+    ASSERT_TRUE(parseAppointmentLine("7 4 2026 Ali 4 Maintenance", date, parsed));
+    EXPECT_EQ(parsed.priority, 0);
+
+    remove("test_priority_appointments.dat");
+}
+
+TEST_F(VehicleTests, TestCalendarDay) {
+    // Test data
+    Date date{ 2024, 1, 31 };
+    Appointment appointment{ 1, "John Doe", "Repair" };
+    ParseError error;
+
+    // Test functions: calendar arithmetic
+    EXPECT_EQ(daysInMonth(2023, 2), 28);
+    EXPECT_EQ(daysInMonth(2000, 2), 29);
+    EXPECT_EQ(daysInMonth(1900, 2), 28);
+    EXPECT_FALSE(isValidCivil(2024, 4, 31));
+    EXPECT_FALSE(isValidCivil(2024, 13, 1));
+    EXPECT_TRUE(CalendarDay::fromCivil(2024, 3, 1) > CalendarDay::fromCivil(2024, 2, 29));
+    EXPECT_EQ(CalendarDay::fromCivil(2024, 3, 1) - CalendarDay::fromCivil(2024, 2, 1), 29);
+    Date moved = civilDate(calendarDay(date).addMonths(-2));
+    EXPECT_EQ(moved.year, 2023);
+    EXPECT_EQ(moved.month, 11);
+    EXPECT_EQ(moved.day, 30);
+
+    // Due dates clamp to the end of a shorter month
+    ServiceRecord warranty = makeServiceRecord(ServiceWarranty, appointment, date, {});
+    Date due = serviceDueDate(warranty);
+    EXPECT_EQ(due.month, 2);
+    EXPECT_EQ(due.day, 29);
+    ServiceRecord maintenance = makeServiceRecord(ServiceMaintenance, appointment, Date{ 2024, 2, 29 }, {});
+    due = serviceDueDate(maintenance);
+    EXPECT_EQ(due.year, 2025);
+    EXPECT_EQ(due.month, 2);
+    EXPECT_EQ(due.day, 28);
+
+    // Only dates that exist within the matrix are stored
+    EXPECT_TRUE(addAppointment(Date{ 2024, 12, 31 }, appointment));
+    EXPECT_EQ(appointmentMatrix[2024][12][31].size(), 1u);
+    EXPECT_FALSE(addAppointment(Date{ 2024, 11, 31 }, appointment));
+    EXPECT_FALSE(addAppointment(Date{ 2051, 1, 1 }, appointment));
+    EXPECT_FALSE(addAppointment(Date{ 2024, 0, 5 }, appointment));
+    EXPECT_TRUE(isBookableDate(Date{ 2024, 2, 29 }));
+    EXPECT_FALSE(isBookableDate(Date{ 2023, 2, 29 }));
+
+    EXPECT_FALSE(parseAppointmentLine("31 4 2024 Jane", date, appointment, &error));
+    EXPECT_STREQ(error.expected, "valid date");
+
+    std::stringstream outputStream;
+    std::streambuf* oldCout = std::cout.rdbuf(outputStream.rdbuf());
+    listAppointments(Date{ 2024, 13, 40 });
+    std::cout.rdbuf(oldCout);
+    EXPECT_EQ(outputStream.str(), "Appointments 40.13.2024:\n");
+}
+
+TEST_F(VehicleTests, TestAppointmentConflicts) {
+    // Test data
+    addAppointment(Date{ 2025, 3, 10 }, Appointment{ 7, "Ayse", "Repair" });
+    addAppointment(Date{ 2025, 3, 10 }, Appointment{ 7, "Ayse", "Inspection" });
+    addAppointment(Date{ 2025, 3, 20 }, Appointment{ 7, "Ayse", "Maintenance" });
+    addAppointment(Date{ 2025, 3, 1 }, Appointment{ 8, "Can", "Repair" });
+    addAppointment(Date{ 2025, 3, 7 }, Appointment{ 8, "Can", "Repair" });
+    addAppointment(Date{ 2025, 3, 1 }, Appointment{ 9, "Elif", "Repair" });
+    addAppointment(Date{ 2025, 3, 8 }, Appointment{ 9, "Elif", "Repair" });
+    VehicleAppointment conflict;
+
+    // Test functions: a booking conflicts within appointmentConflictDays on either side
+    ASSERT_TRUE(findVehicleConflict(7, Date{ 2025, 3, 16 }, conflict));
+    EXPECT_EQ(conflict.day, CalendarDay::fromCivil(2025, 3, 10));
+    ASSERT_TRUE(findVehicleConflict(7, Date{ 2025, 3, 17 }, conflict));
+    EXPECT_EQ(conflict.appointmentType, "Maintenance");
+    EXPECT_FALSE(findVehicleConflict(7, Date{ 2025, 3, 27 }, conflict));
+    EXPECT_FALSE(findVehicleConflict(7, Date{ 2025, 3, 3 }, conflict));
+    EXPECT_FALSE(findVehicleConflict(0, Date{ 2025, 3, 10 }, conflict));
+    EXPECT_FALSE(findVehicleConflict(10, Date{ 2025, 3, 10 }, conflict));
+
+    // The report finds the same pairs with any number of threads
+    vector<AppointmentConflict> conflicts = findAllConflicts(4);
+    ASSERT_EQ(conflicts.size(), 2u);
+    EXPECT_EQ(conflicts[0].vehicleID, 7);
+    EXPECT_EQ(conflicts[0].first.day, conflicts[0].second.day);
+    EXPECT_EQ(conflicts[1].vehicleID, 8);
+    EXPECT_EQ(conflicts[1].second.day - conflicts[1].first.day, 6);
+    EXPECT_EQ(findAllConflicts(1).size(), 2u);
+
+    // Appointments already in the file are checked once the bays are replayed
+    {
+        ofstream appointments("test_conflict_appointments.dat", std::ios::trunc);
+        appointments << "12 5 2025 Deniz 11 Repair\n";
+    }
+    reserveBookedSlots("test_conflict_appointments.dat");
+    EXPECT_TRUE(findVehicleConflict(11, Date{ 2025, 5, 14 }, conflict));
+
+    lock_guard<mutex> scheduleLock(bayScheduleMutex);
+    bayScheduler.clear();
+    remove("test_conflict_appointments.dat");
+}
+
+TEST_F(VehicleTests, TestRecurringAppointments) {
+    // Test data
+    Recurrence monthly;
+    monthly.start = CalendarDay::fromCivil(2025, 1, 31);
+    monthly.count = 4;
+    Recurrence tenDays;
+    tenDays.start = CalendarDay::fromCivil(2025, 1, 1);
+    tenDays.interval = 10;
+    tenDays.unit = RecurDays;
+    tenDays.until = CalendarDay::fromCivil(2025, 2, 15);
+    vector<CalendarDay> days;
+    auto collect = [&days](uint32_t, CalendarDay day) { days.push_back(day); };
+
+    // Test functions: month steps clamp without drifting, count and until end the series
+    EXPECT_EQ(monthly.forEachBetween(CalendarDay::fromCivil(2025, 2, 1), CalendarDay::fromCivil(2030, 1, 1), collect), 3u);
+    ASSERT_EQ(days.size(), 3u);
+    EXPECT_EQ(days[0], CalendarDay::fromCivil(2025, 2, 28));
+    EXPECT_EQ(days[1], CalendarDay::fromCivil(2025, 3, 31));
+    EXPECT_EQ(days[2], CalendarDay::fromCivil(2025, 4, 30));
+    EXPECT_EQ(tenDays.firstIndexFrom(CalendarDay::fromCivil(2025, 1, 15)), 2u);
+    days.clear();
+    EXPECT_EQ(tenDays.forEachBetween(CalendarDay::fromCivil(2025, 1, 15), CalendarDay::fromCivil(2025, 12, 31), collect), 3u);
+    EXPECT_EQ(days.back(), CalendarDay::fromCivil(2025, 2, 10));
+
+    // Only the visits of the viewed range are produced, whatever the contracts' length
+    for (int vehicle = 1; vehicle <= 500; ++vehicle) {
+        Recurrence every6Months;
+        every6Months.start = CalendarDay::fromCivil(2025, vehicle % 12 + 1, vehicle % 28 + 1);
+        every6Months.interval = 6;
+        every6Months.until = every6Months.start.addYears(10);
+        ASSERT_TRUE(addRecurringAppointment({ Appointment{ vehicle, "Fleet", "Maintenance" }, every6Months }));
+    }
+    vector<pair<Date, Appointment>> visits = recurringAppointmentsBetween(Date{ 2030, 3, 1 }, Date{ 2030, 3, 31 });
+    EXPECT_EQ(visits.size(), 84u);
+    for (size_t i = 1; i < visits.size(); ++i) {
+        EXPECT_LE(visits[i - 1].first.day, visits[i].first.day);
+    }
+    EXPECT_TRUE(recurringAppointmentsBetween(Date{ 2036, 1, 1 }, Date{ 2036, 12, 31 }).empty());
+
+    // Contracts survive the file, and their visits are listed with the day's appointments
+    {
+        unique_lock<shared_mutex> rulesLock(recurringAppointmentsMutex);
+        recurringAppointments.clear();
+    }
+    remove("test_recurring.dat");
+    ASSERT_TRUE(saveRecurringAppointment("test_recurring.dat", { Appointment{ 7, "Ayse", "Warranty" }, monthly }));
+    ASSERT_TRUE(saveRecurringAppointment("test_recurring.dat", { Appointment{ 8, "Can", "Inspection" }, tenDays }));
+    {
+        unique_lock<shared_mutex> rulesLock(recurringAppointmentsMutex);
+        recurringAppointments.clear();
+    }
+    EXPECT_EQ(loadRecurringAppointments("test_recurring.dat"), 2u);
+    ASSERT_EQ(recurringAppointments.size(), 2u);
+    EXPECT_EQ(recurringAppointments[0].recurrence.count, 4u);
+    EXPECT_FALSE(recurringAppointments[0].recurrence.hasLastDay());
+    EXPECT_EQ(recurringAppointments[0].appointment.priority, 2);
+    EXPECT_EQ(recurringAppointments[1].recurrence.unit, RecurDays);
+    EXPECT_EQ(recurringAppointments[1].recurrence.until, tenDays.until);
+
+    addAppointment(Date{ 2025, 3, 31 }, Appointment{ 9, "Deniz", "Repair" });
+    std::stringstream outputStream;
+    std::streambuf* oldCout = std::cout.rdbuf(outputStream.rdbuf());
+    listAppointments(Date{ 2025, 3, 31 });
+    std::cout.rdbuf(oldCout);
+    EXPECT_EQ(outputStream.str(), "Appointments 31.3.2025:\n1. Deniz\n2. Ayse\n");
+
+    RecurringAppointment rule;
+    ParseError error;
+    EXPECT_FALSE(parseRecurringLine("1 1 2025 Fleet 5 Maintenance 0 months 0 0 0 0", rule, &error));
+    EXPECT_STREQ(error.expected, "interval");
+    EXPECT_FALSE(parseRecurringLine("1 1 2025 Fleet 5 Maintenance 6 weeks 0 0 0 0", rule, &error));
+    EXPECT_STREQ(error.expected, "days or months");
+
+    unique_lock<shared_mutex> rulesLock(recurringAppointmentsMutex);
+    recurringAppointments.clear();
+    remove("test_recurring.dat");
+}
+
+TEST_F(VehicleTests, TestQuote) {
+    // Test data
+    Part pad{ 0, "Pad", "QuoteModel", 450.0f };
+    Part disc{ 0, "Disc", "QuoteModel", 1800.0f };
+    Part caliper{ 0, "Caliper", "QuoteModel", 12000.0f };
+    Part filter{ 0, "Filter", "OtherModel", 80.0f };
+    addPart(pad);
+    addPart(disc);
+    addPart(caliper);
+    addPart(filter);
+    Quote quote;
+    quote.model = "QuoteModel";
+
+    // Test functions: running totals match a full recalculation
+    addQuotePart(quote, pad);
+    addQuotePart(quote, disc);
+    addQuotePart(quote, pad);
+    addQuotePart(quote, caliper);
+    PriceResult expected = calculateTotalPrice({ pad, disc, pad, caliper });
+    EXPECT_FLOAT_EQ(quoteTotals(quote).totalAmount, expected.totalAmount);
+    EXPECT_FLOAT_EQ(quoteTotals(quote).amountWithoutLabor, expected.amountWithoutLabor);
+    ASSERT_EQ(quote.lines.size(), 3u);
+    EXPECT_EQ(quote.lines[0].partID, pad.partID);
+    EXPECT_EQ(quote.lines[0].quantity, 2);
+
+    EXPECT_TRUE(removeQuotePart(quote, caliper.partID));
+    EXPECT_FALSE(removeQuotePart(quote, caliper.partID));
+    expected = calculateTotalPrice({ pad, disc, pad });
+    EXPECT_FLOAT_EQ(quoteTotals(quote).totalAmount, expected.totalAmount);
+
+    // The key ignores order, and the quote survives the file
+    EXPECT_EQ(quoteKey("QuoteModel", { disc.partID, pad.partID, pad.partID }), quoteKey(quote));
+    EXPECT_NE(quoteKey("QuoteModel", { disc.partID, pad.partID }), quoteKey(quote));
+    ASSERT_TRUE(saveQuote("test_quote.txt", quote));
+    Quote loaded;
+    ASSERT_TRUE(loadQuote("test_quote.txt", loaded));
+    EXPECT_EQ(loaded.model, "QuoteModel");
+    EXPECT_EQ(quoteKey(loaded), quoteKey(quote));
+    EXPECT_FLOAT_EQ(quoteTotals(loaded).totalAmount, expected.totalAmount);
+    EXPECT_FALSE(loadQuote("test_missing_quote.txt", loaded));
+
+    // A standard job is priced once per part registry version
+    Quote job = priceJob("QuoteModel", { disc.partID, pad.partID, filter.partID, pad.partID });
+    EXPECT_EQ(quoteKey(job), quoteKey(quote));
+    EXPECT_FLOAT_EQ(quoteTotals(job).totalAmount, expected.totalAmount);
+    Quote cached;
+    ASSERT_TRUE(findCachedQuote(quoteKey("QuoteModel", { pad.partID, filter.partID, pad.partID, disc.partID }), cached));
+    EXPECT_EQ(quoteKey(cached), quoteKey(job));
+    Part extra{ 0, "Hose", "QuoteModel", 60.0f };
+    addPart(extra);
+    EXPECT_FALSE(findCachedQuote(quoteKey("QuoteModel", { pad.partID, filter.partID, pad.partID, disc.partID }), cached));
+
+    // The standard jobs of a model are its jobs priced at the current registry version
+    EXPECT_TRUE(standardJobs("QuoteModel").empty());
+    EXPECT_EQ(quotePartIDs(quote), (vector<int>{ pad.partID, pad.partID, disc.partID }));
+    priceJob("QuoteModel", quotePartIDs(quote));
+    priceJob("QuoteModel", { disc.partID });
+    priceJob("QuoteModel", { filter.partID });
+    vector<Quote> jobs = standardJobs("QuoteModel");
+    ASSERT_EQ(jobs.size(), 2u);
+    vector<string> expectedKeys = { quoteKey(quote), quoteKey("QuoteModel", { disc.partID }) };
+    sort(expectedKeys.begin(), expectedKeys.end());
+    EXPECT_EQ((vector<string>{ quoteKey(jobs[0]), quoteKey(jobs[1]) }), expectedKeys);
+    EXPECT_TRUE(standardJobs("OtherModel").empty());
+
+    while (removeQuotePart(quote, pad.partID)) {
+    }
+    EXPECT_TRUE(removeQuotePart(quote, disc.partID));
+    EXPECT_EQ(quote.partsAmount, 0);
+    EXPECT_EQ(quote.laborAmount, 0);
+
+    lock_guard<mutex> cacheLock(quoteCacheMutex);
+    quoteCache.clear();
+    remove("test_quote.txt");
+}
+
+TEST_F(VehicleTests, TestCommittedBookingListedOnce) {
+    // Test data
+    Date date{ 2026, 5, 4 };
+    remove("test_listed_once_appointments.dat");
+
+    // Test functions: a committed booking is in the matrix once, however often it is listed
+    submitAppointment(date, Appointment{ 3, "Ali", "Repair" });
+    ASSERT_EQ(commitAppointmentBatch("test_listed_once_appointments.dat", 16), 1u);
+    ASSERT_EQ(appointmentMatrix[2026][5][4].size(), 1u);
+
+    std::stringstream outputStream;
+    std::streambuf* oldCout = std::cout.rdbuf(outputStream.rdbuf());
+    listAppointments(date);
+    listAppointments(date);
+    std::cout.rdbuf(oldCout);
+    EXPECT_EQ(outputStream.str(), "Appointments 4.5.2026:\n1. Ali\nAppointments 4.5.2026:\n1. Ali\n");
+    EXPECT_EQ(appointmentMatrix[2026][5][4].size(), 1u);
+    EXPECT_EQ(collectAppointmentHeads().size(), 1u);
+    EXPECT_EQ(appointmentMatrix[2026][5][4].size(), 1u);
+
+    remove("test_listed_once_appointments.dat");
+}
+
+/**
+ * @brief Test case for booking the same vehicle twice before the committer runs.
+ */
+TEST_F(VehicleTests, TestBookAppointmentTwice) {
+    // Test data
+    bayScheduler.clear();
+    Date first{ 2026, 7, 6 };
+    Date second{ 2026, 7, 8 };
+    Date other{ 2026, 7, 8 };
+    SlotBooking booking;
+    VehicleAppointment conflict;
+
+    // Test functions: both bookings are made back to back, with nothing committed in between
+    BookingOutcome firstOutcome = bookAppointment(first, Appointment{ 9, "Ali", "Repair", 1 }, booking, conflict);
+    BookingOutcome secondOutcome = bookAppointment(second, Appointment{ 9, "Ali", "Maintenance" }, booking, conflict);
+    BookingOutcome otherOutcome = bookAppointment(other, Appointment{ 10, "Ece", "Maintenance" }, booking, conflict);
+
+    // Test expectations
+    EXPECT_EQ(firstOutcome, BookingConfirmed);
+    EXPECT_EQ(secondOutcome, BookingVehicleConflict);
+    EXPECT_EQ(conflict.day, calendarDay(Date{ 2026, 7, 6 }));
+    EXPECT_EQ(conflict.appointmentType, "Repair");
+    EXPECT_EQ(otherOutcome, BookingConfirmed);
+    EXPECT_EQ(bayScheduler.freeSlots(dayNumber(Date{ 2026, 7, 8 })), serviceBays * slotsPerWorkday - appointmentSlots("Maintenance"));
+
+    // Only the confirmed bookings were queued
+    PendingAppointment pending;
+    vector<int> queued;
+    while (appointmentIntake.tryPop(pending)) {
+        queued.push_back(pending.appointment.vehicleID);
+    }
+    EXPECT_EQ(queued, (vector<int>{ 9, 10 }));
+
+    bayScheduler.clear();
+}
+
+/**
+ * @brief Test case for a booking pushed past the last day of the appointment matrix.
+ */
+TEST_F(VehicleTests, TestBookAppointmentOutsideCalendar) {
+    // Test data: the last day of the matrix is full
+    bayScheduler.clear();
+    Date date{ 2050, 12, 31 };
+    SlotBooking booking;
+    VehicleAppointment conflict;
+    for (int i = 0; i < serviceBays * slotsPerWorkday / appointmentSlots("Repair"); ++i) {
+        date = Date{ 2050, 12, 31 };
+        ASSERT_EQ(bookAppointment(date, Appointment{ 0, "Ali", "Repair" }, booking, conflict), BookingConfirmed);
+    }
+
+    // Test function
+    date = Date{ 2050, 12, 31 };
+    BookingOutcome outcome = bookAppointment(date, Appointment{ 0, "Ece", "Repair" }, booking, conflict);
+
+    // Test expectations: nothing is reserved or queued for the day after
+    EXPECT_EQ(outcome, BookingOutsideCalendar);
+    EXPECT_EQ(date.year, 2050);
+    EXPECT_EQ(bayScheduler.freeSlots(dayNumber(Date{ 2051, 1, 1 })), serviceBays * slotsPerWorkday);
+    PendingAppointment pending;
+    size_t queued = 0;
+    while (appointmentIntake.tryPop(pending)) {
+        EXPECT_EQ(pending.appointment.customerName, "Ali");
+        queued++;
+    }
+    EXPECT_EQ(queued, static_cast<size_t>(serviceBays * slotsPerWorkday / appointmentSlots("Repair")));
+
+    bayScheduler.clear();
+}
+
+#ifdef ENABLE_VEHICLE_METRICS
+/**
+ * @brief Test case for the hot path timers, counters and their export.
+ */
+TEST_F(VehicleTests, TestMetricsDump) {
+    // Test data
+    ofstream partsFile("test_metrics_parts.dat", std::ios::trunc);
+    partsFile << "Brake ModelX 300\nFilter ModelY 100\n";
+    partsFile.close();
+    resetMetrics();
+
+    // Test functions
+    loadPartsFromFile("test_metrics_parts.dat");
+    findPartsByModel("ModelX");
+    bool prometheusWritten = dumpMetrics("test_metrics.prom", MetricsFormat::Prometheus);
+    bool jsonWritten = dumpMetrics("test_metrics.json", MetricsFormat::Json);
+
+    // Test expectations
+    ASSERT_TRUE(prometheusWritten);
+    ASSERT_TRUE(jsonWritten);
+
+    uint64_t loadCalls = 0;
+    uint64_t partsLoaded = 0;
+    for (const MetricSnapshot& snapshot : collectMetrics()) {
+        if (snapshot.name == "loadPartsFromFile") {
+            loadCalls = snapshot.count;
+        }
+        if (snapshot.name == "partsLoaded") {
+            partsLoaded = snapshot.sum;
+        }
+    }
+    EXPECT_EQ(loadCalls, 1);
+    EXPECT_EQ(partsLoaded, 2);
+
+    string prometheus = DisplayFileContent("test_metrics.prom");
+    EXPECT_NE(prometheus.find("vehicle_call_duration_seconds_count{function=\"loadPartsFromFile\"} 1"), string::npos);
+    EXPECT_NE(prometheus.find("vehicle_call_duration_seconds_bucket{function=\"findPartsByModel\",le=\"+Inf\"} 1"), string::npos);
+    EXPECT_NE(prometheus.find("vehicle_events_total{event=\"partsLoaded\"} 2"), string::npos);
+
+    string json = DisplayFileContent("test_metrics.json");
+    EXPECT_NE(json.find("{\"name\": \"loadPartsFromFile\", \"count\": 1"), string::npos);
+    EXPECT_NE(json.find("{\"name\": \"partsLoaded\", \"value\": 2}"), string::npos);
+}
+#endif
+
 /**
  * @brief The main function of the test program.
  *
@@ -14,6 +14,9 @@
 #include <cstdint>    ///< Include for standard integer types on Windows
 #include <inttypes.h> ///< Include for integer format macros on Windows
 #include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -24,6 +27,17 @@
 #include <vector>
 #include <iomanip>
 #include <queue>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <array>
+#include <filesystem>
+#include <ctime>
 #define CLEAR_SCREEN "cls"
 #elif defined(__linux__)
 #include <cstddef>
@@ -32,6 +46,9 @@
 #include <inttypes.h> ///< Include for integer format macros on Linux
 #include "../../utility/header/commonTypes.h"
 #include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -40,6 +57,17 @@
 #include <vector>
 #include <iomanip>
 #include <queue>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <array>
+#include <filesystem>
+#include <ctime>
 #include <termios.h>
 #include <unistd.h>
 #define CLEAR_SCREEN "clear"
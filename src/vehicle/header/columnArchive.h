@@ -0,0 +1,407 @@
+/**
+ * @file columnArchive.h
+ *
+ * @brief Provides an immutable columnar archive of appointments and service records
+ */
+
+#ifndef COLUMN_ARCHIVE_H
+#define COLUMN_ARCHIVE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "varint.h"
+
+/*
+ * An archive file holds rows sorted by day and vehicle, cut into blocks of
+ * archiveBlockRows rows. Every column of a block is stored separately:
+ *
+ *  day, vehicle   zigzag varint deltas from the previous row
+ *  source         one byte per row
+ *  amount         one float per row
+ *  type, model,   varint codes into a dictionary of the archive
+ *  customer
+ *
+ * The block directory at the end of the file keeps the row count, the day and
+ * vehicle ranges (zone maps) and the byte range of every column of every block,
+ * so a scan reads only the blocks overlapping its day range and only the
+ * columns it asks for.
+ */
+
+/**
+ * @enum ArchiveSource
+ * @brief Where an archived row came from.
+ */
+enum ArchiveSource : uint8_t {
+    ArchiveAppointment = 0,     ///< Booked appointment.
+    ArchiveReport = 1,          ///< Service report of the history file.
+    ArchiveWarranty = 2,        ///< Warranty record.
+    ArchiveMaintenance = 3      ///< Maintenance record.
+};
+
+/**
+ * @enum ArchiveColumn
+ * @brief Column of an archive; combined into a bit mask to select the columns a scan reads.
+ */
+enum ArchiveColumn : uint32_t {
+    ColumnDay = 1 << 0,         ///< Day number of the row.
+    ColumnVehicle = 1 << 1,     ///< Vehicle ID.
+    ColumnSource = 1 << 2,      ///< ArchiveSource.
+    ColumnAmount = 1 << 3,      ///< Amount charged.
+    ColumnType = 1 << 4,        ///< Appointment or service type, dictionary encoded.
+    ColumnModel = 1 << 5,       ///< Vehicle model, dictionary encoded.
+    ColumnCustomer = 1 << 6     ///< Customer name, dictionary encoded.
+};
+
+const int archiveColumnCount = 7;               ///< Number of columns.
+const int archiveDictionaryCount = 3;           ///< Dictionary columns: type, model and customer.
+const size_t archiveBlockRows = 4096;           ///< Rows per block.
+const char archiveMagic[8] = "VCOL001";         ///< Identifies an archive file.
+
+/**
+ * @struct ArchiveRow
+ * @brief One row as handed to the archive writer.
+ */
+struct ArchiveRow {
+    int32_t day;                ///< Day number, see daysFromCivil.
+    int32_t vehicleID;          ///< Vehicle ID, 0 when unknown.
+    uint8_t source;             ///< ArchiveSource.
+    float amount;               ///< Amount charged, 0 for appointments.
+    std::string type;           ///< Appointment or service type.
+    std::string model;          ///< Vehicle model, empty when unknown.
+    std::string customer;       ///< Customer name.
+};
+
+/**
+ * @struct ArchiveHeader
+ * @brief Fixed header at the start of an archive file.
+ */
+struct ArchiveHeader {
+    char magic[8];              ///< archiveMagic.
+    uint64_t rowCount;          ///< Number of rows.
+    uint64_t blockCount;        ///< Number of blocks.
+    uint64_t dictionaryOffset;  ///< File offset of the dictionaries.
+    uint64_t directoryOffset;   ///< File offset of the block directory.
+};
+
+/**
+ * @struct ArchiveBlockInfo
+ * @brief Directory entry of one block.
+ */
+struct ArchiveBlockInfo {
+    uint32_t rows;                                  ///< Rows in the block.
+    int32_t minDay;                                 ///< Smallest day in the block.
+    int32_t maxDay;                                 ///< Largest day in the block.
+    int32_t minVehicle;                             ///< Smallest vehicle ID in the block.
+    int32_t maxVehicle;                             ///< Largest vehicle ID in the block.
+    uint32_t columnLength[archiveColumnCount];      ///< Bytes of every column.
+    uint64_t columnOffset[archiveColumnCount];      ///< File offset of every column.
+};
+
+/**
+ * @struct ArchiveBlock
+ * @brief Decoded columns of one block; columns a scan did not ask for stay empty.
+ */
+struct ArchiveBlock {
+    size_t rows = 0;                ///< Rows in the block.
+    std::vector<int32_t> day;       ///< ColumnDay.
+    std::vector<int32_t> vehicleID; ///< ColumnVehicle.
+    std::vector<uint8_t> source;    ///< ColumnSource.
+    std::vector<float> amount;      ///< ColumnAmount.
+    std::vector<uint32_t> type;     ///< ColumnType codes.
+    std::vector<uint32_t> model;    ///< ColumnModel codes.
+    std::vector<uint32_t> customer; ///< ColumnCustomer codes.
+};
+
+/**
+ * @brief Returns the position of a dictionary column among the dictionaries, or -1.
+ */
+inline int archiveDictionaryIndex(ArchiveColumn column) {
+    switch (column) {
+    case ColumnType: return 0;
+    case ColumnModel: return 1;
+    case ColumnCustomer: return 2;
+    default: return -1;
+    }
+}
+
+/**
+ * @brief Writes rows into a new archive file.
+ *
+ * The rows are sorted by day and vehicle first. The file is written under a
+ * temporary name and renamed into place, so readers never see a partial archive.
+ *
+ * @param path Path of the archive.
+ * @param rows The rows; reordered by the call.
+ * @return true on success.
+ */
+inline bool writeColumnArchive(const std::string& path, std::vector<ArchiveRow>& rows) {
+    std::sort(rows.begin(), rows.end(), [](const ArchiveRow& a, const ArchiveRow& b) {
+        return std::tie(a.day, a.vehicleID) < std::tie(b.day, b.vehicleID);
+    });
+
+    // Dictionary codes in order of first appearance
+    std::vector<std::string> dictionaries[archiveDictionaryCount];
+    std::unordered_map<std::string, uint32_t> codes[archiveDictionaryCount];
+    auto encode = [&](int dictionary, const std::string& value) {
+        auto inserted = codes[dictionary].emplace(value, static_cast<uint32_t>(dictionaries[dictionary].size()));
+        if (inserted.second) {
+            dictionaries[dictionary].push_back(value);
+        }
+        return inserted.first->second;
+    };
+
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    ArchiveHeader header = {};
+    std::copy(archiveMagic, archiveMagic + 8, header.magic);
+    header.rowCount = rows.size();
+    header.blockCount = (rows.size() + archiveBlockRows - 1) / archiveBlockRows;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t position = sizeof(header);
+
+    std::vector<ArchiveBlockInfo> directory;
+    std::string columns[archiveColumnCount];
+    for (size_t first = 0; first < rows.size(); first += archiveBlockRows) {
+        size_t last = std::min(rows.size(), first + archiveBlockRows);
+        ArchiveBlockInfo info = {};
+        info.rows = static_cast<uint32_t>(last - first);
+        info.minDay = rows[first].day;
+        info.maxDay = rows[last - 1].day;
+        info.minVehicle = rows[first].vehicleID;
+        info.maxVehicle = rows[first].vehicleID;
+
+        for (std::string& column : columns) {
+            column.clear();
+        }
+        int32_t previousDay = 0;
+        int32_t previousVehicle = 0;
+        for (size_t r = first; r < last; ++r) {
+            const ArchiveRow& row = rows[r];
+            info.minVehicle = std::min(info.minVehicle, row.vehicleID);
+            info.maxVehicle = std::max(info.maxVehicle, row.vehicleID);
+
+            appendVarint(columns[0], zigzagEncode(static_cast<int64_t>(row.day) - previousDay));
+            appendVarint(columns[1], zigzagEncode(static_cast<int64_t>(row.vehicleID) - previousVehicle));
+            columns[2].push_back(static_cast<char>(row.source));
+            columns[3].append(reinterpret_cast<const char*>(&row.amount), sizeof(float));
+            appendVarint(columns[4], encode(0, row.type));
+            appendVarint(columns[5], encode(1, row.model));
+            appendVarint(columns[6], encode(2, row.customer));
+            previousDay = row.day;
+            previousVehicle = row.vehicleID;
+        }
+
+        for (int c = 0; c < archiveColumnCount; ++c) {
+            info.columnOffset[c] = position;
+            info.columnLength[c] = static_cast<uint32_t>(columns[c].size());
+            out.write(columns[c].data(), static_cast<std::streamsize>(columns[c].size()));
+            position += columns[c].size();
+        }
+        directory.push_back(info);
+    }
+
+    std::string dictionaryBytes;
+    for (const auto& dictionary : dictionaries) {
+        appendVarint(dictionaryBytes, dictionary.size());
+        for (const std::string& value : dictionary) {
+            appendVarint(dictionaryBytes, value.size());
+            dictionaryBytes += value;
+        }
+    }
+    header.dictionaryOffset = position;
+    out.write(dictionaryBytes.data(), static_cast<std::streamsize>(dictionaryBytes.size()));
+    header.directoryOffset = position + dictionaryBytes.size();
+    out.write(reinterpret_cast<const char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(ArchiveBlockInfo)));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    return !error;
+}
+
+/**
+ * @class ColumnArchiveReader
+ * @brief Reads the blocks and columns of an archive file selectively.
+ *
+ * The header, the dictionaries and the block directory are read by open();
+ * column data is read block by block during a scan.
+ */
+class ColumnArchiveReader {
+public:
+    /**
+     * @brief Opens an archive file.
+     *
+     * @param path Path of the archive.
+     * @return true if the file is a complete archive.
+     */
+    bool open(const std::string& path) {
+        in.close();
+        in.clear();
+        in.open(path, std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::string_view(header.magic, 8) != std::string_view(archiveMagic, 8)) {
+            return false;
+        }
+
+        std::string dictionaryBytes(static_cast<size_t>(header.directoryOffset - header.dictionaryOffset), '\0');
+        in.seekg(static_cast<std::streamoff>(header.dictionaryOffset));
+        in.read(&dictionaryBytes[0], static_cast<std::streamsize>(dictionaryBytes.size()));
+        const char* cursor = dictionaryBytes.data();
+        const char* end = dictionaryBytes.data() + dictionaryBytes.size();
+        for (auto& dictionary : dictionaries) {
+            uint64_t count;
+            if (!readVarint(cursor, end, count) || count > static_cast<uint64_t>(end - cursor)) {
+                return false;
+            }
+            dictionary.resize(static_cast<size_t>(count));
+            for (std::string& value : dictionary) {
+                if (!readVarintString(cursor, end, value)) {
+                    return false;
+                }
+            }
+        }
+
+        directory.resize(static_cast<size_t>(header.blockCount));
+        in.read(reinterpret_cast<char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(ArchiveBlockInfo)));
+        return static_cast<bool>(in);
+    }
+
+    /**
+     * @brief Returns the number of rows in the archive.
+     */
+    uint64_t rowCount() const {
+        return header.rowCount;
+    }
+
+    /**
+     * @brief Returns the number of blocks in the archive.
+     */
+    size_t blockCount() const {
+        return directory.size();
+    }
+
+    /**
+     * @brief Returns the values of a dictionary column, indexed by code.
+     *
+     * @param column ColumnType, ColumnModel or ColumnCustomer.
+     * @return const std::vector<std::string>& The dictionary.
+     */
+    const std::vector<std::string>& dictionary(ArchiveColumn column) const {
+        return dictionaries[archiveDictionaryIndex(column)];
+    }
+
+    /**
+     * @brief Calls a function with every block overlapping a day range.
+     *
+     * Blocks whose zone map lies outside the range are skipped without being
+     * read. Rows of a visited block outside the range are not filtered; the
+     * function checks the day column when it needs exact bounds.
+     *
+     * @param columns Bit mask of the ArchiveColumn values to decode.
+     * @param fromDay First day of the range.
+     * @param toDay Last day of the range.
+     * @param function Called with each decoded ArchiveBlock.
+     * @return size_t Number of blocks read.
+     */
+    template <typename Function>
+    size_t scan(uint32_t columns, int32_t fromDay, int32_t toDay, Function function) {
+        size_t visited = 0;
+        ArchiveBlock block;
+        std::string bytes;
+        for (const ArchiveBlockInfo& info : directory) {
+            if (info.maxDay < fromDay || info.minDay > toDay) {
+                continue;
+            }
+            visited++;
+            block.rows = info.rows;
+            for (int c = 0; c < archiveColumnCount; ++c) {
+                if ((columns & (1u << c)) == 0) {
+                    continue;
+                }
+                bytes.resize(info.columnLength[c]);
+                in.seekg(static_cast<std::streamoff>(info.columnOffset[c]));
+                in.read(&bytes[0], static_cast<std::streamsize>(bytes.size()));
+                decodeColumn(c, bytes, info.rows, block);
+            }
+            function(static_cast<const ArchiveBlock&>(block));
+        }
+        return visited;
+    }
+
+private:
+    /**
+     * @brief Decodes one column of a block into the matching vector of the block.
+     */
+    static void decodeColumn(int column, const std::string& bytes, size_t rows, ArchiveBlock& block) {
+        const char* cursor = bytes.data();
+        const char* end = bytes.data() + bytes.size();
+        switch (1u << column) {
+        case ColumnDay:
+            decodeDeltas(cursor, end, rows, block.day);
+            break;
+        case ColumnVehicle:
+            decodeDeltas(cursor, end, rows, block.vehicleID);
+            break;
+        case ColumnSource:
+            block.source.assign(bytes.begin(), bytes.begin() + std::min(rows, bytes.size()));
+            break;
+        case ColumnAmount:
+            block.amount.resize(std::min(rows, bytes.size() / sizeof(float)));
+            std::memcpy(block.amount.data(), bytes.data(), block.amount.size() * sizeof(float));
+            break;
+        case ColumnType:
+            decodeCodes(cursor, end, rows, block.type);
+            break;
+        case ColumnModel:
+            decodeCodes(cursor, end, rows, block.model);
+            break;
+        case ColumnCustomer:
+            decodeCodes(cursor, end, rows, block.customer);
+            break;
+        }
+    }
+
+    static void decodeDeltas(const char* cursor, const char* end, size_t rows, std::vector<int32_t>& values) {
+        values.clear();
+        int64_t value = 0;
+        uint64_t delta;
+        while (values.size() < rows && readVarint(cursor, end, delta)) {
+            value += zigzagDecode(delta);
+            values.push_back(static_cast<int32_t>(value));
+        }
+    }
+
+    static void decodeCodes(const char* cursor, const char* end, size_t rows, std::vector<uint32_t>& values) {
+        values.clear();
+        uint64_t code;
+        while (values.size() < rows && readVarint(cursor, end, code)) {
+            values.push_back(static_cast<uint32_t>(code));
+        }
+    }
+
+    std::ifstream in;                                           ///< The archive file.
+    ArchiveHeader header = {};                                  ///< Header of the archive.
+    std::vector<std::string> dictionaries[archiveDictionaryCount]; ///< Type, model and customer dictionaries.
+    std::vector<ArchiveBlockInfo> directory;                    ///< Block directory.
+};
+
+#endif // COLUMN_ARCHIVE_H
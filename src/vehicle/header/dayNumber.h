@@ -0,0 +1,156 @@
+/**
+ * @file dayNumber.h
+ *
+ * @brief Provides conversions between calendar dates and consecutive day numbers, and a date type built on them
+ */
+
+#ifndef DAY_NUMBER_H
+#define DAY_NUMBER_H
+
+#include <cstdint>
+
+/**
+ * @brief Returns the number of days from 1970-01-01 to a date of the proleptic Gregorian calendar.
+ *
+ * @param year The year.
+ * @param month The month, 1 to 12.
+ * @param day The day of the month.
+ * @return int32_t Days since 1970-01-01, negative before it.
+ */
+constexpr int32_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief Converts a day number back to its calendar date.
+ *
+ * @param days Days since 1970-01-01.
+ * @param year Receives the year.
+ * @param month Receives the month, 1 to 12.
+ * @param day Receives the day of the month.
+ */
+constexpr void civilFromDays(int32_t days, int& year, int& month, int& day) {
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    int dayOfEra = days - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = yearOfEra + era * 400 + (month <= 2);
+}
+
+/**
+ * @brief Returns whether a year of the proleptic Gregorian calendar has 29 February.
+ */
+constexpr bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * @brief Returns the number of days of a month, or 0 for a month outside 1 to 12.
+ */
+constexpr int daysInMonth(int year, int month) {
+    if (month < 1 || month > 12) {
+        return 0;
+    }
+    if (month == 2) {
+        return isLeapYear(year) ? 29 : 28;
+    }
+    return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+}
+
+/**
+ * @brief Returns whether year, month and day name a day that exists.
+ */
+constexpr bool isValidCivil(int year, int month, int day) {
+    return day >= 1 && day <= daysInMonth(year, month);
+}
+
+/**
+ * @class CalendarDay
+ * @brief Calendar date held as its day number, so comparing and stepping dates is integer arithmetic.
+ *
+ * Whole months and years are added on the calendar: the day of the month is
+ * kept where the target month has it and clamped to the month's last day
+ * otherwise, so one month after 31 January is the last day of February.
+ */
+class CalendarDay {
+public:
+    /**
+     * @brief Creates the day with the given day number; the default is 1970-01-01.
+     */
+    constexpr explicit CalendarDay(int32_t days = 0) : days(days) {}
+
+    /**
+     * @brief Returns the day of a calendar date; the date must be valid.
+     */
+    static constexpr CalendarDay fromCivil(int year, int month, int day) {
+        return CalendarDay(daysFromCivil(year, month, day));
+    }
+
+    /**
+     * @brief Returns the day number, as returned by daysFromCivil.
+     */
+    constexpr int32_t number() const {
+        return days;
+    }
+
+    /**
+     * @brief Converts the day to its calendar date.
+     */
+    constexpr void toCivil(int& year, int& month, int& day) const {
+        civilFromDays(days, year, month, day);
+    }
+
+    /**
+     * @brief Returns the day a given number of days later, or earlier for a negative count.
+     */
+    constexpr CalendarDay addDays(int32_t count) const {
+        return CalendarDay(days + count);
+    }
+
+    /**
+     * @brief Returns the same day of the month a given number of months later, clamped to the month's end.
+     */
+    constexpr CalendarDay addMonths(int count) const {
+        int year = 0;
+        int month = 0;
+        int day = 0;
+        toCivil(year, month, day);
+        int monthIndex = year * 12 + (month - 1) + count;
+        year = (monthIndex >= 0 ? monthIndex : monthIndex - 11) / 12;
+        month = monthIndex - year * 12 + 1;
+        int lastDay = daysInMonth(year, month);
+        return fromCivil(year, month, day < lastDay ? day : lastDay);
+    }
+
+    /**
+     * @brief Returns the same day a given number of years later; 29 February becomes 28 February outside leap years.
+     */
+    constexpr CalendarDay addYears(int count) const {
+        return addMonths(count * 12);
+    }
+
+    friend constexpr int32_t operator-(CalendarDay a, CalendarDay b) { return a.days - b.days; }
+    friend constexpr bool operator==(CalendarDay a, CalendarDay b) { return a.days == b.days; }
+    friend constexpr bool operator!=(CalendarDay a, CalendarDay b) { return a.days != b.days; }
+    friend constexpr bool operator<(CalendarDay a, CalendarDay b) { return a.days < b.days; }
+    friend constexpr bool operator<=(CalendarDay a, CalendarDay b) { return a.days <= b.days; }
+    friend constexpr bool operator>(CalendarDay a, CalendarDay b) { return a.days > b.days; }
+    friend constexpr bool operator>=(CalendarDay a, CalendarDay b) { return a.days >= b.days; }
+
+private:
+    int32_t days;       ///< Days since 1970-01-01.
+};
+
+static_assert(CalendarDay::fromCivil(2024, 1, 31).addMonths(1) == CalendarDay::fromCivil(2024, 2, 29), "month steps clamp to the month's end");
+static_assert(CalendarDay::fromCivil(2023, 12, 14).addMonths(1) == CalendarDay::fromCivil(2024, 1, 14), "month steps carry into the year");
+
+#endif // DAY_NUMBER_H
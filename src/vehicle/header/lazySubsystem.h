@@ -0,0 +1,201 @@
+/**
+ * @file lazySubsystem.h
+ *
+ * @brief Provides subsystems loaded on first access and a thread that loads them ahead of use
+ */
+
+#ifndef LAZY_SUBSYSTEM_H
+#define LAZY_SUBSYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Set on the thread of a Prefetcher, so loads can tell where they ran.
+ */
+inline thread_local bool onPrefetchThread = false;
+
+/**
+ * @class LazySubsystem
+ * @brief Data set that is loaded once, by whichever thread needs it first.
+ *
+ * ensure() runs the load on the first call and returns at once afterwards. A
+ * caller arriving while another thread is loading waits for that load. The time
+ * the load took and the time callers outside the prefetch thread spent waiting
+ * for it are kept for the startup timing report.
+ */
+class LazySubsystem {
+public:
+    /**
+     * @brief Creates an unloaded subsystem; the name must outlive it.
+     */
+    explicit LazySubsystem(const char* name) : subsystemName(name) {}
+
+    LazySubsystem(const LazySubsystem&) = delete;
+    LazySubsystem& operator=(const LazySubsystem&) = delete;
+
+    /**
+     * @brief Loads the subsystem unless it is loaded already.
+     *
+     * @param load Called once, on the first call of any thread.
+     */
+    template <typename Load>
+    void ensure(Load load) {
+        if (loaded.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::call_once(once, [&]() {
+            load();
+            loadNanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            background = onPrefetchThread;
+            loaded.store(true, std::memory_order_release);
+        });
+
+        if (!onPrefetchThread) {
+            waitNanoseconds.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
+    }
+
+    /**
+     * @brief Returns whether the load has finished.
+     */
+    bool isLoaded() const {
+        return loaded.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the name given at construction.
+     */
+    const char* name() const {
+        return subsystemName;
+    }
+
+    /**
+     * @brief Returns how long the load took, or 0 before it finished.
+     */
+    double loadMilliseconds() const {
+        return isLoaded() ? loadNanoseconds / 1e6 : 0.0;
+    }
+
+    /**
+     * @brief Returns whether the load ran on the prefetch thread.
+     */
+    bool loadedInBackground() const {
+        return isLoaded() && background;
+    }
+
+    /**
+     * @brief Returns how long callers outside the prefetch thread were blocked by the load.
+     */
+    double waitMilliseconds() const {
+        return waitNanoseconds.load() / 1e6;
+    }
+
+private:
+    const char* subsystemName;                      ///< Name shown in reports.
+    std::once_flag once;                            ///< Guards the single load.
+    std::atomic<bool> loaded{ false };              ///< Set once the load has finished.
+    uint64_t loadNanoseconds = 0;                   ///< Duration of the load; published by loaded.
+    bool background = false;                        ///< Whether the prefetch thread loaded it; published by loaded.
+    std::atomic<uint64_t> waitNanoseconds{ 0 };     ///< Total time callers outside the prefetch thread spent in ensure().
+};
+
+/**
+ * @class Prefetcher
+ * @brief Background thread that runs hinted loads one at a time.
+ *
+ * Hints are run in the order given, except that urgent hints go ahead of the
+ * waiting ones. Hints given before start() wait for the thread. stop() drops the
+ * hints that have not started and waits for the running one.
+ */
+class Prefetcher {
+public:
+    Prefetcher() = default;
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    ~Prefetcher() {
+        stop();
+    }
+
+    /**
+     * @brief Starts the thread; does nothing while it is running.
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (worker.joinable()) {
+            return;
+        }
+        stopping = false;
+        worker = std::thread([this]() { run(); });
+    }
+
+    /**
+     * @brief Queues a load for the thread.
+     *
+     * @param task The load.
+     * @param urgent Whether to run it before the hints already waiting.
+     */
+    void hint(std::function<void()> task, bool urgent = false) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (urgent) {
+                tasks.push_front(std::move(task));
+            }
+            else {
+                tasks.push_back(std::move(task));
+            }
+        }
+        signal.notify_one();
+    }
+
+    /**
+     * @brief Drops the waiting hints and joins the thread.
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            tasks.clear();
+        }
+        signal.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+private:
+    void run() {
+        onPrefetchThread = true;
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                signal.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (stopping) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex;                           ///< Guards tasks and stopping.
+    std::condition_variable signal;             ///< Wakes the thread for a hint or the stop request.
+    std::deque<std::function<void()>> tasks;    ///< Waiting hints, next first.
+    bool stopping = false;                      ///< Set by stop().
+    std::thread worker;                         ///< The prefetch thread.
+};
+
+#endif // LAZY_SUBSYSTEM_H
@@ -0,0 +1,375 @@
+/**
+ * @file lzSegment.h
+ *
+ * @brief Provides a small LZ77 block codec and compressed, read-only segment files
+ */
+
+#ifndef LZ_SEGMENT_H
+#define LZ_SEGMENT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+/*
+ * Compressed blocks are a sequence of LZ77 commands in the layout popularized by LZ4:
+ *
+ *  token      high nibble: literal count, low nibble: match length - 4;
+ *             a nibble of 15 is continued by bytes of 255 and a final smaller byte
+ *  literals   copied as they are
+ *  offset     2 bytes, little endian, distance back to the match
+ *
+ * The last command carries literals only and ends the block.
+ *
+ * A segment file is a header, the compressed length of every block, and the
+ * blocks. Every block but the last decompresses to the block size of the header,
+ * so any byte range of the original file can be read by decompressing only the
+ * blocks that hold it.
+ *
+ * Files of fixed-width records are stored with a stride: before compression the
+ * records of a block are transposed so that byte i of every record comes before
+ * byte i + 1 of any. A field that changes little from one record to the next then
+ * becomes a long run, which LZ77 matches far better than the interleaved records.
+ */
+
+const size_t lzMinMatch = 4;                    ///< Shortest match worth encoding.
+const size_t lzMaxOffset = 65535;               ///< Longest distance a match may reach back.
+const int lzHashBits = 14;                      ///< Size of the match finder table, as a power of two.
+const size_t lzSegmentBlockSize = 1 << 16;      ///< Uncompressed bytes per segment block, rounded down to whole records.
+const char lzSegmentMagic[8] = "VSEG001";       ///< Identifies a segment file.
+
+/**
+ * @struct LzSegmentHeader
+ * @brief Fixed header at the start of a segment file.
+ */
+struct LzSegmentHeader {
+    char magic[8];              ///< lzSegmentMagic.
+    uint64_t rawSize;           ///< Size of the original file.
+    uint64_t blockCount;        ///< Number of blocks.
+    uint32_t blockSize;         ///< Uncompressed bytes per block.
+    uint32_t stride;            ///< Record size the blocks are transposed by, 1 when they are not.
+};
+
+/**
+ * @brief Appends a length continued in bytes of 255, as used by both nibbles of a token.
+ */
+inline void lzAppendLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+/**
+ * @brief Compresses a block with greedy LZ77 matching against the last position of every hashed 4-byte sequence.
+ *
+ * @param input Bytes to compress.
+ * @param out Receives the compressed block, appended.
+ */
+inline void lzCompress(std::string_view input, std::string& out) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+    size_t size = input.size();
+    std::vector<uint32_t> table(size_t(1) << lzHashBits, UINT32_MAX);
+    auto hashAt = [data](size_t position) {
+        uint32_t value;
+        std::memcpy(&value, data + position, sizeof(value));
+        return (value * 2654435761u) >> (32 - lzHashBits);
+    };
+
+    auto emit = [&](size_t literalStart, size_t literalCount, size_t matchLength, size_t offset) {
+        size_t matchCode = matchLength >= lzMinMatch ? matchLength - lzMinMatch : 0;
+        out.push_back(static_cast<char>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (literalCount >= 15) {
+            lzAppendLength(out, literalCount - 15);
+        }
+        out.append(input.data() + literalStart, literalCount);
+        if (matchLength >= lzMinMatch) {
+            out.push_back(static_cast<char>(offset & 0xFF));
+            out.push_back(static_cast<char>(offset >> 8));
+            if (matchCode >= 15) {
+                lzAppendLength(out, matchCode - 15);
+            }
+        }
+    };
+
+    size_t literalStart = 0;
+    size_t position = 0;
+    while (position + lzMinMatch <= size) {
+        uint32_t hash = hashAt(position);
+        size_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(position);
+
+        if (candidate != UINT32_MAX && position - candidate <= lzMaxOffset && std::memcmp(data + candidate, data + position, lzMinMatch) == 0) {
+            size_t length = lzMinMatch;
+            while (position + length < size && data[candidate + length] == data[position + length]) {
+                length++;
+            }
+            emit(literalStart, position - literalStart, length, position - candidate);
+            position += length;
+            literalStart = position;
+        }
+        else {
+            position++;
+        }
+    }
+    emit(literalStart, size - literalStart, 0, 0);
+}
+
+/**
+ * @brief Reads a length continued in bytes of 255.
+ */
+inline bool lzReadLength(const uint8_t*& cursor, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (cursor >= end) {
+            return false;
+        }
+        byte = *cursor++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/**
+ * @brief Decompresses a block produced by lzCompress.
+ *
+ * @param input The compressed block.
+ * @param out Receives the original bytes, appended.
+ * @return true if the block was well formed.
+ */
+inline bool lzDecompress(std::string_view input, std::string& out) {
+    const uint8_t* cursor = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* end = cursor + input.size();
+    size_t base = out.size();
+
+    while (cursor < end) {
+        uint8_t token = *cursor++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !lzReadLength(cursor, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(end - cursor)) {
+            return false;
+        }
+        out.append(reinterpret_cast<const char*>(cursor), literalCount);
+        cursor += literalCount;
+        if (cursor == end) {
+            return true;
+        }
+
+        if (end - cursor < 2) {
+            return false;
+        }
+        size_t offset = cursor[0] | (static_cast<size_t>(cursor[1]) << 8);
+        cursor += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !lzReadLength(cursor, end, matchLength)) {
+            return false;
+        }
+        matchLength += lzMinMatch;
+        if (offset == 0 || offset > out.size() - base) {
+            return false;
+        }
+
+        size_t position = out.size();
+        out.resize(position + matchLength);
+        char* target = &out[position];
+        if (offset >= matchLength) {
+            std::memcpy(target, target - offset, matchLength);
+        }
+        else {
+            // Byte by byte, since the match overlaps the bytes it produces
+            const char* source = target - offset;
+            for (size_t i = 0; i < matchLength; ++i) {
+                target[i] = source[i];
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Transposes the whole records of a block; bytes after the last whole record stay in place.
+ *
+ * @param block The block.
+ * @param stride Record size.
+ * @param forward true to group the bytes by position, false to restore the records.
+ * @return std::string The transposed block.
+ */
+inline std::string lzTransposeBlock(std::string_view block, size_t stride, bool forward) {
+    std::string out(block);
+    size_t records = block.size() / stride;
+    const char* source = block.data();
+    char* target = &out[0];
+    // Both loops write sequentially; the strided side is the one read
+    if (forward) {
+        for (size_t byte = 0; byte < stride; ++byte) {
+            for (size_t record = 0; record < records; ++record) {
+                *target++ = source[record * stride + byte];
+            }
+        }
+    }
+    else {
+        for (size_t record = 0; record < records; ++record) {
+            for (size_t byte = 0; byte < stride; ++byte) {
+                *target++ = source[byte * records + record];
+            }
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Writes bytes as a compressed segment file.
+ *
+ * The segment is written under a temporary name and renamed into place.
+ *
+ * @param path Path of the segment.
+ * @param raw The bytes to store.
+ * @param stride Size of the records the bytes consist of, or 1.
+ * @return true on success.
+ */
+inline bool writeLzSegment(const std::string& path, std::string_view raw, size_t stride = 1) {
+    LzSegmentHeader header = {};
+    std::copy(lzSegmentMagic, lzSegmentMagic + 8, header.magic);
+    header.rawSize = raw.size();
+    header.stride = static_cast<uint32_t>(std::max<size_t>(stride, 1));
+    header.blockSize = static_cast<uint32_t>(std::max<size_t>(lzSegmentBlockSize / header.stride, 1) * header.stride);
+    header.blockCount = (raw.size() + header.blockSize - 1) / header.blockSize;
+
+    std::vector<uint32_t> lengths;
+    std::string blocks;
+    for (size_t start = 0; start < raw.size(); start += header.blockSize) {
+        size_t before = blocks.size();
+        std::string_view block = raw.substr(start, header.blockSize);
+        if (header.stride > 1) {
+            lzCompress(lzTransposeBlock(block, header.stride, true), blocks);
+        }
+        else {
+            lzCompress(block, blocks);
+        }
+        lengths.push_back(static_cast<uint32_t>(blocks.size() - before));
+    }
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(lengths.data()), static_cast<std::streamsize>(lengths.size() * sizeof(uint32_t)));
+        out.write(blocks.data(), static_cast<std::streamsize>(blocks.size()));
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    return !error;
+}
+
+/**
+ * @class LzSegmentReader
+ * @brief Reads byte ranges of a compressed segment file.
+ */
+class LzSegmentReader {
+public:
+    /**
+     * @brief Opens a segment file and reads its block table.
+     *
+     * @param path Path of the segment.
+     * @return true if the file is a segment.
+     */
+    bool open(const std::string& path) {
+        in.close();
+        in.clear();
+        in.open(path, std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::string_view(header.magic, 8) != std::string_view(lzSegmentMagic, 8)
+            || header.stride == 0 || header.blockSize == 0) {
+            return false;
+        }
+
+        std::vector<uint32_t> lengths(static_cast<size_t>(header.blockCount));
+        in.read(reinterpret_cast<char*>(lengths.data()), static_cast<std::streamsize>(lengths.size() * sizeof(uint32_t)));
+        offsets.assign(1, sizeof(header) + lengths.size() * sizeof(uint32_t));
+        for (uint32_t length : lengths) {
+            offsets.push_back(offsets.back() + length);
+        }
+        return static_cast<bool>(in);
+    }
+
+    /**
+     * @brief Returns the size of the original file.
+     */
+    uint64_t rawSize() const {
+        return header.rawSize;
+    }
+
+    /**
+     * @brief Reads a byte range of the original file, decompressing only the blocks holding it.
+     *
+     * @param offset First byte of the range.
+     * @param length Length of the range.
+     * @param out Receives the bytes, replacing its contents.
+     * @return true if the whole range was read.
+     */
+    bool read(uint64_t offset, uint64_t length, std::string& out) {
+        out.clear();
+        if (offset + length > header.rawSize) {
+            return false;
+        }
+        std::string compressed;
+        std::string block;
+        for (uint64_t index = offset / header.blockSize; out.size() < length; ++index) {
+            if (!readBlock(index, compressed, block)) {
+                return false;
+            }
+            uint64_t blockStart = index * header.blockSize;
+            uint64_t from = std::max(offset, blockStart) - blockStart;
+            uint64_t count = std::min<uint64_t>(block.size() - from, length - out.size());
+            out.append(block, static_cast<size_t>(from), static_cast<size_t>(count));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads the whole original file.
+     *
+     * @param out Receives the bytes, replacing its contents.
+     * @return true on success.
+     */
+    bool readAll(std::string& out) {
+        return read(0, header.rawSize, out);
+    }
+
+private:
+    bool readBlock(uint64_t index, std::string& compressed, std::string& block) {
+        if (index + 1 >= offsets.size()) {
+            return false;
+        }
+        compressed.resize(static_cast<size_t>(offsets[index + 1] - offsets[index]));
+        in.seekg(static_cast<std::streamoff>(offsets[index]));
+        if (!in.read(&compressed[0], static_cast<std::streamsize>(compressed.size()))) {
+            return false;
+        }
+        block.clear();
+        if (!lzDecompress(compressed, block)) {
+            return false;
+        }
+        if (header.stride > 1) {
+            block = lzTransposeBlock(block, header.stride, false);
+        }
+        return true;
+    }
+
+    std::ifstream in;                   ///< The segment file.
+    LzSegmentHeader header = {};        ///< Header of the segment.
+    std::vector<uint64_t> offsets;      ///< File offset of every block, followed by the end of the last.
+};
+
+#endif // LZ_SEGMENT_H
@@ -0,0 +1,442 @@
+/**
+ * @file metrics.h
+ *
+ * @brief Provides scoped timers, counters and their Prometheus and JSON export
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Maximum number of distinct timers and counters.
+ */
+const int maxMetrics = 64;
+
+/**
+ * @brief Number of histogram buckets; bucket b holds durations below 2^b nanoseconds.
+ */
+const int metricBuckets = 40;
+
+/**
+ * @enum MetricKind
+ * @brief Distinguishes duration histograms from plain counters.
+ */
+enum class MetricKind {
+    Timer,
+    Counter
+};
+
+/**
+ * @enum MetricsFormat
+ * @brief Output formats of dumpMetrics.
+ */
+enum class MetricsFormat {
+    Prometheus,
+    Json
+};
+
+/**
+ * @struct ThreadMetrics
+ * @brief Histogram and counter cells of one thread.
+ *
+ * Only the owning thread writes the cells, so an update is a relaxed load and
+ * store without a locked instruction. Readers sum the cells of every block.
+ */
+struct ThreadMetrics {
+    std::atomic<uint64_t> buckets[maxMetrics][metricBuckets] = {}; ///< Per timer sample counts by bucket.
+    std::atomic<uint64_t> sums[maxMetrics] = {};                   ///< Timer nanoseconds, or counter values.
+    bool inUse = false;                                            ///< Whether a live thread owns the block.
+};
+
+/**
+ * @struct MetricsRegistry
+ * @brief Names of the registered metrics and the blocks of all threads.
+ *
+ * The mutex is taken when a metric is first registered and when a thread first
+ * records, never on the recording path itself. Blocks of finished threads are kept,
+ * so their samples stay in the totals, and are handed to the next new thread.
+ */
+struct MetricsRegistry {
+    std::mutex mutex;                                   ///< Guards names, kinds and blocks.
+    std::vector<std::string> names;                     ///< Metric names by ID.
+    std::vector<MetricKind> kinds;                      ///< Metric kinds by ID.
+    std::vector<std::unique_ptr<ThreadMetrics>> blocks; ///< Blocks of current and finished threads.
+};
+
+/**
+ * @struct MetricSnapshot
+ * @brief Totals of one metric summed over all threads.
+ */
+struct MetricSnapshot {
+    std::string name;                  ///< Registered name.
+    MetricKind kind;                   ///< Timer or counter.
+    uint64_t count = 0;                ///< Number of timed calls; 0 for counters.
+    uint64_t sum = 0;                  ///< Total nanoseconds, or the counter value.
+    uint64_t buckets[metricBuckets] = {}; ///< Non-cumulative bucket counts of a timer.
+};
+
+/**
+ * @brief Returns the process wide registry.
+ *
+ * The registry is never destroyed, so threads finishing after main() returns can still release their block.
+ *
+ * @return MetricsRegistry& The registry.
+ */
+inline MetricsRegistry& metricsRegistry() {
+    static MetricsRegistry* registry = new MetricsRegistry;
+    return *registry;
+}
+
+/**
+ * @brief Registers a metric, or finds the one already registered under the same name.
+ *
+ * @param name Metric name.
+ * @param kind Timer or counter.
+ * @return int The metric ID, or -1 if maxMetrics are already registered.
+ */
+inline int registerMetric(const char* name, MetricKind kind) {
+    MetricsRegistry& registry = metricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (size_t i = 0; i < registry.names.size(); ++i) {
+        if (registry.names[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    if (static_cast<int>(registry.names.size()) >= maxMetrics) {
+        return -1;
+    }
+    registry.names.push_back(name);
+    registry.kinds.push_back(kind);
+    return static_cast<int>(registry.names.size()) - 1;
+}
+
+/**
+ * @class ThreadMetricsHandle
+ * @brief Claims a block for the current thread and releases it when the thread ends.
+ */
+class ThreadMetricsHandle {
+public:
+    /**
+     * @brief Takes a released block or adds a new one.
+     */
+    ThreadMetricsHandle() {
+        MetricsRegistry& registry = metricsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& block : registry.blocks) {
+            if (!block->inUse) {
+                metrics = block.get();
+                break;
+            }
+        }
+        if (metrics == nullptr) {
+            registry.blocks.push_back(std::make_unique<ThreadMetrics>());
+            metrics = registry.blocks.back().get();
+        }
+        metrics->inUse = true;
+    }
+
+    /**
+     * @brief Releases the block; its samples stay in the totals.
+     */
+    ~ThreadMetricsHandle() {
+        std::lock_guard<std::mutex> lock(metricsRegistry().mutex);
+        metrics->inUse = false;
+    }
+
+    ThreadMetricsHandle(const ThreadMetricsHandle&) = delete;
+    ThreadMetricsHandle& operator=(const ThreadMetricsHandle&) = delete;
+
+    ThreadMetrics* metrics = nullptr; ///< Block owned by the current thread.
+};
+
+/**
+ * @brief Returns the block of the current thread.
+ *
+ * @return ThreadMetrics& The block.
+ */
+inline ThreadMetrics& threadMetrics() {
+    thread_local ThreadMetricsHandle handle;
+    return *handle.metrics;
+}
+
+/**
+ * @brief Adds to a cell owned by the current thread.
+ *
+ * @param cell The cell.
+ * @param amount Amount to add.
+ */
+inline void addToCell(std::atomic<uint64_t>& cell, uint64_t amount) {
+    cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Maps a duration to its histogram bucket.
+ *
+ * @param nanoseconds The duration.
+ * @return int Number of significant bits, capped to the last bucket.
+ */
+inline int metricBucket(uint64_t nanoseconds) {
+    if (nanoseconds == 0) {
+        return 0;
+    }
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, nanoseconds);
+    int bits = static_cast<int>(index) + 1;
+#else
+    int bits = 64 - __builtin_clzll(nanoseconds);
+#endif
+    return bits < metricBuckets ? bits : metricBuckets - 1;
+}
+
+/**
+ * @brief Records one timed call.
+ *
+ * @param id Timer ID from registerMetric.
+ * @param nanoseconds Duration of the call.
+ */
+inline void recordDuration(int id, uint64_t nanoseconds) {
+    if (id < 0) {
+        return;
+    }
+    ThreadMetrics& metrics = threadMetrics();
+    addToCell(metrics.buckets[id][metricBucket(nanoseconds)], 1);
+    addToCell(metrics.sums[id], nanoseconds);
+}
+
+/**
+ * @brief Adds to a counter.
+ *
+ * @param id Counter ID from registerMetric.
+ * @param amount Amount to add.
+ */
+inline void addToCounter(int id, uint64_t amount) {
+    if (id < 0) {
+        return;
+    }
+    addToCell(threadMetrics().sums[id], amount);
+}
+
+/**
+ * @class ScopedTimer
+ * @brief Records the lifetime of a scope into a timer.
+ */
+class ScopedTimer {
+public:
+    /**
+     * @brief Starts timing.
+     *
+     * @param id Timer ID from registerMetric.
+     */
+    explicit ScopedTimer(int id) : id(id), start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Records the elapsed time.
+     */
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        recordDuration(id, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    int id;                                       ///< Timer ID.
+    std::chrono::steady_clock::time_point start;  ///< Start of the scope.
+};
+
+#define METRICS_CONCAT_INNER(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_VEHICLE_METRICS
+/**
+ * @brief Times the rest of the enclosing scope under the given name.
+ */
+#define VEHICLE_TIMED(name) \
+    static const int METRICS_CONCAT(metricId, __LINE__) = registerMetric(name, MetricKind::Timer); \
+    ScopedTimer METRICS_CONCAT(metricTimer, __LINE__)(METRICS_CONCAT(metricId, __LINE__))
+
+/**
+ * @brief Adds an amount to the counter with the given name.
+ */
+#define VEHICLE_COUNT(name, amount) \
+    do { \
+        static const int metricId = registerMetric(name, MetricKind::Counter); \
+        addToCounter(metricId, static_cast<uint64_t>(amount)); \
+    } while (0)
+#else
+#define VEHICLE_TIMED(name) ((void)0)
+#define VEHICLE_COUNT(name, amount) ((void)0)
+#endif
+
+/**
+ * @brief Sums every registered metric over all threads.
+ *
+ * @return std::vector<MetricSnapshot> Totals in registration order.
+ */
+inline std::vector<MetricSnapshot> collectMetrics() {
+    MetricsRegistry& registry = metricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<MetricSnapshot> snapshots(registry.names.size());
+    for (size_t id = 0; id < snapshots.size(); ++id) {
+        MetricSnapshot& snapshot = snapshots[id];
+        snapshot.name = registry.names[id];
+        snapshot.kind = registry.kinds[id];
+        for (const auto& block : registry.blocks) {
+            snapshot.sum += block->sums[id].load(std::memory_order_relaxed);
+            if (snapshot.kind == MetricKind::Timer) {
+                for (int bucket = 0; bucket < metricBuckets; ++bucket) {
+                    uint64_t samples = block->buckets[id][bucket].load(std::memory_order_relaxed);
+                    snapshot.buckets[bucket] += samples;
+                    snapshot.count += samples;
+                }
+            }
+        }
+    }
+    return snapshots;
+}
+
+/**
+ * @brief Clears all samples and counter values. Names stay registered.
+ */
+inline void resetMetrics() {
+    MetricsRegistry& registry = metricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& block : registry.blocks) {
+        for (int id = 0; id < maxMetrics; ++id) {
+            block->sums[id].store(0, std::memory_order_relaxed);
+            for (int bucket = 0; bucket < metricBuckets; ++bucket) {
+                block->buckets[id][bucket].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Upper bound of a histogram bucket in seconds.
+ *
+ * @param bucket The bucket.
+ * @return double 2^bucket nanoseconds in seconds.
+ */
+inline double metricBucketBound(int bucket) {
+    return static_cast<double>(uint64_t(1) << bucket) / 1e9;
+}
+
+/**
+ * @brief Writes all metrics in the Prometheus text exposition format.
+ *
+ * Timers become the histogram vehicle_call_duration_seconds labelled by function,
+ * counters become vehicle_events_total labelled by event.
+ *
+ * @param out The output stream.
+ */
+inline void writeMetricsPrometheus(std::ostream& out) {
+    std::vector<MetricSnapshot> snapshots = collectMetrics();
+
+    out << "# HELP vehicle_call_duration_seconds Duration of vehicle library calls.\n";
+    out << "# TYPE vehicle_call_duration_seconds histogram\n";
+    for (const MetricSnapshot& snapshot : snapshots) {
+        if (snapshot.kind != MetricKind::Timer) {
+            continue;
+        }
+        uint64_t cumulative = 0;
+        for (int bucket = 0; bucket < metricBuckets - 1; ++bucket) {
+            cumulative += snapshot.buckets[bucket];
+            out << "vehicle_call_duration_seconds_bucket{function=\"" << snapshot.name << "\",le=\"" << metricBucketBound(bucket) << "\"} " << cumulative << "\n";
+        }
+        out << "vehicle_call_duration_seconds_bucket{function=\"" << snapshot.name << "\",le=\"+Inf\"} " << snapshot.count << "\n";
+        out << "vehicle_call_duration_seconds_sum{function=\"" << snapshot.name << "\"} " << snapshot.sum / 1e9 << "\n";
+        out << "vehicle_call_duration_seconds_count{function=\"" << snapshot.name << "\"} " << snapshot.count << "\n";
+    }
+
+    out << "# HELP vehicle_events_total Records and items processed by the vehicle library.\n";
+    out << "# TYPE vehicle_events_total counter\n";
+    for (const MetricSnapshot& snapshot : snapshots) {
+        if (snapshot.kind == MetricKind::Counter) {
+            out << "vehicle_events_total{event=\"" << snapshot.name << "\"} " << snapshot.sum << "\n";
+        }
+    }
+}
+
+/**
+ * @brief Writes all metrics as a JSON document.
+ *
+ * Bucket bounds are given in nanoseconds and only non-empty buckets are listed.
+ *
+ * @param out The output stream.
+ */
+inline void writeMetricsJson(std::ostream& out) {
+    std::vector<MetricSnapshot> snapshots = collectMetrics();
+
+    out << "{\n  \"timers\": [";
+    bool first = true;
+    for (const MetricSnapshot& snapshot : snapshots) {
+        if (snapshot.kind != MetricKind::Timer) {
+            continue;
+        }
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "    {\"name\": \"" << snapshot.name << "\", \"count\": " << snapshot.count << ", \"sum_ns\": " << snapshot.sum << ", \"buckets\": [";
+        bool firstBucket = true;
+        for (int bucket = 0; bucket < metricBuckets; ++bucket) {
+            if (snapshot.buckets[bucket] == 0) {
+                continue;
+            }
+            out << (firstBucket ? "" : ", ");
+            firstBucket = false;
+            out << "{\"le_ns\": " << (uint64_t(1) << bucket) << ", \"count\": " << snapshot.buckets[bucket] << "}";
+        }
+        out << "]}";
+    }
+    out << (first ? "],\n" : "\n  ],\n");
+
+    out << "  \"counters\": [";
+    first = true;
+    for (const MetricSnapshot& snapshot : snapshots) {
+        if (snapshot.kind != MetricKind::Counter) {
+            continue;
+        }
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "    {\"name\": \"" << snapshot.name << "\", \"value\": " << snapshot.sum << "}";
+    }
+    out << (first ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+/**
+ * @brief Writes all metrics to a file, replacing its content.
+ *
+ * @param fileName Path of the file.
+ * @param format Prometheus text or JSON.
+ * @return bool true if the file could be written.
+ */
+inline bool dumpMetrics(const char* fileName, MetricsFormat format) {
+    std::ofstream file(fileName, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    if (format == MetricsFormat::Prometheus) {
+        writeMetricsPrometheus(file);
+    }
+    else {
+        writeMetricsJson(file);
+    }
+    return static_cast<bool>(file);
+}
+
+#endif // METRICS_H
@@ -0,0 +1,200 @@
+/**
+ * @file modelName.h
+ *
+ * @brief Provides interned vehicle model names
+ */
+
+#ifndef MODEL_NAME_H
+#define MODEL_NAME_H
+
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @struct ModelSymbolTable
+ * @brief Process wide table mapping model names to 32-bit IDs and back.
+ *
+ * Names are never removed, so an ID stays valid for the lifetime of the process.
+ * The deque keeps every name at a stable address, which lets the lookup map key on views of them.
+ */
+struct ModelSymbolTable {
+    std::shared_mutex mutex;                              ///< Guards ids and names.
+    std::unordered_map<std::string_view, uint32_t> ids;   ///< ID of every interned name.
+    std::deque<std::string> names;                        ///< Interned names by ID.
+};
+
+/**
+ * @brief Returns the model symbol table, with the empty name interned as ID 0.
+ *
+ * The table is never destroyed, so model names stay readable during static destruction.
+ *
+ * @return ModelSymbolTable& The table.
+ */
+inline ModelSymbolTable& modelSymbols() {
+    static ModelSymbolTable* table = [] {
+        ModelSymbolTable* created = new ModelSymbolTable;
+        created->names.emplace_back();
+        created->ids.emplace(created->names.back(), 0);
+        return created;
+    }();
+    return *table;
+}
+
+/**
+ * @brief Returns the ID of a model name, interning the name on first use.
+ *
+ * @param name The model name.
+ * @return uint32_t The ID of the name.
+ */
+inline uint32_t internModel(std::string_view name) {
+    ModelSymbolTable& table = modelSymbols();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto found = table.ids.find(name);
+        if (found != table.ids.end()) {
+            return found->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    auto found = table.ids.find(name);
+    if (found != table.ids.end()) {
+        return found->second;
+    }
+    uint32_t id = static_cast<uint32_t>(table.names.size());
+    table.names.emplace_back(name);
+    table.ids.emplace(table.names.back(), id);
+    return id;
+}
+
+/**
+ * @class ModelName
+ * @brief Vehicle model name stored as the 32-bit ID of its interned text.
+ *
+ * Two model names are equal exactly when their IDs are equal, so comparing
+ * and hashing models never touches the text. The default value is the empty name.
+ */
+class ModelName {
+public:
+    /**
+     * @brief Creates the empty model name.
+     */
+    ModelName() = default;
+
+    /**
+     * @brief Interns a model name.
+     *
+     * @param name The model name.
+     */
+    ModelName(const char* name) : id(internModel(name)) {}
+
+    /**
+     * @brief Interns a model name.
+     *
+     * @param name The model name.
+     */
+    template <typename Allocator>
+    ModelName(const std::basic_string<char, std::char_traits<char>, Allocator>& name)
+        : id(internModel(std::string_view(name.data(), name.size()))) {}
+
+    /**
+     * @brief Interns a model name.
+     *
+     * @param name The model name.
+     */
+    explicit ModelName(std::string_view name) : id(internModel(name)) {}
+
+    /**
+     * @brief Looks up a model name without interning it.
+     *
+     * @param name The model name.
+     * @param model Receives the model name when it is already interned.
+     * @return true if the name is interned.
+     */
+    static bool find(std::string_view name, ModelName& model) {
+        ModelSymbolTable& table = modelSymbols();
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto found = table.ids.find(name);
+        if (found == table.ids.end()) {
+            return false;
+        }
+        model.id = found->second;
+        return true;
+    }
+
+    /**
+     * @brief Returns the ID of the model name.
+     *
+     * @return uint32_t The ID, dense from 0.
+     */
+    uint32_t value() const {
+        return id;
+    }
+
+    /**
+     * @brief Returns the text of the model name.
+     *
+     * @return const std::string& The interned text.
+     */
+    const std::string& str() const {
+        ModelSymbolTable& table = modelSymbols();
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        return table.names[id];
+    }
+
+    friend bool operator==(const ModelName& a, const ModelName& b) {
+        return a.id == b.id;
+    }
+
+    friend bool operator!=(const ModelName& a, const ModelName& b) {
+        return a.id != b.id;
+    }
+
+    friend bool operator==(const ModelName& a, const char* b) {
+        return a.str() == b;
+    }
+
+    friend bool operator!=(const ModelName& a, const char* b) {
+        return a.str() != b;
+    }
+
+    template <typename Allocator>
+    friend bool operator==(const ModelName& a, const std::basic_string<char, std::char_traits<char>, Allocator>& b) {
+        return std::string_view(a.str()) == std::string_view(b.data(), b.size());
+    }
+
+    template <typename Allocator>
+    friend bool operator!=(const ModelName& a, const std::basic_string<char, std::char_traits<char>, Allocator>& b) {
+        return !(a == b);
+    }
+
+    /**
+     * @brief Writes the text of the model name; honors the stream width.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const ModelName& model) {
+        return out << model.str();
+    }
+
+    /**
+     * @brief Reads one whitespace separated word and interns it.
+     */
+    friend std::istream& operator>>(std::istream& in, ModelName& model) {
+        std::string name;
+        if (in >> name) {
+            model = ModelName(name);
+        }
+        return in;
+    }
+
+private:
+    uint32_t id = 0; ///< ID in the model symbol table.
+};
+
+#endif // MODEL_NAME_H
@@ -0,0 +1,105 @@
+/**
+ * @file mpscQueue.h
+ *
+ * @brief Provides a lock-free multi-producer single-consumer queue
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/**
+ * @class MpscQueue
+ * @brief Unbounded lock-free queue with many producers and exactly one consumer.
+ *
+ * Producers link a new node with a single atomic exchange on the head, so a push
+ * never waits for another producer or for the consumer. The consumer owns the tail
+ * and walks the links; the node it last consumed stays behind as the stub.
+ * A push that has swapped the head but not yet linked its node is simply not
+ * visible to tryPop() until the link is stored.
+ *
+ * @tparam T Element type; must be default constructible and movable.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /**
+     * @brief Creates an empty queue holding only the stub node.
+     */
+    MpscQueue() {
+        Node* stub = new Node;
+        head.store(stub, std::memory_order_relaxed);
+        tail = stub;
+    }
+
+    /**
+     * @brief Frees all nodes that were not consumed.
+     */
+    ~MpscQueue() {
+        while (tail != nullptr) {
+            Node* next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Appends an element. Safe to call from any number of threads.
+     *
+     * @param value The element to append.
+     */
+    void push(T value) {
+        Node* node = new Node;
+        node->value = std::move(value);
+
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Removes the oldest element. Must only be called from the consumer thread.
+     *
+     * @param value Receives the removed element.
+     * @return true if an element was removed, false if the queue looked empty.
+     */
+    bool tryPop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the queue looked empty. Must only be called from the consumer thread.
+     *
+     * @return true if no linked element is waiting.
+     */
+    bool empty() const {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    /**
+     * @struct Node
+     * @brief Singly linked queue node.
+     */
+    struct Node {
+        std::atomic<Node*> next{ nullptr }; ///< Next node, linked by the producer that pushed it.
+        T value{};                          ///< Stored element.
+    };
+
+    alignas(64) std::atomic<Node*> head; ///< Most recently pushed node, swapped by producers.
+    alignas(64) Node* tail;              ///< Stub node owned by the consumer.
+};
+
+#endif // MPSC_QUEUE_H
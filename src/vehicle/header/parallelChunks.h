@@ -0,0 +1,78 @@
+/**
+ * @file parallelChunks.h
+ *
+ * @brief Provides splitting of a text at line boundaries and parallel processing of the pieces
+ */
+
+#ifndef PARALLEL_CHUNKS_H
+#define PARALLEL_CHUNKS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+const size_t parallelChunkMinBytes = 1 << 16;   ///< Smallest piece of a text worth a thread of its own.
+
+/**
+ * @brief Returns the number of pieces a text should be processed in.
+ *
+ * @param bytes Size of the text.
+ * @param threads Requested number of threads, 0 for one per hardware thread.
+ * @return size_t At least 1, and no more pieces than leave each parallelChunkMinBytes.
+ */
+inline size_t parallelChunkCount(size_t bytes, int threads) {
+    size_t workers = threads > 0 ? static_cast<size_t>(threads) : std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(workers, bytes / parallelChunkMinBytes));
+}
+
+/**
+ * @brief Splits a text into consecutive pieces that each end with a whole line.
+ *
+ * The pieces have about the same size and together hold the whole text; a line is
+ * never split between two pieces. Fewer pieces are returned when lines are longer
+ * than a piece.
+ *
+ * @param text The text.
+ * @param chunks Number of pieces wanted.
+ * @return std::vector<std::string_view> The pieces, in text order.
+ */
+inline std::vector<std::string_view> splitAtLines(std::string_view text, size_t chunks) {
+    std::vector<std::string_view> pieces;
+    size_t start = 0;
+    for (size_t i = 1; i <= chunks && start < text.size(); ++i) {
+        size_t end = text.size();
+        if (i < chunks) {
+            end = text.find('\n', std::max(start, text.size() / chunks * i));
+            end = end == std::string_view::npos ? text.size() : end + 1;
+        }
+        pieces.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return pieces;
+}
+
+/**
+ * @brief Calls a function for every index below a count, each on its own thread.
+ *
+ * The calling thread handles index 0 and returns once every call has finished.
+ *
+ * @param count Number of calls.
+ * @param function Receives the index of the call.
+ */
+template <typename Function>
+void runInParallel(size_t count, Function function) {
+    std::vector<std::thread> workers;
+    for (size_t index = 1; index < count; ++index) {
+        workers.emplace_back([&function, index]() { function(index); });
+    }
+    if (count > 0) {
+        function(0);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif // PARALLEL_CHUNKS_H
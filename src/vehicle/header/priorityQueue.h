@@ -0,0 +1,157 @@
+/**
+ * @file priorityQueue.h
+ *
+ * @brief Provides a priority queue on a flat d-ary heap that keeps arrival order among equal priorities
+ */
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class PriorityQueue
+ * @brief Queue whose front is the element of highest priority, the earliest queued among equals.
+ *
+ * The elements are kept in a d-ary heap on one vector, so push() and pop() take
+ * O(log n) steps, and a wide node keeps the children of a step in one or two
+ * cache lines. Every element is stamped with its arrival number when it is
+ * queued, which makes the order total: elements of equal priority leave in the
+ * order they came. forEachInOrder() visits the whole queue in that order without
+ * changing it.
+ *
+ * @tparam T Element type; its priority is read from its `priority` member, higher first.
+ * @tparam Arity Number of children of a heap node.
+ */
+template <typename T, size_t Arity = 4>
+class PriorityQueue {
+public:
+    /**
+     * @brief Returns whether the queue is empty.
+     */
+    bool empty() const {
+        return heap.empty();
+    }
+
+    /**
+     * @brief Returns the number of queued elements.
+     */
+    size_t size() const {
+        return heap.size();
+    }
+
+    /**
+     * @brief Returns the element that leaves next; the queue must not be empty.
+     */
+    const T& front() const {
+        return heap.front().value;
+    }
+
+    /**
+     * @brief Queues an element behind the queued elements of the same or higher priority.
+     *
+     * @param value The element.
+     */
+    void push(T value) {
+        heap.push_back(Entry{ nextArrival++, std::move(value) });
+        siftUp(heap.size() - 1);
+    }
+
+    /**
+     * @brief Removes the element returned by front(); the queue must not be empty.
+     */
+    void pop() {
+        if (heap.size() > 1) {
+            heap.front() = std::move(heap.back());
+            heap.pop_back();
+            siftDown(0);
+        }
+        else {
+            heap.pop_back();
+        }
+    }
+
+    /**
+     * @brief Removes every element.
+     */
+    void clear() {
+        heap.clear();
+        nextArrival = 0;
+    }
+
+    /**
+     * @brief Visits every element in the order pop() would remove them, leaving the queue as it is.
+     *
+     * @param visit Called with each element.
+     */
+    template <typename Visit>
+    void forEachInOrder(Visit visit) const {
+        std::vector<const Entry*> order;
+        order.reserve(heap.size());
+        for (const Entry& entry : heap) {
+            order.push_back(&entry);
+        }
+        std::sort(order.begin(), order.end(), [](const Entry* a, const Entry* b) { return before(*a, *b); });
+        for (const Entry* entry : order) {
+            visit(entry->value);
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t arrival;   ///< Number of elements queued before this one.
+        T value;            ///< The element.
+    };
+
+    static bool before(const Entry& a, const Entry& b) {
+        if (a.value.priority != b.value.priority) {
+            return a.value.priority > b.value.priority;
+        }
+        return a.arrival < b.arrival;
+    }
+
+    void siftUp(size_t position) {
+        Entry entry = std::move(heap[position]);
+        while (position > 0) {
+            size_t parent = (position - 1) / Arity;
+            if (!before(entry, heap[parent])) {
+                break;
+            }
+            heap[position] = std::move(heap[parent]);
+            position = parent;
+        }
+        heap[position] = std::move(entry);
+    }
+
+    void siftDown(size_t position) {
+        Entry entry = std::move(heap[position]);
+        while (true) {
+            size_t first = position * Arity + 1;
+            if (first >= heap.size()) {
+                break;
+            }
+            size_t best = first;
+            size_t last = std::min(first + Arity, heap.size());
+            for (size_t child = first + 1; child < last; ++child) {
+                if (before(heap[child], heap[best])) {
+                    best = child;
+                }
+            }
+            if (!before(heap[best], entry)) {
+                break;
+            }
+            heap[position] = std::move(heap[best]);
+            position = best;
+        }
+        heap[position] = std::move(entry);
+    }
+
+    std::vector<Entry> heap;        ///< The heap; the children of node i are Arity * i + 1 to Arity * i + Arity.
+    uint64_t nextArrival = 0;       ///< Arrival number of the next element.
+};
+
+#endif // PRIORITY_QUEUE_H
@@ -0,0 +1,142 @@
+/**
+ * @file recordArena.h
+ *
+ * @brief Provides a monotonic arena for bulk-loaded records and their strings
+ */
+
+#ifndef RECORD_ARENA_H
+#define RECORD_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @class RecordArena
+ * @brief Allocates records and their string bytes from one monotonic buffer.
+ *
+ * Records are placed in slot chunks carved from the buffer, and strings built
+ * with resource() take their bytes from the same buffer. Destroying a single record
+ * only returns its slot to a free list for the next create(); the memory itself
+ * is released all at once when the arena is destroyed. Record destructors are not
+ * run at that point, so T must not own anything outside the arena.
+ *
+ * The arena is not synchronized; callers serialize access to it.
+ *
+ * @tparam T Record type.
+ */
+template <typename T>
+class RecordArena {
+public:
+    /**
+     * @brief Creates an arena, optionally sized for an expected number of records.
+     *
+     * @param expectedRecords Number of record slots to allocate up front.
+     * @param bytesPerRecord String bytes to reserve per expected record.
+     */
+    explicit RecordArena(size_t expectedRecords = 0, size_t bytesPerRecord = 0)
+        : buffer(expectedRecords * (sizeof(T) + bytesPerRecord) + initialBufferSize) {
+        if (expectedRecords > 0) {
+            addChunk(expectedRecords);
+        }
+    }
+
+    RecordArena(const RecordArena&) = delete;
+    RecordArena& operator=(const RecordArena&) = delete;
+
+    /**
+     * @brief Returns the memory resource for strings stored in arena records.
+     *
+     * @return std::pmr::memory_resource* The arena buffer.
+     */
+    std::pmr::memory_resource* resource() {
+        return &buffer;
+    }
+
+    /**
+     * @brief Constructs a record in a free slot.
+     *
+     * @param args Constructor or aggregate initializer arguments.
+     * @return T* The new record.
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* slot;
+        if (freeSlots != nullptr) {
+            slot = freeSlots;
+            freeSlots = freeSlots->next;
+        }
+        else {
+            if (chunks.empty() || chunkUsed == chunks.back().second) {
+                addChunk(chunks.empty() ? firstChunkSlots : std::min(chunks.back().second * 2, maxChunkSlots));
+            }
+            slot = chunks.back().first + chunkUsed * sizeof(T);
+            chunkUsed++;
+        }
+        return new (slot) T{ std::forward<Args>(args)... };
+    }
+
+    /**
+     * @brief Destroys a record and keeps its slot for reuse.
+     *
+     * @param record A record created by this arena.
+     */
+    void destroy(T* record) {
+        record->~T();
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(record);
+        slot->next = freeSlots;
+        freeSlots = slot;
+    }
+
+    /**
+     * @brief Checks whether a record lives in this arena.
+     *
+     * @param record The record.
+     * @return true if the record was created by this arena.
+     */
+    bool owns(const T* record) const {
+        const char* address = reinterpret_cast<const char*>(record);
+        for (const auto& chunk : chunks) {
+            if (address >= chunk.first && address < chunk.first + chunk.second * sizeof(T)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    /**
+     * @struct FreeSlot
+     * @brief Link stored in the slot of a destroyed record.
+     */
+    struct FreeSlot {
+        FreeSlot* next; ///< Next free slot.
+    };
+
+    static_assert(sizeof(T) >= sizeof(FreeSlot), "record too small for the free list");
+
+    static constexpr size_t initialBufferSize = 4096; ///< Size of the first buffer block without a size hint.
+    static constexpr size_t firstChunkSlots = 64;     ///< Slots in the first chunk without a size hint.
+    static constexpr size_t maxChunkSlots = 65536;    ///< Upper bound of the geometric chunk growth.
+
+    /**
+     * @brief Carves a chunk of record slots from the buffer.
+     *
+     * @param slots Number of slots in the chunk.
+     */
+    void addChunk(size_t slots) {
+        char* memory = static_cast<char*>(buffer.allocate(slots * sizeof(T), alignof(T)));
+        chunks.push_back({ memory, slots });
+        chunkUsed = 0;
+    }
+
+    std::pmr::monotonic_buffer_resource buffer;  ///< Memory of the slots and the string bytes.
+    std::vector<std::pair<char*, size_t>> chunks; ///< Slot chunks and their slot counts.
+    size_t chunkUsed = 0;                         ///< Slots handed out from the last chunk.
+    FreeSlot* freeSlots = nullptr;                ///< Slots of destroyed records.
+};
+
+#endif // RECORD_ARENA_H
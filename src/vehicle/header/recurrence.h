@@ -0,0 +1,109 @@
+/**
+ * @file recurrence.h
+ *
+ * @brief Provides recurrence rules whose occurrences are computed only for the days asked for
+ */
+
+#ifndef RECURRENCE_H
+#define RECURRENCE_H
+
+#include <cstdint>
+#include <limits>
+
+#include "dayNumber.h"
+
+/**
+ * @enum RecurrenceUnit
+ * @brief Unit of the interval between occurrences.
+ */
+enum RecurrenceUnit : uint8_t {
+    RecurDays,      ///< Every interval days.
+    RecurMonths     ///< Every interval calendar months, on the start's day of the month.
+};
+
+/**
+ * @struct Recurrence
+ * @brief Series of days repeating at a fixed interval from a start day.
+ *
+ * Occurrence i is computed from the start, not from occurrence i - 1, so a
+ * monthly series starting on the 31st falls on the last day of shorter months
+ * and returns to the 31st afterwards. Nothing is stored per occurrence: the
+ * first occurrence in a range is found by arithmetic, so a range costs time
+ * proportional to the occurrences inside it, however long the series runs.
+ */
+struct Recurrence {
+    CalendarDay start;                                                                      ///< First occurrence.
+    int interval = 1;                                                                       ///< Units between occurrences, at least 1.
+    RecurrenceUnit unit = RecurMonths;                                                      ///< Unit of the interval.
+    uint32_t count = 0;                                                                     ///< Number of occurrences, 0 for no limit.
+    CalendarDay until = CalendarDay(std::numeric_limits<int32_t>::max());                   ///< Last day an occurrence may fall on.
+
+    /**
+     * @brief Returns whether until was set to a last day.
+     */
+    bool hasLastDay() const {
+        return until != CalendarDay(std::numeric_limits<int32_t>::max());
+    }
+
+    /**
+     * @brief Returns occurrence i, ignoring count and until.
+     */
+    CalendarDay occurrence(uint32_t index) const {
+        if (unit == RecurDays) {
+            return start.addDays(static_cast<int32_t>(static_cast<int64_t>(index) * interval));
+        }
+        return start.addMonths(static_cast<int>(static_cast<int64_t>(index) * interval));
+    }
+
+    /**
+     * @brief Returns the index of the first occurrence on or after a day, ignoring count and until.
+     */
+    uint32_t firstIndexFrom(CalendarDay day) const {
+        if (day <= start) {
+            return 0;
+        }
+        if (unit == RecurDays) {
+            return static_cast<uint32_t>((static_cast<int64_t>(day - start) + interval - 1) / interval);
+        }
+
+        // Jump to the last occurrence in an earlier month, then step to the day
+        int startYear = 0, startMonth = 0, startDay = 0;
+        int year = 0, month = 0, dayOfMonth = 0;
+        start.toCivil(startYear, startMonth, startDay);
+        day.toCivil(year, month, dayOfMonth);
+        int months = (year - startYear) * 12 + (month - startMonth);
+        uint32_t index = static_cast<uint32_t>(months > 0 ? (months - 1) / interval : 0);
+        while (occurrence(index) < day) {
+            index++;
+        }
+        return index;
+    }
+
+    /**
+     * @brief Visits the occurrences that fall within a range of days, in order.
+     *
+     * @param from First day of the range.
+     * @param to Last day of the range.
+     * @param visit Called with the index and day of every occurrence in the range.
+     * @return size_t The number of occurrences visited.
+     */
+    template <typename Visit>
+    size_t forEachBetween(CalendarDay from, CalendarDay to, Visit visit) const {
+        if (interval < 1) {
+            return 0;
+        }
+        CalendarDay last = until < to ? until : to;
+        size_t visited = 0;
+        for (uint32_t index = firstIndexFrom(from); count == 0 || index < count; ++index) {
+            CalendarDay day = occurrence(index);
+            if (day > last) {
+                break;
+            }
+            visit(index, day);
+            visited++;
+        }
+        return visited;
+    }
+};
+
+#endif // RECURRENCE_H
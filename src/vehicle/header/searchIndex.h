@@ -0,0 +1,347 @@
+/**
+ * @file searchIndex.h
+ *
+ * @brief Provides a prefix and typo tolerant search index over short names
+ */
+
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @enum SearchKind
+ * @brief Kind of record a search entry points to.
+ */
+enum class SearchKind : uint8_t {
+    Customer,   ///< Customer name; the ID is the customer ID.
+    Plate,      ///< Plate number; the ID is the vehicle ID.
+    Model,      ///< Vehicle model; the ID is the model name ID.
+    Part        ///< Part name; the ID is the part ID.
+};
+
+/**
+ * @struct SearchHit
+ * @brief One search result.
+ */
+struct SearchHit {
+    SearchKind kind;    ///< Kind of the matched record.
+    long long id;       ///< ID of the matched record.
+    std::string text;   ///< Text as it was added.
+    int distance;       ///< Edits needed to turn the query into a prefix of the text, 0 for prefix hits.
+};
+
+/**
+ * @class SearchIndex
+ * @brief Sorted-array prefix index with a trigram index for typo tolerant lookups.
+ *
+ * Texts are normalized to lower case letters, digits and single spaces. Every word
+ * start of a text becomes its own key, so "smi" finds "John Smith". The keys are kept
+ * in one sorted array: a prefix query is a binary search followed by a forward scan.
+ * When prefixes do not fill the result limit, the trigrams of the query select
+ * candidates that are then checked with a bounded prefix edit distance.
+ *
+ * The alphabet has 37 symbols, so a trigram is a dense code below 37^3 and the
+ * postings are stored as one offset table over a single array.
+ *
+ * Add every text, call build() once, then search; the index is immutable after
+ * build() and may be searched from several threads.
+ */
+class SearchIndex {
+public:
+    /**
+     * @brief Adds a text to the index; takes effect on the next build().
+     *
+     * @param kind Kind of the record.
+     * @param text Text to search for.
+     * @param id ID of the record.
+     */
+    void add(SearchKind kind, std::string_view text, long long id) {
+        std::string key = normalize(text);
+        if (key.empty()) {
+            return;
+        }
+
+        uint32_t hit = static_cast<uint32_t>(hits.size());
+        hits.push_back({ kind, id, static_cast<uint32_t>(texts.size()), static_cast<uint32_t>(text.size()) });
+        texts.append(text);
+
+        uint32_t keyOffset = static_cast<uint32_t>(keyBytes.size());
+        keyBytes.append(key);
+        for (size_t i = 0; i < key.size(); ++i) {
+            if (i == 0 || key[i - 1] == ' ') {
+                entries.push_back({ keyOffset + static_cast<uint32_t>(i), static_cast<uint32_t>(key.size() - i), hit });
+            }
+        }
+    }
+
+    /**
+     * @brief Sorts the keys and builds the trigram postings.
+     */
+    void build() {
+        std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+            return key(a) < key(b);
+        });
+
+        // Count, then fill, the postings of every trigram of every key
+        gramStarts.assign(gramCount + 1, 0);
+        for (uint32_t e = 0; e < entries.size(); ++e) {
+            forEachGram(key(entries[e]), [this](uint32_t gram) { gramStarts[gram + 1]++; });
+        }
+        for (uint32_t gram = 0; gram < gramCount; ++gram) {
+            gramStarts[gram + 1] += gramStarts[gram];
+        }
+        postings.resize(gramStarts[gramCount]);
+        std::vector<uint32_t> fill(gramStarts.begin(), gramStarts.end() - 1);
+        for (uint32_t e = 0; e < entries.size(); ++e) {
+            forEachGram(key(entries[e]), [&](uint32_t gram) {
+                // A key repeating a trigram is posted once
+                if (fill[gram] == gramStarts[gram] || postings[fill[gram] - 1] != e) {
+                    postings[fill[gram]++] = e;
+                }
+            });
+        }
+        for (uint32_t gram = 0; gram < gramCount; ++gram) {
+            gramEnds.push_back(fill[gram]);
+        }
+    }
+
+    /**
+     * @brief Finds the records whose text starts with, or nearly starts with, the query.
+     *
+     * Prefix hits come first in key order, followed by typo tolerant hits ordered
+     * by edit distance. Each record is returned at most once.
+     *
+     * @param query Text typed so far.
+     * @param limit Maximum number of hits.
+     * @return std::vector<SearchHit> The hits.
+     */
+    std::vector<SearchHit> search(std::string_view query, size_t limit) const {
+        std::vector<SearchHit> result;
+        std::string needle = normalize(query);
+        if (needle.empty() || limit == 0) {
+            return result;
+        }
+        std::vector<uint32_t> seen;
+
+        auto first = std::lower_bound(entries.begin(), entries.end(), needle, [this](const Entry& entry, const std::string& value) {
+            return key(entry) < value;
+        });
+        for (auto it = first; it != entries.end() && result.size() < limit; ++it) {
+            std::string_view candidate = key(*it);
+            if (candidate.compare(0, needle.size(), needle) != 0) {
+                break;
+            }
+            addHit(result, seen, it->hit, 0);
+        }
+
+        if (result.size() < limit && needle.size() >= fuzzyMinLength) {
+            addFuzzyHits(result, seen, needle, limit);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the number of indexed texts.
+     *
+     * @return size_t The number of texts.
+     */
+    size_t size() const {
+        return hits.size();
+    }
+
+private:
+    /**
+     * @struct Hit
+     * @brief Record behind one or more keys.
+     */
+    struct Hit {
+        SearchKind kind;        ///< Kind of the record.
+        long long id;           ///< ID of the record.
+        uint32_t textOffset;    ///< Offset of the text in texts.
+        uint32_t textLength;    ///< Length of the text.
+    };
+
+    /**
+     * @struct Entry
+     * @brief Key starting at one word of a normalized text.
+     */
+    struct Entry {
+        uint32_t keyOffset;     ///< Offset of the key in keyBytes.
+        uint32_t keyLength;     ///< Length of the key.
+        uint32_t hit;           ///< Index of the record in hits.
+    };
+
+    static constexpr uint32_t alphabetSize = 37;                                        ///< Space, a-z and 0-9.
+    static constexpr uint32_t gramCount = alphabetSize * alphabetSize * alphabetSize;   ///< Number of distinct trigrams.
+    static constexpr size_t fuzzyMinLength = 3;                                         ///< Shorter queries are matched by prefix only.
+    static constexpr size_t maxQueryLength = 64;                                        ///< Longer queries are cut for fuzzy matching.
+    static constexpr size_t maxCountedPostings = 65536;                                 ///< Budget of postings counted per fuzzy query.
+
+    /**
+     * @brief Lower-cases a text and folds every run of other characters into one space.
+     *
+     * @param text The text.
+     * @return std::string The normalized text.
+     */
+    static std::string normalize(std::string_view text) {
+        std::string normalized;
+        normalized.reserve(text.size());
+        for (char c : text) {
+            unsigned char symbol = static_cast<unsigned char>(c);
+            if (std::isalnum(symbol) && symbol < 128) {
+                normalized.push_back(static_cast<char>(std::tolower(symbol)));
+            }
+            else if (!normalized.empty() && normalized.back() != ' ') {
+                normalized.push_back(' ');
+            }
+        }
+        if (!normalized.empty() && normalized.back() == ' ') {
+            normalized.pop_back();
+        }
+        return normalized;
+    }
+
+    /**
+     * @brief Maps a normalized character to its position in the alphabet.
+     */
+    static uint32_t symbolCode(char c) {
+        if (c >= 'a' && c <= 'z') {
+            return 1 + (c - 'a');
+        }
+        if (c >= '0' && c <= '9') {
+            return 27 + (c - '0');
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Calls a function with the code of every trigram of a key padded by a leading space.
+     */
+    template <typename Function>
+    static void forEachGram(std::string_view key, Function function) {
+        uint32_t previous = 0;
+        uint32_t current = 0;
+        for (size_t i = 0; i < key.size(); ++i) {
+            uint32_t next = symbolCode(key[i]);
+            if (i >= 1) {
+                function((previous * alphabetSize + current) * alphabetSize + next);
+            }
+            previous = current;
+            current = next;
+        }
+    }
+
+    /**
+     * @brief Returns the fewest edits turning a query into a prefix of a key, capped at limit + 1.
+     */
+    static int prefixDistance(std::string_view query, std::string_view key, int limit) {
+        size_t columns = std::min(key.size(), query.size() + static_cast<size_t>(limit));
+        std::vector<int> row(columns + 1);
+        for (size_t j = 0; j <= columns; ++j) {
+            row[j] = static_cast<int>(j);
+        }
+        for (size_t i = 1; i <= query.size(); ++i) {
+            int diagonal = row[0];
+            row[0] = static_cast<int>(i);
+            int best = row[0];
+            for (size_t j = 1; j <= columns; ++j) {
+                int above = row[j];
+                row[j] = std::min({ above + 1, row[j - 1] + 1, diagonal + (query[i - 1] == key[j - 1] ? 0 : 1) });
+                diagonal = above;
+                best = std::min(best, row[j]);
+            }
+            if (best > limit) {
+                return limit + 1;
+            }
+        }
+        return *std::min_element(row.begin(), row.end());
+    }
+
+    std::string_view key(const Entry& entry) const {
+        return std::string_view(keyBytes.data() + entry.keyOffset, entry.keyLength);
+    }
+
+    void addHit(std::vector<SearchHit>& result, std::vector<uint32_t>& seen, uint32_t hit, int distance) const {
+        if (std::find(seen.begin(), seen.end(), hit) != seen.end()) {
+            return;
+        }
+        seen.push_back(hit);
+        const Hit& record = hits[hit];
+        result.push_back({ record.kind, record.id, texts.substr(record.textOffset, record.textLength), distance });
+    }
+
+    /**
+     * @brief Appends hits within a small edit distance of the query, found through shared trigrams.
+     *
+     * A prefix within k edits of the query misses at most 3k of its trigrams, so only
+     * keys sharing all but 3k of the counted trigrams are checked. Trigrams are counted
+     * from the rarest up while their postings stay within maxCountedPostings, which
+     * keeps common trigrams from dominating the cost of a keystroke.
+     */
+    void addFuzzyHits(std::vector<SearchHit>& result, std::vector<uint32_t>& seen, std::string_view needle, size_t limit) const {
+        needle = needle.substr(0, maxQueryLength);
+        int maxEdits = needle.size() <= 5 ? 1 : 2;
+
+        std::vector<uint32_t> grams;
+        forEachGram(needle, [&](uint32_t gram) { grams.push_back(gram); });
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        std::sort(grams.begin(), grams.end(), [this](uint32_t a, uint32_t b) {
+            return gramEnds[a] - gramStarts[a] < gramEnds[b] - gramStarts[b];
+        });
+
+        std::vector<uint8_t> shared(entries.size());
+        std::vector<uint32_t> touched;
+        size_t counted = 0;
+        int countedGrams = 0;
+        for (uint32_t gram : grams) {
+            size_t length = gramEnds[gram] - gramStarts[gram];
+            if (countedGrams > 0 && counted + length > maxCountedPostings) {
+                break;
+            }
+            for (uint32_t p = gramStarts[gram]; p < gramEnds[gram]; ++p) {
+                if (shared[postings[p]]++ == 0) {
+                    touched.push_back(postings[p]);
+                }
+            }
+            counted += length;
+            countedGrams++;
+        }
+        int required = std::max(1, countedGrams - 3 * maxEdits);
+
+        std::vector<std::pair<int, uint32_t>> candidates;
+        for (uint32_t e : touched) {
+            if (shared[e] >= required) {
+                int distance = prefixDistance(needle, key(entries[e]), maxEdits);
+                if (distance <= maxEdits) {
+                    candidates.push_back({ distance, e });
+                }
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto& candidate : candidates) {
+            if (result.size() >= limit) {
+                break;
+            }
+            addHit(result, seen, entries[candidate.second].hit, candidate.first);
+        }
+    }
+
+    std::vector<Hit> hits;              ///< Indexed records.
+    std::string texts;                  ///< Original texts of all records.
+    std::string keyBytes;               ///< Normalized texts of all records.
+    std::vector<Entry> entries;         ///< Keys sorted after build().
+    std::vector<uint32_t> gramStarts;   ///< First posting of every trigram.
+    std::vector<uint32_t> gramEnds;     ///< End of the postings of every trigram.
+    std::vector<uint32_t> postings;     ///< Entry indexes grouped by trigram.
+};
+
+#endif // SEARCH_INDEX_H
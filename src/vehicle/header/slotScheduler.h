@@ -0,0 +1,297 @@
+/**
+ * @file slotScheduler.h
+ *
+ * @brief Provides bay capacity planning over per-day slot bitmaps
+ */
+
+#ifndef SLOT_SCHEDULER_H
+#define SLOT_SCHEDULER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Largest number of slots a day can be divided into; a bay's day is one 64-bit word.
+ */
+const int maxSlotsPerDay = 64;
+
+/**
+ * @brief Returns the position of the lowest set bit of a non-zero word.
+ */
+inline int lowestSetBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/**
+ * @brief Returns the number of set bits of a word.
+ */
+inline int countSetBits(uint64_t word) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+/**
+ * @brief Returns the positions at which a run of at least a given number of set bits starts.
+ *
+ * Each step ands the word with itself shifted by the length covered so far, so
+ * a run of n bits is found in about log2(n) steps.
+ *
+ * @param bits The word.
+ * @param length Length of the run, at least 1.
+ * @return uint64_t Bit i is set if bits i to i + length - 1 are all set.
+ */
+inline uint64_t runStarts(uint64_t bits, int length) {
+    int covered = 1;
+    while (covered < length && bits != 0) {
+        int shift = std::min(covered, length - covered);
+        bits &= bits >> shift;
+        covered += shift;
+    }
+    return bits;
+}
+
+/**
+ * @struct SlotBooking
+ * @brief Consecutive slots of one bay on one day.
+ */
+struct SlotBooking {
+    int32_t day = 0;        ///< Day number, as returned by daysFromCivil.
+    int bay = 0;            ///< Bay, from 0.
+    int firstSlot = 0;      ///< First slot of the day, from 0.
+    int slotCount = 0;      ///< Number of slots.
+};
+
+/**
+ * @class SlotScheduler
+ * @brief Tracks which slots of every bay are taken, one bitmap word per bay and day.
+ *
+ * Days that were never booked take no memory and are entirely free. Searches
+ * skip a bay's day with one popcount when it has too few free slots, and find
+ * the earliest fitting start with a few shifts and one ctz otherwise. The
+ * scheduler is not synchronized; callers serialize access.
+ */
+class SlotScheduler {
+public:
+    /**
+     * @brief Creates a scheduler with every slot free.
+     *
+     * @param bays Number of bays, at least 1.
+     * @param slotsPerDay Number of slots per bay and day, 1 to maxSlotsPerDay.
+     */
+    explicit SlotScheduler(int bays = 1, int slotsPerDay = maxSlotsPerDay)
+        : bayCount(std::max(bays, 1)), daySlots(std::min(std::max(slotsPerDay, 1), maxSlotsPerDay)),
+          dayMask(daySlots == maxSlotsPerDay ? ~uint64_t(0) : (uint64_t(1) << daySlots) - 1) {}
+
+    /**
+     * @brief Returns the number of bays.
+     */
+    int bays() const {
+        return bayCount;
+    }
+
+    /**
+     * @brief Returns the number of slots per bay and day.
+     */
+    int slotsPerDay() const {
+        return daySlots;
+    }
+
+    /**
+     * @brief Finds the earliest free run of slots on a day, over all bays.
+     *
+     * @param day The day.
+     * @param slotCount Number of consecutive slots needed.
+     * @param found Receives the slots; on a tie in start time the lowest bay wins.
+     * @return false if no bay has the slots free that day.
+     */
+    bool findFreeOnDay(int32_t day, int slotCount, SlotBooking& found) const {
+        if (slotCount < 1 || slotCount > daySlots) {
+            return false;
+        }
+
+        const uint64_t* busy = dayWords(day);
+        int bestSlot = maxSlotsPerDay;
+        for (int bay = 0; bay < bayCount; ++bay) {
+            uint64_t free = ~(busy ? busy[bay] : 0) & dayMask;
+            if (countSetBits(free) < slotCount) {
+                continue;
+            }
+            uint64_t starts = runStarts(free, slotCount);
+            if (starts != 0 && lowestSetBit(starts) < bestSlot) {
+                bestSlot = lowestSetBit(starts);
+                found = { day, bay, bestSlot, slotCount };
+            }
+        }
+        return bestSlot < maxSlotsPerDay;
+    }
+
+    /**
+     * @brief Finds the first day on or after a given one with a free run of slots.
+     *
+     * @param fromDay The first day to try.
+     * @param slotCount Number of consecutive slots needed.
+     * @param found Receives the earliest slots of the first day that has them.
+     * @param horizonDays Number of days to try.
+     * @return false if no day of the horizon has the slots free.
+     */
+    bool findFirstFree(int32_t fromDay, int slotCount, SlotBooking& found, int32_t horizonDays = 366) const {
+        if (slotCount < 1 || slotCount > daySlots) {
+            return false;
+        }
+
+        // Days before the first booked day or after the last one are entirely free
+        int32_t lastDay = firstDay + static_cast<int32_t>(busy.size() / bayCount);
+        for (int32_t day = fromDay; day < fromDay + horizonDays; ++day) {
+            if (day < firstDay || day >= lastDay) {
+                found = { day, 0, 0, slotCount };
+                return true;
+            }
+            if (findFreeOnDay(day, slotCount, found)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Marks slots as taken.
+     *
+     * @param booking The slots.
+     * @return false if the booking is out of range or any of its slots is taken.
+     */
+    bool reserve(const SlotBooking& booking) {
+        uint64_t bits = bookingBits(booking);
+        if (bits == 0) {
+            return false;
+        }
+        uint64_t& word = dayWordsForUpdate(booking.day)[booking.bay];
+        if ((word & bits) != 0) {
+            return false;
+        }
+        word |= bits;
+        return true;
+    }
+
+    /**
+     * @brief Frees slots taken by reserve().
+     *
+     * @param booking The slots.
+     * @return false if the booking is out of range or any of its slots is free.
+     */
+    bool release(const SlotBooking& booking) {
+        uint64_t bits = bookingBits(booking);
+        const uint64_t* busy = dayWords(booking.day);
+        if (bits == 0 || !busy || (busy[booking.bay] & bits) != bits) {
+            return false;
+        }
+        dayWordsForUpdate(booking.day)[booking.bay] &= ~bits;
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of free slots of a day over all bays.
+     */
+    int freeSlots(int32_t day) const {
+        const uint64_t* busy = dayWords(day);
+        int free = 0;
+        for (int bay = 0; bay < bayCount; ++bay) {
+            free += countSetBits(~(busy ? busy[bay] : 0) & dayMask);
+        }
+        return free;
+    }
+
+    /**
+     * @brief Frees every slot.
+     */
+    void clear() {
+        busy.clear();
+        firstDay = 0;
+    }
+
+    /**
+     * @brief Returns the day of the first words of words().
+     */
+    int32_t firstWordDay() const {
+        return firstDay;
+    }
+
+    /**
+     * @brief Returns the taken slots by day from firstWordDay(), then bay; bit i is slot i.
+     */
+    const std::vector<uint64_t>& words() const {
+        return busy;
+    }
+
+    /**
+     * @brief Replaces the taken slots with the words of a scheduler of the same shape.
+     *
+     * @param first Day of the first words.
+     * @param words Taken slots by day, then bay, as returned by words().
+     * @return false if the words are not whole days of this scheduler's bays and slots; nothing changes then.
+     */
+    bool assign(int32_t first, std::vector<uint64_t> words) {
+        if (words.size() % bayCount != 0) {
+            return false;
+        }
+        for (uint64_t word : words) {
+            if ((word & ~dayMask) != 0) {
+                return false;
+            }
+        }
+        busy.swap(words);
+        firstDay = first;
+        return true;
+    }
+
+private:
+    uint64_t bookingBits(const SlotBooking& booking) const {
+        if (booking.bay < 0 || booking.bay >= bayCount || booking.firstSlot < 0 || booking.slotCount < 1 || booking.firstSlot + booking.slotCount > daySlots) {
+            return 0;
+        }
+        uint64_t run = booking.slotCount == maxSlotsPerDay ? ~uint64_t(0) : (uint64_t(1) << booking.slotCount) - 1;
+        return run << booking.firstSlot;
+    }
+
+    const uint64_t* dayWords(int32_t day) const {
+        if (day < firstDay || static_cast<size_t>(day - firstDay) >= busy.size() / bayCount) {
+            return nullptr;
+        }
+        return busy.data() + static_cast<size_t>(day - firstDay) * bayCount;
+    }
+
+    uint64_t* dayWordsForUpdate(int32_t day) {
+        if (busy.empty()) {
+            firstDay = day;
+        }
+        else if (day < firstDay) {
+            busy.insert(busy.begin(), static_cast<size_t>(firstDay - day) * bayCount, 0);
+            firstDay = day;
+        }
+        size_t offset = static_cast<size_t>(day - firstDay) * bayCount;
+        if (offset + bayCount > busy.size()) {
+            busy.resize(offset + bayCount, 0);
+        }
+        return busy.data() + offset;
+    }
+
+    int bayCount;                   ///< Number of bays.
+    int daySlots;                   ///< Number of slots per bay and day.
+    uint64_t dayMask;               ///< The daySlots low bits.
+    int32_t firstDay = 0;           ///< Day of the first words of busy.
+    std::vector<uint64_t> busy;     ///< Taken slots by day, then bay; bit i is slot i.
+};
+
+#endif // SLOT_SCHEDULER_H
@@ -0,0 +1,389 @@
+/**
+ * @file snapshotImage.h
+ *
+ * @brief Provides memory-mapped, checksummed image files made of typed sections
+ */
+
+#ifndef SNAPSHOT_IMAGE_H
+#define SNAPSHOT_IMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * An image file is a header, a table of sections and the sections:
+ *
+ *  header     magic, format version, section count, file size and the checksum of the table
+ *  table      tag, offset, size and checksum of every section
+ *  sections   arrays of fixed-width records, each starting at a multiple of 8 bytes
+ *
+ * Offsets count from the start of the file and records refer to each other by
+ * index or offset, never by address, so an image can be mapped anywhere and its
+ * records read in place. A section is only checksummed when it is read, so a
+ * reader pays for the sections it uses.
+ */
+
+const char snapshotMagic[8] = "VSNAP01";        ///< Identifies an image file.
+const size_t snapshotAlignment = 8;             ///< Alignment of every section in the file.
+
+/**
+ * @struct SnapshotHeader
+ * @brief Fixed header at the start of an image file.
+ */
+struct SnapshotHeader {
+    char magic[8];              ///< snapshotMagic.
+    uint32_t version;           ///< Layout version of the records; other versions are not read.
+    uint32_t sectionCount;      ///< Number of entries in the section table.
+    uint64_t fileSize;          ///< Size of the whole file.
+    uint64_t tableChecksum;     ///< snapshotChecksum of the section table.
+};
+
+/**
+ * @struct SnapshotSection
+ * @brief Entry of the section table.
+ */
+struct SnapshotSection {
+    uint32_t tag;               ///< Identifies the contents.
+    uint32_t reserved;          ///< Padding, always zero.
+    uint64_t offset;            ///< Start of the section in the file.
+    uint64_t size;              ///< Length of the section.
+    uint64_t checksum;          ///< snapshotChecksum of the section.
+};
+
+/**
+ * @struct SnapshotText
+ * @brief Reference to a string kept in a string section.
+ */
+struct SnapshotText {
+    uint32_t offset;            ///< Start of the string in the section.
+    uint32_t length;            ///< Length of the string.
+};
+
+/**
+ * @brief Computes the 64-bit checksum of a byte range, eight bytes per step.
+ *
+ * @param data Start of the bytes.
+ * @param size Number of bytes.
+ * @return uint64_t The checksum.
+ */
+inline uint64_t snapshotChecksum(const char* data, size_t size) {
+    const uint64_t multiplier = 0xff51afd7ed558ccdULL;
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ size;
+    size_t position = 0;
+    for (; position + 8 <= size; position += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + position, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 32;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + position, size - position);
+    hash = (hash ^ tail) * multiplier;
+    return hash ^ (hash >> 29);
+}
+
+/**
+ * @class SnapshotStrings
+ * @brief Collects strings into the bytes of a string section.
+ */
+class SnapshotStrings {
+public:
+    /**
+     * @brief Appends a string.
+     *
+     * @param text The string.
+     * @return SnapshotText Reference to the string.
+     */
+    SnapshotText add(std::string_view text) {
+        SnapshotText reference = { static_cast<uint32_t>(data.size()), static_cast<uint32_t>(text.size()) };
+        data.append(text.data(), text.size());
+        return reference;
+    }
+
+    /**
+     * @brief Returns whether every reference handed out fits in 32 bits.
+     */
+    bool fits() const {
+        return data.size() <= UINT32_MAX;
+    }
+
+    /**
+     * @brief Returns the bytes of the section.
+     */
+    const std::string& bytes() const {
+        return data;
+    }
+
+private:
+    std::string data;           ///< The strings, back to back.
+};
+
+/**
+ * @brief Resolves a string reference against a string section.
+ *
+ * @param strings The string section.
+ * @param reference The reference.
+ * @param text Receives the string.
+ * @return false if the reference points outside the section.
+ */
+inline bool snapshotText(std::string_view strings, const SnapshotText& reference, std::string_view& text) {
+    if (reference.offset > strings.size() || reference.length > strings.size() - reference.offset) {
+        return false;
+    }
+    text = strings.substr(reference.offset, reference.length);
+    return true;
+}
+
+/**
+ * @class SnapshotWriter
+ * @brief Collects sections and writes them as an image file.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @brief Adds a section.
+     *
+     * @param tag Identifies the contents.
+     * @param bytes The contents.
+     */
+    void add(uint32_t tag, std::string bytes) {
+        sections.push_back({ tag, std::move(bytes) });
+    }
+
+    /**
+     * @brief Adds a section holding an array of fixed-width records.
+     *
+     * @param tag Identifies the contents.
+     * @param records The records.
+     */
+    template <typename Record>
+    void addArray(uint32_t tag, const std::vector<Record>& records) {
+        add(tag, std::string(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record)));
+    }
+
+    /**
+     * @brief Writes the image file.
+     *
+     * The image is written under a temporary name and renamed into place, so a
+     * reader never maps a partial image.
+     *
+     * @param path Path of the image.
+     * @param version Layout version of the records.
+     * @return true on success.
+     */
+    bool write(const std::string& path, uint32_t version) const {
+        SnapshotHeader header = {};
+        std::copy(snapshotMagic, snapshotMagic + 8, header.magic);
+        header.version = version;
+        header.sectionCount = static_cast<uint32_t>(sections.size());
+
+        std::vector<SnapshotSection> table;
+        uint64_t offset = alignUp(sizeof(SnapshotHeader) + sections.size() * sizeof(SnapshotSection));
+        for (const auto& section : sections) {
+            table.push_back({ section.first, 0, offset, section.second.size(), snapshotChecksum(section.second.data(), section.second.size()) });
+            offset = alignUp(offset + section.second.size());
+        }
+        header.fileSize = offset;
+        header.tableChecksum = snapshotChecksum(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SnapshotSection));
+
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+            const char padding[snapshotAlignment] = {};
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SnapshotSection)));
+            uint64_t written = sizeof(header) + table.size() * sizeof(SnapshotSection);
+            for (size_t i = 0; i < sections.size(); ++i) {
+                out.write(padding, static_cast<std::streamsize>(table[i].offset - written));
+                out.write(sections[i].second.data(), static_cast<std::streamsize>(sections[i].second.size()));
+                written = table[i].offset + sections[i].second.size();
+            }
+            out.write(padding, static_cast<std::streamsize>(header.fileSize - written));
+            if (!out) {
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        return !error;
+    }
+
+private:
+    static uint64_t alignUp(uint64_t offset) {
+        return (offset + snapshotAlignment - 1) / snapshotAlignment * snapshotAlignment;
+    }
+
+    std::vector<std::pair<uint32_t, std::string>> sections;     ///< Tag and contents of every section, in file order.
+};
+
+/**
+ * @class SnapshotImage
+ * @brief Read-only mapping of an image file.
+ *
+ * open() maps the file and checks its header and section table; the sections
+ * themselves are checked when they are read. Everything read from an image
+ * stays valid until the image is closed or destroyed.
+ */
+class SnapshotImage {
+public:
+    SnapshotImage() = default;
+    SnapshotImage(const SnapshotImage&) = delete;
+    SnapshotImage& operator=(const SnapshotImage&) = delete;
+
+    ~SnapshotImage() {
+        close();
+    }
+
+    /**
+     * @brief Maps an image file.
+     *
+     * @param path Path of the image.
+     * @param version Layout version the caller reads.
+     * @return false if the file is missing, of another version or damaged.
+     */
+    bool open(const std::string& path, uint32_t version) {
+        close();
+        if (!map(path)) {
+            return false;
+        }
+
+        SnapshotHeader header;
+        if (size < sizeof(header)) {
+            close();
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        uint64_t tableEnd = sizeof(header) + static_cast<uint64_t>(header.sectionCount) * sizeof(SnapshotSection);
+        if (std::memcmp(header.magic, snapshotMagic, 8) != 0 || header.version != version || header.fileSize != size || tableEnd > size
+            || snapshotChecksum(data + sizeof(header), tableEnd - sizeof(header)) != header.tableChecksum) {
+            close();
+            return false;
+        }
+
+        table.resize(header.sectionCount);
+        std::memcpy(table.data(), data + sizeof(header), table.size() * sizeof(SnapshotSection));
+        for (const SnapshotSection& section : table) {
+            if (section.offset % snapshotAlignment != 0 || section.offset > size || section.size > size - section.offset) {
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Unmaps the image.
+     */
+    void close() {
+#if defined(_WIN32)
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+#else
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+#endif
+        data = nullptr;
+        size = 0;
+        table.clear();
+    }
+
+    /**
+     * @brief Reads a section and verifies its checksum.
+     *
+     * @param tag Identifies the section.
+     * @param bytes Receives the contents, pointing into the mapping.
+     * @return false if the section is missing or damaged.
+     */
+    bool section(uint32_t tag, std::string_view& bytes) const {
+        for (const SnapshotSection& section : table) {
+            if (section.tag == tag) {
+                bytes = std::string_view(data + section.offset, section.size);
+                return snapshotChecksum(bytes.data(), bytes.size()) == section.checksum;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reads a section of fixed-width records in place.
+     *
+     * @param tag Identifies the section.
+     * @param records Receives the first record, pointing into the mapping.
+     * @param count Receives the number of records.
+     * @return false if the section is missing, damaged or not a whole number of records.
+     */
+    template <typename Record>
+    bool array(uint32_t tag, const Record*& records, size_t& count) const {
+        static_assert(alignof(Record) <= snapshotAlignment, "records must fit the section alignment");
+        std::string_view bytes;
+        if (!section(tag, bytes) || bytes.size() % sizeof(Record) != 0) {
+            return false;
+        }
+        records = reinterpret_cast<const Record*>(bytes.data());
+        count = bytes.size() / sizeof(Record);
+        return true;
+    }
+
+private:
+    bool map(const std::string& path) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        CloseHandle(file);
+        if (!mapping) {
+            return false;
+        }
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        size = data ? static_cast<size_t>(fileSize.QuadPart) : 0;
+        return data != nullptr;
+#else
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+        struct stat status;
+        void* mapping = MAP_FAILED;
+        if (fstat(file, &status) == 0 && status.st_size > 0) {
+            mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        }
+        ::close(file);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        data = static_cast<const char*>(mapping);
+        size = static_cast<size_t>(status.st_size);
+        return true;
+#endif
+    }
+
+    const char* data = nullptr;             ///< Start of the mapping.
+    size_t size = 0;                        ///< Length of the mapping.
+    std::vector<SnapshotSection> table;     ///< Section table of the image.
+};
+
+#endif // SNAPSHOT_IMAGE_H
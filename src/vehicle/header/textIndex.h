@@ -0,0 +1,543 @@
+/**
+ * @file textIndex.h
+ *
+ * @brief Provides an on-disk inverted index over append-only text files
+ */
+
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "varint.h"
+
+/*
+ * A text file "feedback.txt" is indexed by two files next to it:
+ *
+ *  feedback.txt.idx      compacted index: header, sorted term dictionary, sparse
+ *                        block index over the dictionary, and the posting lists.
+ *  feedback.txt.idx.log  terms of the records appended since the last compaction.
+ *
+ * A posting list holds the byte offsets of the records containing a term, delta
+ * encoded as varints. By default records are the blocks of lines ending with an
+ * empty line, which is how the feedback writer terminates its entries; files of
+ * other layouts pass a TextRecordReader that splits and renders their records.
+ */
+
+/**
+ * @struct TextIndexHeader
+ * @brief Fixed header at the start of a compacted index file.
+ */
+struct TextIndexHeader {
+    char magic[8];              ///< textIndexMagic.
+    uint64_t indexedBytes;      ///< Length of the text file prefix the index covers.
+    uint64_t termCount;         ///< Number of dictionary terms.
+    uint64_t blockCount;        ///< Number of dictionary blocks.
+    uint64_t blockIndexOffset;  ///< File offset of the block index.
+    uint64_t postingsOffset;    ///< File offset of the posting lists.
+};
+
+const char textIndexMagic[8] = "VTIDX01";           ///< Identifies a compacted index file.
+const size_t textIndexBlockTerms = 64;              ///< Dictionary terms per block index entry.
+const size_t textIndexMaxTermLength = 32;           ///< Longer words are cut to this length.
+const uintmax_t textIndexLogCompactBytes = 1 << 20; ///< Log size that triggers a compaction.
+
+/**
+ * @brief Splits a text into its distinct lower-case words.
+ *
+ * Words are runs of ASCII letters and digits of at least two characters.
+ *
+ * @param text The text.
+ * @return std::vector<std::string> Sorted distinct words.
+ */
+inline std::vector<std::string> tokenizeText(std::string_view text) {
+    std::vector<std::string> terms;
+    std::string term;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+        if (c < 128 && std::isalnum(c)) {
+            if (term.size() < textIndexMaxTermLength) {
+                term.push_back(static_cast<char>(std::tolower(c)));
+            }
+        }
+        else {
+            if (term.size() >= 2) {
+                terms.push_back(term);
+            }
+            term.clear();
+        }
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+/**
+ * @brief Returns the size of a file, or 0 when it does not exist.
+ */
+inline uint64_t textFileSize(const std::string& path) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<uint64_t>(size);
+}
+
+/**
+ * @brief Reads a whole file into a string with a single read call.
+ */
+inline std::string readWholeFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    std::string contents;
+    if (in) {
+        contents.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(&contents[0], static_cast<std::streamsize>(contents.size()));
+        contents.resize(static_cast<size_t>(in.gcount()));
+    }
+    return contents;
+}
+
+/**
+ * @brief Receives the offset, end and text of one record.
+ */
+using TextRecordVisitor = std::function<void(uint64_t, uint64_t, std::string_view)>;
+
+/**
+ * @brief Splits the contents of an indexed file, from an offset on, into records.
+ */
+using TextRecordReader = std::function<void(std::string_view, uint64_t, const TextRecordVisitor&)>;
+
+/**
+ * @brief Records the terms of an appended record in the index log.
+ *
+ * @param textPath The indexed file.
+ * @param offset Offset of the record in the file.
+ * @param length Number of bytes the record occupies in the file.
+ * @param text Text of the record.
+ */
+inline void logTextRecord(const std::string& textPath, uint64_t offset, uint64_t length, std::string_view text) {
+    std::vector<std::string> terms = tokenizeText(text);
+
+    std::string entry;
+    appendVarint(entry, offset);
+    appendVarint(entry, length);
+    appendVarint(entry, terms.size());
+    for (const std::string& term : terms) {
+        appendVarint(entry, term.size());
+        entry += term;
+    }
+
+    std::ofstream log(textPath + ".idx.log", std::ios::binary | std::ios::app);
+    log.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+}
+
+/**
+ * @brief Calls a function with the offset, end and terms of every entry of an index log.
+ *
+ * A torn entry at the end of the log, left by an interrupted append, is ignored.
+ */
+template <typename Function>
+void forEachTextLogEntry(const std::string& textPath, Function function) {
+    std::string log = readWholeFile(textPath + ".idx.log");
+    const char* cursor = log.data();
+    const char* end = log.data() + log.size();
+
+    std::vector<std::string> terms;
+    while (cursor < end) {
+        uint64_t offset, length, count;
+        if (!readVarint(cursor, end, offset) || !readVarint(cursor, end, length) || !readVarint(cursor, end, count)) {
+            return;
+        }
+        terms.resize(static_cast<size_t>(std::min<uint64_t>(count, static_cast<uint64_t>(end - cursor))));
+        for (std::string& term : terms) {
+            if (!readVarintString(cursor, end, term)) {
+                return;
+            }
+        }
+        function(offset, offset + length, terms);
+    }
+}
+
+/**
+ * @brief Calls a function with the offset, end and text of every record in a range of a text file.
+ *
+ * This is the default TextRecordReader: a record ends with an empty line.
+ *
+ * @param text Contents of the text file.
+ * @param from Offset of the first record.
+ * @param function Receives every record.
+ */
+inline void forEachTextRecord(std::string_view text, uint64_t from, const TextRecordVisitor& function) {
+    size_t start = static_cast<size_t>(from);
+    size_t position = start;
+    while (position < text.size()) {
+        size_t lineEnd = text.find('\n', position);
+        lineEnd = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+        bool blank = lineEnd - position == 1 || (lineEnd - position == 2 && text[position] == '\r');
+        position = lineEnd;
+        if (blank || position == text.size()) {
+            function(start, position, text.substr(start, position - start));
+            start = position;
+        }
+    }
+}
+
+/**
+ * @brief Reads the compacted index of a text file.
+ *
+ * @param in The open index file.
+ * @param header Receives the header.
+ * @param blocks Receives the first term and dictionary offset of every block.
+ * @return true if a valid index exists.
+ */
+inline bool readTextIndexHeader(std::ifstream& in, TextIndexHeader& header, std::vector<std::pair<std::string, uint64_t>>& blocks) {
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::string_view(header.magic, 8) != std::string_view(textIndexMagic, 8)) {
+        return false;
+    }
+
+    std::string blockIndex(static_cast<size_t>(header.postingsOffset - header.blockIndexOffset), '\0');
+    in.seekg(static_cast<std::streamoff>(header.blockIndexOffset));
+    if (!in.read(&blockIndex[0], static_cast<std::streamsize>(blockIndex.size()))) {
+        return false;
+    }
+
+    const char* cursor = blockIndex.data();
+    const char* end = blockIndex.data() + blockIndex.size();
+    blocks.resize(static_cast<size_t>(header.blockCount));
+    for (auto& block : blocks) {
+        if (!readVarintString(cursor, end, block.first) || !readVarint(cursor, end, block.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes a delta encoded posting list.
+ */
+inline void decodePostings(const char* cursor, const char* end, uint64_t count, std::vector<uint64_t>& offsets) {
+    uint64_t offset = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta;
+        if (!readVarint(cursor, end, delta)) {
+            return;
+        }
+        offset += delta;
+        offsets.push_back(offset);
+    }
+}
+
+/**
+ * @brief Calls a function with every term and posting list of a compacted index, in term order.
+ */
+template <typename Function>
+void forEachIndexedTerm(std::ifstream& in, const TextIndexHeader& header, Function function) {
+    std::string dictionary(static_cast<size_t>(header.blockIndexOffset - sizeof(header)), '\0');
+    std::string postings;
+    in.seekg(sizeof(header));
+    in.read(&dictionary[0], static_cast<std::streamsize>(dictionary.size()));
+    in.seekg(0, std::ios::end);
+    postings.resize(static_cast<size_t>(static_cast<uint64_t>(in.tellg()) - header.postingsOffset));
+    in.seekg(static_cast<std::streamoff>(header.postingsOffset));
+    in.read(&postings[0], static_cast<std::streamsize>(postings.size()));
+
+    const char* cursor = dictionary.data();
+    const char* end = dictionary.data() + dictionary.size();
+    std::string term;
+    std::vector<uint64_t> offsets;
+    while (cursor < end) {
+        uint64_t start, count, bytes;
+        if (!readVarintString(cursor, end, term) || !readVarint(cursor, end, start) || !readVarint(cursor, end, count) || !readVarint(cursor, end, bytes)
+            || start + bytes > postings.size()) {
+            return;
+        }
+        offsets.clear();
+        decodePostings(postings.data() + start, postings.data() + start + bytes, count, offsets);
+        function(term, offsets);
+    }
+}
+
+/**
+ * @brief Rewrites the compacted index of a text file and empties its log.
+ *
+ * The old index and the log are merged, and records of the text file covered
+ * by neither are indexed from the text itself. When the text file is shorter
+ * than the indexed range, it was rewritten, and the index is rebuilt from scratch.
+ * The new index is written to a temporary file and renamed over the old one.
+ *
+ * @param textPath The indexed file.
+ * @param reader Splits the file into records.
+ */
+inline void compactTextIndex(const std::string& textPath, const TextRecordReader& reader = forEachTextRecord) {
+    uint64_t textSize = textFileSize(textPath);
+    std::map<std::string, std::vector<uint64_t>> terms;
+    uint64_t covered = 0;
+
+    {
+        std::ifstream in(textPath + ".idx", std::ios::binary);
+        TextIndexHeader header;
+        std::vector<std::pair<std::string, uint64_t>> blocks;
+        if (in && readTextIndexHeader(in, header, blocks) && header.indexedBytes <= textSize) {
+            covered = header.indexedBytes;
+            forEachIndexedTerm(in, header, [&](const std::string& term, const std::vector<uint64_t>& offsets) {
+                terms[term] = offsets;
+            });
+        }
+    }
+
+    bool stale = false;
+    forEachTextLogEntry(textPath, [&](uint64_t offset, uint64_t end, const std::vector<std::string>& recordTerms) {
+        if (stale || end > textSize || offset != covered) {
+            stale = true;
+            return;
+        }
+        for (const std::string& term : recordTerms) {
+            terms[term].push_back(offset);
+        }
+        covered = end;
+    });
+    if (stale) {
+        terms.clear();
+        covered = 0;
+    }
+
+    if (covered < textSize) {
+        std::string text = readWholeFile(textPath);
+        reader(text, covered, [&](uint64_t offset, uint64_t, std::string_view record) {
+            for (const std::string& term : tokenizeText(record)) {
+                terms[term].push_back(offset);
+            }
+        });
+        covered = text.size();
+    }
+
+    // Lay out the dictionary, the block index and the postings
+    std::string dictionary;
+    std::string blockIndex;
+    std::string postings;
+    uint64_t termNumber = 0;
+    for (const auto& entry : terms) {
+        if (termNumber % textIndexBlockTerms == 0) {
+            appendVarint(blockIndex, entry.first.size());
+            blockIndex += entry.first;
+            appendVarint(blockIndex, dictionary.size());
+        }
+        size_t start = postings.size();
+        uint64_t previous = 0;
+        for (uint64_t offset : entry.second) {
+            appendVarint(postings, offset - previous);
+            previous = offset;
+        }
+        appendVarint(dictionary, entry.first.size());
+        dictionary += entry.first;
+        appendVarint(dictionary, start);
+        appendVarint(dictionary, entry.second.size());
+        appendVarint(dictionary, postings.size() - start);
+        termNumber++;
+    }
+
+    TextIndexHeader header = {};
+    std::copy(textIndexMagic, textIndexMagic + 8, header.magic);
+    header.indexedBytes = covered;
+    header.termCount = terms.size();
+    header.blockCount = (terms.size() + textIndexBlockTerms - 1) / textIndexBlockTerms;
+    header.blockIndexOffset = sizeof(header) + dictionary.size();
+    header.postingsOffset = header.blockIndexOffset + blockIndex.size();
+
+    std::string temporaryPath = textPath + ".idx.tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(dictionary.data(), static_cast<std::streamsize>(dictionary.size()));
+        out.write(blockIndex.data(), static_cast<std::streamsize>(blockIndex.size()));
+        out.write(postings.data(), static_cast<std::streamsize>(postings.size()));
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, textPath + ".idx", error);
+    std::filesystem::remove(textPath + ".idx.log", error);
+}
+
+/**
+ * @brief Adds the postings of every compacted index term a query word is a prefix of.
+ *
+ * Only the dictionary blocks and posting lists of the query words are read.
+ *
+ * @param in The open index file.
+ * @param header Header of the index.
+ * @param blocks Block index of the index.
+ * @param words Query words.
+ * @param matches Receives the sorted, distinct offsets matching every word.
+ */
+inline void collectIndexedMatches(std::ifstream& in, const TextIndexHeader& header, const std::vector<std::pair<std::string, uint64_t>>& blocks,
+    const std::vector<std::string>& words, std::vector<std::vector<uint64_t>>& matches) {
+    for (size_t w = 0; w < words.size(); ++w) {
+        const std::string& word = words[w];
+        // Start at the last block whose first term sorts before the word
+        auto block = std::lower_bound(blocks.begin(), blocks.end(), word, [](const std::pair<std::string, uint64_t>& entry, const std::string& value) {
+            return entry.first < value;
+        });
+        if (block != blocks.begin()) {
+            --block;
+        }
+
+        std::string term;
+        for (; block != blocks.end(); ++block) {
+            uint64_t blockEnd = block + 1 != blocks.end() ? (block + 1)->second : header.blockIndexOffset - sizeof(header);
+            std::string dictionary(static_cast<size_t>(blockEnd - block->second), '\0');
+            in.seekg(static_cast<std::streamoff>(sizeof(header) + block->second));
+            in.read(&dictionary[0], static_cast<std::streamsize>(dictionary.size()));
+
+            const char* cursor = dictionary.data();
+            const char* end = dictionary.data() + dictionary.size();
+            bool pastPrefix = false;
+            while (cursor < end) {
+                uint64_t start, count, bytes;
+                if (!readVarintString(cursor, end, term) || !readVarint(cursor, end, start) || !readVarint(cursor, end, count) || !readVarint(cursor, end, bytes)) {
+                    break;
+                }
+                if (term.compare(0, word.size(), word) < 0) {
+                    continue;
+                }
+                if (term.compare(0, word.size(), word) > 0) {
+                    pastPrefix = true;
+                    break;
+                }
+                std::string postings(static_cast<size_t>(bytes), '\0');
+                in.seekg(static_cast<std::streamoff>(header.postingsOffset + start));
+                in.read(&postings[0], static_cast<std::streamsize>(postings.size()));
+                decodePostings(postings.data(), postings.data() + postings.size(), count, matches[w]);
+            }
+            if (pastPrefix) {
+                break;
+            }
+        }
+
+        std::sort(matches[w].begin(), matches[w].end());
+        matches[w].erase(std::unique(matches[w].begin(), matches[w].end()), matches[w].end());
+    }
+}
+
+/**
+ * @brief Intersects the offsets matching every query word, starting from the rarest word.
+ */
+inline std::vector<uint64_t> intersectMatches(std::vector<std::vector<uint64_t>>& matches) {
+    std::sort(matches.begin(), matches.end(), [](const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+        return a.size() < b.size();
+    });
+    std::vector<uint64_t> result = matches[0];
+    for (size_t w = 1; w < matches.size() && !result.empty(); ++w) {
+        std::vector<uint64_t> both;
+        std::set_intersection(result.begin(), result.end(), matches[w].begin(), matches[w].end(), std::back_inserter(both));
+        result.swap(both);
+    }
+    return result;
+}
+
+/**
+ * @brief Finds the records of a text file containing every word of a query.
+ *
+ * Each query word matches the indexed words it is a prefix of, so "brake" finds
+ * "brakes". The log is scanned in full. When the index does not cover the whole
+ * text file, it is compacted first.
+ *
+ * @param textPath The indexed file.
+ * @param query Words to search for.
+ * @param reader Splits the file into records when it has to be compacted.
+ * @return std::vector<uint64_t> Offsets of the matching records in ascending order.
+ */
+inline std::vector<uint64_t> searchTextIndex(const std::string& textPath, std::string_view query, const TextRecordReader& reader = forEachTextRecord) {
+    std::vector<std::string> words = tokenizeText(query);
+    if (words.empty()) {
+        return {};
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        uint64_t textSize = textFileSize(textPath);
+        std::ifstream in(textPath + ".idx", std::ios::binary);
+        TextIndexHeader header = {};
+        std::vector<std::pair<std::string, uint64_t>> blocks;
+        bool valid = in && readTextIndexHeader(in, header, blocks);
+
+        // Collect the log matches while checking the log continues the index
+        uint64_t covered = valid ? header.indexedBytes : 0;
+        bool contiguous = valid;
+        std::vector<std::vector<uint64_t>> matches(words.size());
+        forEachTextLogEntry(textPath, [&](uint64_t offset, uint64_t end, const std::vector<std::string>& recordTerms) {
+            contiguous = contiguous && offset == covered;
+            covered = end;
+            for (size_t w = 0; w < words.size(); ++w) {
+                auto first = std::lower_bound(recordTerms.begin(), recordTerms.end(), words[w]);
+                if (first != recordTerms.end() && first->compare(0, words[w].size(), words[w]) == 0) {
+                    matches[w].push_back(offset);
+                }
+            }
+        });
+        if (!contiguous || covered != textSize) {
+            if (attempt == 0) {
+                in.close();
+                compactTextIndex(textPath, reader);
+                continue;
+            }
+            return {};
+        }
+
+        collectIndexedMatches(in, header, blocks, words, matches);
+        return intersectMatches(matches);
+    }
+    return {};
+}
+
+/**
+ * @brief Finds the records containing every word of a query in an index that no longer changes.
+ *
+ * Used for files that were moved into read-only storage together with their
+ * compacted index, so there is neither a log nor a text file to check.
+ *
+ * @param indexPath Path of the compacted index.
+ * @param query Words to search for.
+ * @return std::vector<uint64_t> Offsets of the matching records in ascending order.
+ */
+inline std::vector<uint64_t> searchSealedTextIndex(const std::string& indexPath, std::string_view query) {
+    std::vector<std::string> words = tokenizeText(query);
+    std::ifstream in(indexPath, std::ios::binary);
+    TextIndexHeader header = {};
+    std::vector<std::pair<std::string, uint64_t>> blocks;
+    if (words.empty() || !in || !readTextIndexHeader(in, header, blocks)) {
+        return {};
+    }
+    std::vector<std::vector<uint64_t>> matches(words.size());
+    collectIndexedMatches(in, header, blocks, words, matches);
+    return intersectMatches(matches);
+}
+
+/**
+ * @brief Reads the record starting at an offset of a text file.
+ *
+ * @param textPath The text file.
+ * @param offset Offset of the record.
+ * @return std::string The lines of the record without the terminating empty line.
+ */
+inline std::string readTextRecord(const std::string& textPath, uint64_t offset) {
+    std::ifstream in(textPath, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(offset));
+
+    std::string record;
+    std::string line;
+    while (std::getline(in, line) && !line.empty() && line != "\r") {
+        record += line + "\n";
+    }
+    return record;
+}
+
+#endif // TEXT_INDEX_H
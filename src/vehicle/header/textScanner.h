@@ -0,0 +1,166 @@
+/**
+ * @file textScanner.h
+ *
+ * @brief Provides allocation-free scanning of whitespace separated text files with positioned errors
+ */
+
+#ifndef TEXT_SCANNER_H
+#define TEXT_SCANNER_H
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @struct ParseError
+ * @brief Position and cause of the first field of a line that could not be parsed.
+ */
+struct ParseError {
+    size_t line = 0;                ///< Line number, from 1.
+    size_t column = 0;              ///< Column of the field, from 1.
+    const char* expected = "";      ///< Description of the field that was expected there.
+
+    /**
+     * @brief Formats the error as "file:line:column: expected field".
+     *
+     * @param fileName Name of the parsed file.
+     * @return std::string The message.
+     */
+    std::string describe(std::string_view fileName) const {
+        return std::string(fileName) + ":" + std::to_string(line) + ":" + std::to_string(column) + ": expected " + expected;
+    }
+};
+
+/**
+ * @class LineScanner
+ * @brief Splits a text held in memory into lines, counting them.
+ *
+ * Lines are returned without their line break; a carriage return before the
+ * line feed is dropped as well.
+ */
+class LineScanner {
+public:
+    /**
+     * @brief Starts scanning a text; the text must outlive the scanner.
+     */
+    explicit LineScanner(std::string_view text) : text(text) {}
+
+    /**
+     * @brief Moves to the next line.
+     *
+     * @param line Receives the line.
+     * @return false once the text is exhausted.
+     */
+    bool next(std::string_view& line) {
+        if (position >= text.size()) {
+            return false;
+        }
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        line = text.substr(position, end - position);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        position = end + 1;
+        number++;
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of the line last returned by next(), from 1.
+     */
+    size_t lineNumber() const {
+        return number;
+    }
+
+private:
+    std::string_view text;      ///< The scanned text.
+    size_t position = 0;        ///< Start of the next line.
+    size_t number = 0;          ///< Number of the current line.
+};
+
+/**
+ * @class FieldScanner
+ * @brief Reads blank separated fields from one line.
+ *
+ * Numbers are parsed with std::from_chars, so parsing neither allocates nor
+ * depends on the locale. A number must end at a blank or at the end of the line.
+ */
+class FieldScanner {
+public:
+    /**
+     * @brief Starts scanning a line; the line must outlive the scanner.
+     */
+    explicit FieldScanner(std::string_view line) : line(line) {}
+
+    /**
+     * @brief Returns whether only blanks are left.
+     */
+    bool atEnd() {
+        skipBlanks();
+        return position == line.size();
+    }
+
+    /**
+     * @brief Returns the column of the next field, from 1.
+     */
+    size_t column() {
+        skipBlanks();
+        return position + 1;
+    }
+
+    /**
+     * @brief Reads the next field as it is.
+     *
+     * @param word Receives the field.
+     * @return true if there was a field.
+     */
+    bool readWord(std::string_view& word) {
+        skipBlanks();
+        size_t start = position;
+        while (position < line.size() && !isBlank(line[position])) {
+            position++;
+        }
+        word = line.substr(start, position - start);
+        return !word.empty();
+    }
+
+    /**
+     * @brief Reads the next field as a number; on failure nothing is consumed.
+     *
+     * @param value Receives the number.
+     * @return true if the field is a number.
+     */
+    template <typename Number>
+    bool readNumber(Number& value) {
+        skipBlanks();
+        const char* first = line.data() + position;
+        const char* last = line.data() + line.size();
+        std::from_chars_result result = std::from_chars(first, last, value);
+        if (result.ec != std::errc() || (result.ptr != last && !isBlank(*result.ptr))) {
+            return false;
+        }
+        position = static_cast<size_t>(result.ptr - line.data());
+        return true;
+    }
+
+private:
+    static bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    void skipBlanks() {
+        while (position < line.size() && isBlank(line[position])) {
+            position++;
+        }
+    }
+
+    std::string_view line;      ///< The scanned line.
+    size_t position = 0;        ///< Start of the unread part of the line.
+};
+
+#endif // TEXT_SCANNER_H
@@ -0,0 +1,80 @@
+/**
+ * @file varint.h
+ *
+ * @brief Provides variable-length integer encoding for the on-disk indexes and archives
+ */
+
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Appends an unsigned LEB128 varint.
+ *
+ * @param out Buffer to append to.
+ * @param value Value to encode.
+ */
+inline void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Reads an unsigned LEB128 varint.
+ *
+ * @param cursor Read position; advanced past the varint.
+ * @param end End of the buffer.
+ * @param value Receives the decoded value.
+ * @return true if a complete varint was read.
+ */
+inline bool readVarint(const char*& cursor, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; cursor < end && shift < 64; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*cursor++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reads a length-prefixed string.
+ */
+inline bool readVarintString(const char*& cursor, const char* end, std::string& value) {
+    uint64_t length;
+    if (!readVarint(cursor, end, length) || length > static_cast<uint64_t>(end - cursor)) {
+        return false;
+    }
+    value.assign(cursor, static_cast<size_t>(length));
+    cursor += length;
+    return true;
+}
+
+/**
+ * @brief Maps a signed value to an unsigned one so small magnitudes encode in few bytes.
+ *
+ * @param value Signed value.
+ * @return uint64_t 0, -1, 1, -2, ... mapped to 0, 1, 2, 3, ...
+ */
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Inverts zigzagEncode.
+ *
+ * @param value Encoded value.
+ * @return int64_t The signed value.
+ */
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+#endif // VARINT_H
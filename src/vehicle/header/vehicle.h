@@ -5,6 +5,22 @@
  */
 
 #include "../../utility/header/commonTypes.h"
+#include "mpscQueue.h"
+#include "metrics.h"
+#include "recordArena.h"
+#include "modelName.h"
+#include "searchIndex.h"
+#include "textIndex.h"
+#include "textScanner.h"
+#include "parallelChunks.h"
+#include "dayNumber.h"
+#include "columnArchive.h"
+#include "lzSegment.h"
+#include "lazySubsystem.h"
+#include "snapshotImage.h"
+#include "slotScheduler.h"
+#include "priorityQueue.h"
+#include "recurrence.h"
 
  /**
   * @brief The "using namespace std;" directive is employed to simplify code by allowing direct access
@@ -66,22 +82,87 @@ const char* feedbackfileName = "../../../files/feedback.txt";
  */
 const char* commonissuesfileName = "../../../files/commonissues.txt";
 
+/**
+ * @brief Path to the file receiving the metrics in the Prometheus text format.
+ *        Used in the vehicle management system.
+ */
+const char* metricsPrometheusfileName = "../../../files/metrics.prom";
+
+/**
+ * @brief Path to the file receiving the metrics as JSON.
+ *        Used in the vehicle management system.
+ */
+const char* metricsJsonfileName = "../../../files/metrics.json";
+
+/**
+ * @brief Path to the columnar archive of appointments and service reports.
+ *        Used in the vehicle management system.
+ */
+const char* archivefileName = "../../../files/service_archive.col";
+
+/**
+ * @brief Path to the snapshot image of the vehicle and part registries.
+ *        Used in the vehicle management system.
+ */
+const char* snapshotfileName = "../../../files/state.snap";
+
+/**
+ * @brief Path to the file storing recurring appointment contracts.
+ *        Used in the vehicle management system.
+ */
+const char* recurringfileName = "../../../files/recurring.dat";
+
+/**
+ * @brief Path to the file storing the last saved labor cost quote.
+ *        Used in the vehicle management system.
+ */
+const char* quotefileName = "../../../files/quote.txt";
+
 
 
 /**
  * @struct Vehicle
  * @brief Represents a vehicle with relevant information.
+ *        The text fields are polymorphic strings, so vehicles held by the
+ *        registry keep their bytes in the vehicle arena. The model is interned.
  */
 struct Vehicle {
     int vehicleID;                ///< Unique identifier for the vehicle.
     long long int customerID;      ///< Unique identifier for the customer associated with the vehicle.
-    string customerName;           ///< Name of the customer.
-    string model;                  ///< Model of the vehicle.
-    string plateNumber;            ///< License plate number of the vehicle.
+    pmr::string customerName;      ///< Name of the customer.
+    ModelName model;               ///< Model of the vehicle.
+    pmr::string plateNumber;       ///< License plate number of the vehicle.
     Vehicle* next;                 ///< Pointer to the next vehicle in a linked list.
     Vehicle* prev;                 ///< Pointer to the previous vehicle in a linked list.
 };
 
+/**
+ * @brief Sizes of the fixed-width text fields of a VehicleRecord, including the terminating zero.
+ */
+const int vehicleRecordNameLength = 32;
+const int vehicleRecordModelLength = 32;
+const int vehicleRecordPlateLength = 16;
+
+/**
+ * @struct VehicleRecord
+ * @brief Fixed-width on-disk layout of a vehicle in the vehicle file.
+ *        Text fields are stored inline, zero padded, and truncated to fit,
+ *        so the file can be written and read by any process.
+ */
+struct VehicleRecord {
+    int32_t vehicleID;                                  ///< Unique identifier for the vehicle.
+    int32_t reserved;                                   ///< Padding, always zero.
+    int64_t customerID;                                 ///< Unique identifier for the customer.
+    char customerName[vehicleRecordNameLength];         ///< Name of the customer.
+    char model[vehicleRecordModelLength];               ///< Model of the vehicle.
+    char plateNumber[vehicleRecordPlateLength];         ///< License plate number of the vehicle.
+};
+
+/**
+ * @brief Number of vehicle records read from the vehicle file with one read call.
+ */
+const size_t vehicleLoadBlockRecords = 4096;
+
 /**
  * @struct Appointment
  * @brief Represents an appointment for vehicle service.
@@ -90,6 +171,9 @@ struct Appointment {
     int vehicleID;                 ///< Identifier linking the appointment to a specific vehicle.
     string customerName;           ///< Name of the customer associated with the appointment.
     string appointmentType;        ///< Type of appointment (e.g., Repair, Maintenance).
+    int priority = 0;              ///< Served before lower priorities booked on the same day; 0 is routine.
+    int bay = -1;                  ///< Booked service bay, from 0; -1 when no bay was booked.
+    int firstSlot = -1;            ///< First booked slot of the day, from 0; -1 when no bay was booked.
 };
 
 /**
@@ -109,9 +193,11 @@ struct Date {
  *        - Outer vector: Represents the years dimension.
  *        - Middle vector: Represents the months dimension.
  *        - Inner vector: Represents the days dimension.
- *        - Queue: Represents the container for storing Appointment objects.
+ *        - Queue: Represents the container for storing Appointment objects,
+ *          ordered by priority and then by booking order.
+ *        Cells are indexed by calendar year, month and day; only dates that exist are used.
  */
-std::vector<std::vector<std::vector<std::queue<Appointment>>>> appointmentMatrix;
+std::vector<std::vector<std::vector<PriorityQueue<Appointment>>>> appointmentMatrix;
 
 /**
  * @struct Part
@@ -120,7 +206,7 @@ std::vector<std::vector<std::vector<std::queue<Appointment>>>> appointmentMatrix
 struct Part {
     int partID;                    ///< Unique identifier for the part.
     string name;                   ///< Name of the part.
-    string compatiblemodel;        ///< Model compatibility information for the part.
+    ModelName compatiblemodel;     ///< Model compatibility information for the part.
     float price;                   ///< Price of the part.
 };
 
@@ -133,6 +219,112 @@ struct PriceResult {
     float amountWithoutLabor;      ///< Total amount excluding labor costs.
 };
 
+/**
+ * @struct QuoteLine
+ * @brief Part on a quote with the number of times it is used.
+ */
+struct QuoteLine {
+    int partID;                    ///< Identifier of the part.
+    string name;                   ///< Name of the part.
+    float price;                   ///< Price of one part when it was quoted.
+    int quantity;                  ///< Number of parts, at least 1.
+};
+
+/**
+ * @struct Quote
+ * @brief Parts priced for one vehicle model, with totals kept up to date as parts are added and removed.
+ */
+struct Quote {
+    string model;                  ///< Vehicle model the parts are for.
+    vector<QuoteLine> lines;       ///< Quoted parts, sorted by part ID.
+    double partsAmount = 0;        ///< Sum of the part prices.
+    double laborAmount = 0;        ///< Sum of the labor fees of the parts.
+};
+
+/**
+ * @enum ServiceKind
+ * @brief Document a service record stands for.
+ */
+enum ServiceKind : int32_t {
+    ServiceReport = 0,             ///< Service report kept in the history file.
+    ServiceWarranty = 1,           ///< Repair warranty, valid for one month.
+    ServiceMaintenance = 2         ///< Maintenance, due again after one year.
+};
+
+/**
+ * @brief Sizes of the fixed-width fields of a ServiceRecord; text fields include the terminating zero.
+ */
+const int serviceRecordNameLength = 32;
+const int serviceRecordTypeLength = 24;
+const int serviceRecordMaxParts = 8;
+
+/**
+ * @struct ServiceRecord
+ * @brief Fixed-width on-disk layout of a history, warranty or maintenance entry.
+ *        The text shown to the user is rendered from these fields on demand.
+ */
+struct ServiceRecord {
+    int32_t kind;                                       ///< ServiceKind of the record.
+    int32_t vehicleID;                                  ///< Serviced vehicle.
+    Date date;                                          ///< Date of the service.
+    int32_t partCount;                                  ///< Number of used entries in partIDs.
+    int32_t partIDs[serviceRecordMaxParts];             ///< Parts used by the service.
+    float partsAmount;                                  ///< Price of the parts.
+    float laborAmount;                                  ///< Labor fee.
+    char customerName[serviceRecordNameLength];         ///< Name of the customer.
+    char serviceType[serviceRecordTypeLength];          ///< Type of the appointment (e.g., Repair, Maintenance).
+};
+
+/**
+ * @brief Identifies a service file made of ServiceRecords. Older versions kept the
+ *        rendered text of the entries instead, and their files do not start with it.
+ */
+const char serviceFileMagic[8] = "VSREC01";
+
+/**
+ * @struct ServiceFileHeader
+ * @brief Header at the start of a service file and of its compressed segments.
+ *        It is one record wide, so the records stay aligned to the segment blocks.
+ */
+struct ServiceFileHeader {
+    char magic[8];                                      ///< serviceFileMagic.
+    uint32_t version;                                   ///< Layout version of the records.
+    int32_t openedMonth;                                ///< Month the live file was started in, as year * 12 + month - 1.
+    char reserved[sizeof(ServiceRecord) - 16];          ///< Padding, always zero.
+};
+static_assert(sizeof(ServiceFileHeader) == sizeof(ServiceRecord), "The header must be one record wide");
+
+/**
+ * @brief Layout version of the service records.
+ */
+const uint32_t serviceFileVersion = 1;
+
+/**
+ * @brief Suffix a service file in the old text format is renamed to before records are written to its name.
+ */
+const char* serviceLegacySuffix = ".legacy.txt";
+
+/**
+ * @brief Number of service records read from a service file with one read call.
+ */
+const size_t serviceLoadBlockRecords = 4096;
+
+/**
+ * @brief Suffix of the compressed segments a service file is rotated into, one per month it was written in.
+ */
+const char* serviceSegmentSuffix = ".seg";
+
+/**
+ * @struct MonthlyServiceStats
+ * @brief Appointment and service totals of one month.
+ */
+struct MonthlyServiceStats {
+    int month;                     ///< Month, 1 to 12.
+    size_t appointments;           ///< Booked appointments.
+    size_t services;               ///< Service reports.
+    double revenue;                ///< Parts and labor charged by the service reports.
+};
+
 /**
  * @var int partID
  * @brief Global variable representing the current part identifier.
@@ -140,10 +332,23 @@ struct PriceResult {
 int partID = 1;
 
 /**
- * @var unordered_map<string, Part> partHash
+ * @var pmr::synchronized_pool_resource partPool
+ * @brief Pool the nodes of partHash are allocated from.
+ *        Nodes freed when the parts are reloaded are reused by the next load.
+ */
+pmr::synchronized_pool_resource partPool;
+
+/**
+ * @var pmr::unordered_map<string, Part> partHash
  * @brief Hash map storing parts with their names as keys.
  */
-unordered_map<string, Part> partHash;
+pmr::unordered_map<string, Part> partHash(&partPool);
+
+/**
+ * @var vector<vector<int>> modelPartIndex
+ * @brief IDs of the parts compatible with each model, indexed by model ID.
+ */
+vector<vector<int>> modelPartIndex;
 
 /**
  * @var int vehicleID
@@ -155,4 +360,494 @@ int vehicleID = 1;
  * @var Vehicle* headVehicle
  * @brief Pointer to the head of a linked list containing vehicle information.
  */
-Vehicle* headVehicle;
\ No newline at end of file
+Vehicle* headVehicle;
+
+/**
+ * @var Vehicle* tailVehicle
+ * @brief Pointer to the last vehicle of the list, so a registration links in constant time.
+ */
+Vehicle* tailVehicle;
+
+/**
+ * @var unique_ptr<RecordArena<Vehicle>> vehicleArena
+ * @brief Arena owning the vehicles loaded from the vehicle file or registered by value.
+ *        It is replaced, and the previous one released at once, when the vehicles are reloaded.
+ *        Vehicles linked from outside the arena stay owned by their caller.
+ */
+unique_ptr<RecordArena<Vehicle>> vehicleArena = make_unique<RecordArena<Vehicle>>();
+
+/**
+ * @struct Customer
+ * @brief Represents a customer and the vehicles registered to them.
+ */
+struct Customer {
+    long long int customerID;      ///< Unique identifier for the customer.
+    string name;                   ///< Name of the customer, taken from their latest registered vehicle.
+    vector<int> vehicleIDs;        ///< IDs of the customer's vehicles in registration order.
+};
+
+/**
+ * @var unordered_map<long long, Customer> customerTable
+ * @brief Customers of the registered vehicles keyed by customer ID.
+ */
+unordered_map<long long, Customer> customerTable;
+
+/**
+ * @var unordered_map<int, Vehicle*> vehicleIndex
+ * @brief Registered vehicles keyed by vehicle ID.
+ */
+unordered_map<int, Vehicle*> vehicleIndex;
+
+/**
+ * @var unordered_map<string, int> plateIndex
+ * @brief Vehicle IDs keyed by normalized plate number (see normalizePlate).
+ */
+unordered_map<string, int> plateIndex;
+
+/**
+ * @brief Number of lock shards guarding the appointment store.
+ *        Each (year, month) row of the appointment matrix maps to one shard,
+ *        so bookings on different months never contend for the same lock.
+ */
+const int appointmentLockShards = 64;
+
+/**
+ * @struct LockShard
+ * @brief Reader-writer lock padded to its own cache line to avoid false sharing between shards.
+ */
+struct alignas(64) LockShard {
+    std::shared_mutex mutex;       ///< Lock guarding the appointment rows mapped to this shard.
+};
+
+/**
+ * @var std::shared_mutex vehicleRegistryMutex
+ * @brief Guards the vehicle linked list (headVehicle, tailVehicle), vehicleArena, vehicleID,
+ *        vehicleIndex, plateIndex and customerTable.
+ *        Lookups and list pages take it shared, mutations take it exclusive.
+ */
+std::shared_mutex vehicleRegistryMutex;
+
+/**
+ * @var std::mutex vehicleFileMutex
+ * @brief Serializes writes to the vehicle file so concurrent appends and rewrites cannot interleave.
+ */
+std::mutex vehicleFileMutex;
+
+/**
+ * @var std::mutex partFileMutex
+ * @brief Serializes appends to the parts file.
+ */
+std::mutex partFileMutex;
+
+/**
+ * @var std::mutex textIndexMutex
+ * @brief Serializes appends to the report and feedback files with the updates and searches of their word indexes.
+ */
+std::mutex textIndexMutex;
+
+/**
+ * @var std::shared_mutex partRegistryMutex
+ * @brief Guards partHash, modelPartIndex and partID.
+ *        Lookups and list pages take it shared, mutations take it exclusive.
+ */
+std::shared_mutex partRegistryMutex;
+
+/**
+ * @var std::atomic<uint64_t> partRegistryVersion
+ * @brief Changed whenever parts are added, loaded or restored; cached quotes of an older version are priced again.
+ */
+std::atomic<uint64_t> partRegistryVersion{ 0 };
+
+/**
+ * @struct CachedQuote
+ * @brief Quote kept for reuse with the part registry version it was priced at.
+ */
+struct CachedQuote {
+    uint64_t partsVersion;         ///< Value of partRegistryVersion when the quote was priced.
+    Quote quote;                   ///< The quote.
+};
+
+/**
+ * @brief Number of quotes kept in quoteCache; the cache is emptied when it would grow beyond it.
+ */
+const size_t quoteCacheLimit = 4096;
+
+/**
+ * @var unordered_map<string, CachedQuote> quoteCache
+ * @brief Priced quotes by quoteKey, so repeated standard jobs are not priced again.
+ */
+unordered_map<string, CachedQuote> quoteCache;
+
+/**
+ * @var std::mutex quoteCacheMutex
+ * @brief Guards quoteCache; never held together with partRegistryMutex.
+ */
+std::mutex quoteCacheMutex;
+
+/**
+ * @var std::shared_mutex appointmentMatrixMutex
+ * @brief Guards the shape of appointmentMatrix.
+ *        Taken shared by every cell access and exclusive only when the matrix is resized.
+ */
+std::shared_mutex appointmentMatrixMutex;
+
+/**
+ * @var LockShard appointmentLocks
+ * @brief Sharded locks guarding the appointment queues of appointmentMatrix.
+ */
+LockShard appointmentLocks[appointmentLockShards];
+
+
+/**
+ * @struct PendingAppointment
+ * @brief Booking waiting in the intake queue to be committed to the appointment store.
+ */
+struct PendingAppointment {
+    Date date;                     ///< Requested date of the appointment.
+    Appointment appointment;       ///< The appointment to book.
+};
+
+/**
+ * @brief Maximum number of bookings the committer drains and persists with one grouped write.
+ */
+const size_t appointmentCommitBatchSize = 256;
+
+/**
+ * @var MpscQueue<PendingAppointment> appointmentIntake
+ * @brief Lock-free intake queue in front of the appointment store.
+ *        Any thread may submit bookings; only the committer drains it.
+ */
+MpscQueue<PendingAppointment> appointmentIntake;
+
+/**
+ * @var std::atomic<bool> appointmentCommitterRunning
+ * @brief Set while the committer thread is draining the intake queue.
+ */
+std::atomic<bool> appointmentCommitterRunning(false);
+
+/**
+ * @var std::thread appointmentCommitter
+ * @brief Single consumer thread of appointmentIntake.
+ */
+std::thread appointmentCommitter;
+
+/**
+ * @var std::mutex appointmentIntakeWaitMutex
+ * @brief Mutex the idle committer sleeps on; never taken on the submit path.
+ */
+std::mutex appointmentIntakeWaitMutex;
+
+/**
+ * @var std::condition_variable appointmentIntakeSignal
+ * @brief Wakes the idle committer when bookings are submitted.
+ */
+std::condition_variable appointmentIntakeSignal;
+
+/**
+ * @struct RejectedLine
+ * @brief Line of a loaded file that could not be parsed.
+ */
+struct RejectedLine {
+    ParseError error;              ///< Position and cause; the line number counts from the start of the piece.
+    string_view line;              ///< Text of the line.
+};
+
+/**
+ * @struct AppointmentLoadChunk
+ * @brief Appointments parsed from one piece of an appointments file.
+ */
+struct AppointmentLoadChunk {
+    vector<vector<PendingAppointment>> byWorker;   ///< Appointments in file order, grouped by the worker storing their month.
+    vector<RejectedLine> rejected;                 ///< Malformed lines of the piece.
+    size_t lines = 0;                              ///< Number of lines in the piece.
+};
+
+/**
+ * @brief Number of appointments a single-threaded load parses before storing them.
+ */
+const size_t appointmentLoadBatch = 4096;
+
+/**
+ * @struct PartLoadChunk
+ * @brief Parts parsed from one piece of a parts file.
+ */
+struct PartLoadChunk {
+    vector<Part> parts;                            ///< Parts in file order, not yet numbered.
+    vector<RejectedLine> rejected;                 ///< Malformed lines of the piece.
+    size_t lines = 0;                              ///< Number of lines in the piece.
+};
+
+/**
+ * @struct VehicleAppointment
+ * @brief Booked appointment as kept in the per-vehicle appointment index.
+ */
+struct VehicleAppointment {
+    CalendarDay day;               ///< Day of the appointment.
+    string appointmentType;        ///< Type of appointment (e.g., Repair, Maintenance).
+};
+
+/**
+ * @var unordered_map<int, vector<VehicleAppointment>> vehicleAppointments
+ * @brief Appointments booked for each vehicle ID, sorted by date.
+ *        Unlike the appointment queues it is not drained by listing or writing appointments.
+ */
+unordered_map<int, vector<VehicleAppointment>> vehicleAppointments;
+
+/**
+ * @var std::shared_mutex vehicleAppointmentsMutex
+ * @brief Guards vehicleAppointments.
+ *        When taken together with vehicleRegistryMutex, the registry lock is taken first.
+ */
+std::shared_mutex vehicleAppointmentsMutex;
+
+/**
+ * @brief Number of days two appointments of the same vehicle must lie apart; closer ones conflict.
+ *        With 7, a vehicle is booked at most once per day and once in any week.
+ */
+const int appointmentConflictDays = 7;
+
+/**
+ * @struct AppointmentConflict
+ * @brief Two appointments of one vehicle booked less than appointmentConflictDays apart.
+ */
+struct AppointmentConflict {
+    int vehicleID;                 ///< The vehicle booked twice.
+    VehicleAppointment first;      ///< The earlier appointment.
+    VehicleAppointment second;     ///< The later appointment, possibly on the same day.
+};
+
+/**
+ * @struct RecurringAppointment
+ * @brief Appointment repeated by a maintenance contract; its visits are computed when a range of days is viewed.
+ */
+struct RecurringAppointment {
+    Appointment appointment;       ///< Vehicle, customer and type of every visit.
+    Recurrence recurrence;         ///< Days of the visits.
+};
+
+/**
+ * @var vector<RecurringAppointment> recurringAppointments
+ * @brief Recurring appointment contracts in the order they were made.
+ *        Their visits are not added to the appointment matrix.
+ */
+vector<RecurringAppointment> recurringAppointments;
+
+/**
+ * @var std::shared_mutex recurringAppointmentsMutex
+ * @brief Guards recurringAppointments.
+ */
+std::shared_mutex recurringAppointmentsMutex;
+
+/**
+ * @brief Layout version of the snapshot records; images of another version are ignored.
+ */
+const uint32_t snapshotVersion = 3;
+
+/**
+ * @enum SnapshotTag
+ * @brief Sections of the snapshot image.
+ */
+enum SnapshotTag : uint32_t {
+    SnapshotModels = 1,            ///< SnapshotText of every interned model name, by model ID.
+    SnapshotModelStrings,          ///< Bytes of the model names.
+    SnapshotVehicleSource,         ///< SnapshotSource of the vehicle file.
+    SnapshotVehicles,              ///< SnapshotVehicle of every vehicle, in list order.
+    SnapshotPlates,                ///< SnapshotPlate of every plate index entry.
+    SnapshotCustomers,             ///< SnapshotCustomer of every customer.
+    SnapshotCustomerVehicles,      ///< Vehicle IDs of the customers, back to back.
+    SnapshotVehicleStrings,        ///< Bytes of the vehicle, plate and customer strings.
+    SnapshotPartSource,            ///< SnapshotSource of the parts file.
+    SnapshotParts,                 ///< SnapshotPart of every part.
+    SnapshotModelParts,            ///< SnapshotModelIndex of every model with parts.
+    SnapshotModelPartIDs,          ///< Part IDs of the models, back to back.
+    SnapshotPartStrings,           ///< Bytes of the part names and keys.
+    SnapshotAppointmentSource,     ///< SnapshotSource of the appointments file.
+    SnapshotAppointments,          ///< SnapshotAppointment of every booked appointment, by date, each day in queue order.
+    SnapshotAppointmentStrings,    ///< Bytes of the customer names and appointment types.
+    SnapshotBaySchedule,           ///< SnapshotBays of the bay scheduler.
+    SnapshotBayWords               ///< Taken slots of the bay scheduler, by day, then bay.
+};
+
+/**
+ * @struct SnapshotSource
+ * @brief File a registry in the snapshot was loaded from, as it was when the snapshot was taken.
+ *        The registry is only restored while the file still has this size and time.
+ */
+struct SnapshotSource {
+    uint64_t size;                 ///< Size of the file.
+    int64_t modified;              ///< Last write time of the file, in ticks of its clock.
+    int64_t nextID;                ///< Next ID the registry hands out.
+};
+
+/**
+ * @struct SnapshotVehicle
+ * @brief Vehicle as stored in the snapshot.
+ */
+struct SnapshotVehicle {
+    int32_t vehicleID;             ///< Unique identifier for the vehicle.
+    uint32_t model;                ///< Model ID in the snapshot's model table.
+    int64_t customerID;            ///< Unique identifier for the customer.
+    SnapshotText customerName;     ///< Name of the customer.
+    SnapshotText plateNumber;      ///< License plate number of the vehicle.
+    uint32_t indexed;              ///< 1 if this vehicle is the one vehicleIndex holds for its ID.
+    uint32_t reserved;             ///< Padding, always zero.
+};
+
+/**
+ * @struct SnapshotPlate
+ * @brief Plate index entry as stored in the snapshot.
+ */
+struct SnapshotPlate {
+    SnapshotText key;              ///< Normalized plate number.
+    int32_t vehicleID;             ///< Vehicle the plate resolves to.
+};
+
+/**
+ * @struct SnapshotCustomer
+ * @brief Customer as stored in the snapshot.
+ */
+struct SnapshotCustomer {
+    int64_t customerID;            ///< Unique identifier for the customer.
+    SnapshotText name;             ///< Name of the customer.
+    uint32_t firstVehicle;         ///< Position of the customer's first vehicle ID in SnapshotCustomerVehicles.
+    uint32_t vehicleCount;         ///< Number of vehicle IDs of the customer.
+};
+
+/**
+ * @struct SnapshotPart
+ * @brief Part as stored in the snapshot.
+ */
+struct SnapshotPart {
+    int32_t partID;                ///< Unique identifier for the part.
+    uint32_t model;                ///< Model ID in the snapshot's model table.
+    SnapshotText key;              ///< Key of the part in partHash.
+    SnapshotText name;             ///< Name of the part.
+    float price;                   ///< Price of the part.
+    uint32_t reserved;             ///< Padding, always zero.
+};
+
+/**
+ * @struct SnapshotAppointment
+ * @brief Booked appointment as stored in the snapshot.
+ */
+struct SnapshotAppointment {
+    int32_t day;                   ///< Day number of the date, as returned by daysFromCivil.
+    int32_t vehicleID;             ///< Vehicle of the appointment, 0 for none.
+    int32_t priority;              ///< Priority of the appointment.
+    int16_t bay;                   ///< Booked service bay, -1 for none.
+    int16_t firstSlot;             ///< First booked slot of the day, -1 for none.
+    SnapshotText customerName;     ///< Name of the customer.
+    SnapshotText appointmentType;  ///< Type of the appointment.
+};
+
+/**
+ * @struct SnapshotBays
+ * @brief Shape of the bay scheduler as stored in the snapshot.
+ */
+struct SnapshotBays {
+    int32_t firstDay;              ///< Day of the first words in SnapshotBayWords.
+    int32_t bays;                  ///< Number of bays.
+    int32_t slotsPerDay;           ///< Number of slots per bay and day.
+    uint32_t reserved;             ///< Padding, always zero.
+};
+
+/**
+ * @struct SnapshotModelIndex
+ * @brief Entry of the model part index as stored in the snapshot.
+ */
+struct SnapshotModelIndex {
+    uint32_t model;                ///< Model ID in the snapshot's model table.
+    uint32_t firstPart;            ///< Position of the model's first part ID in SnapshotModelPartIDs.
+    uint32_t partCount;            ///< Number of part IDs of the model.
+};
+
+/**
+ * @brief Number of service bays that can work on a vehicle at the same time.
+ */
+const int serviceBays = 4;
+
+/**
+ * @brief Length of a bookable slot and the start and number of slots of a working day.
+ *        The defaults give 40 slots of 15 minutes from 08:00 to 18:00.
+ */
+const int slotMinutes = 15;
+const int workdayStartMinute = 8 * 60;
+const int slotsPerWorkday = 40;
+
+/**
+ * @brief Number of days after the requested date searched for a free bay.
+ */
+const int32_t bookingHorizonDays = 366;
+
+/**
+ * @var unordered_map<string, int> appointmentTypeMinutes
+ * @brief Bay time booked for each appointment type, in minutes.
+ */
+unordered_map<string, int> appointmentTypeMinutes = {
+    { "Repair", 120 },
+    { "Maintenance", 60 },
+    { "Inspection", 30 },
+    { "Warranty", 60 }
+};
+
+/**
+ * @brief Bay time booked for appointment types missing from appointmentTypeMinutes, in minutes.
+ */
+const int defaultAppointmentMinutes = 60;
+
+/**
+ * @var unordered_map<string, int> appointmentTypePriorities
+ * @brief Priority new appointments of each type are booked with; other types are routine (0).
+ *        Warranty recalls go ahead of repairs, and repairs ahead of routine maintenance.
+ */
+unordered_map<string, int> appointmentTypePriorities = {
+    { "Warranty", 2 },
+    { "Repair", 1 }
+};
+
+/**
+ * @var SlotScheduler bayScheduler
+ * @brief Slots taken on every service bay, by day.
+ */
+SlotScheduler bayScheduler(serviceBays, slotsPerWorkday);
+
+/**
+ * @var std::mutex bayScheduleMutex
+ * @brief Guards bayScheduler.
+ */
+std::mutex bayScheduleMutex;
+
+/**
+ * @enum BookingOutcome
+ * @brief Result of booking an appointment.
+ */
+enum BookingOutcome {
+    BookingConfirmed,              ///< The bay slots are taken and the appointment is queued.
+    BookingNoFreeBay,              ///< No bay has room within bookingHorizonDays.
+    BookingVehicleConflict,        ///< The vehicle has another appointment near the first free day.
+    BookingOutsideCalendar         ///< The first free day lies past the end of the appointment matrix.
+};
+
+/**
+ * @var LazySubsystem vehicleSubsystem
+ * @brief Vehicles, customers and their indexes, loaded from vehiclefileName on first use.
+ */
+LazySubsystem vehicleSubsystem("vehicles");
+
+/**
+ * @var LazySubsystem appointmentSubsystem
+ * @brief Appointment matrix and its committer, set up on first use.
+ */
+LazySubsystem appointmentSubsystem("appointments");
+
+/**
+ * @var LazySubsystem partSubsystem
+ * @brief Parts, loaded from partfileName on first use.
+ */
+LazySubsystem partSubsystem("parts");
+
+/**
+ * @var Prefetcher subsystemPrefetcher
+ * @brief Loads the subsystems the user is likely to open next in the background.
+ */
+Prefetcher subsystemPrefetcher;
@@ -5,6 +5,23 @@
  */
 #include "../header/vehicle.h"
 
+/**
+ * @brief Returns the labor fee charged for fitting a part.
+ *
+ * @param price Price of the part.
+ * @return float The fee of the part's price range.
+ */
+float laborFee(float price) {
+    if (price < 500)
+        return 0;
+    else if (price < 2000)
+        return 1000;
+    else if (price < 10000)
+        return 3000;
+    else
+        return 8000;
+}
+
 /**
  * @brief Calculate the total price for a list of selected parts.
  *
@@ -14,6 +31,8 @@
  * @return PriceResult structure containing the total amount and amount without labor.
  */
 PriceResult calculateTotalPrice(const vector<Part>& selectedParts) {
+    VEHICLE_TIMED("calculateTotalPrice");
+
     float totalAmount = 0;         //!< Total amount including labor.
     float amountWithoutLabor = 0;  //!< Amount without labor cost.
 
@@ -22,432 +41,3596 @@ PriceResult calculateTotalPrice(const vector<Part>& selectedParts) {
         amountWithoutLabor += part.price;
 
         // Calculate total amount based on part price ranges.
-        if (part.price < 500)
-            totalAmount += part.price;
-        else if (part.price < 2000)
-            totalAmount += part.price + 1000;
-        else if (part.price < 10000)
-            totalAmount += part.price + 3000;
-        else
-            totalAmount += part.price + 8000;
+        totalAmount += part.price + laborFee(part.price);
     }
 
     return { totalAmount, amountWithoutLabor };
 }
 
 /**
- * @brief Initialize the appointment matrix with given dimensions.
+ * @brief Adds a part to a quote and updates its totals.
  *
- * This function initializes a 3D vector (appointmentMatrix) to store appointments based on date.
+ * A part already on the quote has its quantity raised, at its quoted price.
  *
- * @param years Number of years.
- * @param months Number of months.
- * @param days Number of days.
+ * @param quote The quote.
+ * @param part The part.
  */
-void initializeAppointmentMatrix(int years, int months, int days) {
-    // Resize the appointmentMatrix to the specified dimensions.
-    appointmentMatrix.resize(years + 1);
-    for (int i = 0; i <= years; ++i) {
-        appointmentMatrix[i].resize(months + 1);
-        for (int j = 0; j <= months; ++j) {
-            appointmentMatrix[i][j].resize(days + 1);
-        }
+void addQuotePart(Quote& quote, const Part& part) {
+    auto line = lower_bound(quote.lines.begin(), quote.lines.end(), part.partID,
+        [](const QuoteLine& entry, int id) { return entry.partID < id; });
+    if (line == quote.lines.end() || line->partID != part.partID) {
+        line = quote.lines.insert(line, QuoteLine{ part.partID, part.name, part.price, 0 });
     }
+    line->quantity++;
+    quote.partsAmount += line->price;
+    quote.laborAmount += laborFee(line->price);
 }
 
 /**
- * @brief Writes the appointments to a file.
+ * @brief Removes one of a part from a quote and updates its totals.
  *
- * This function opens the file in append mode and writes the appointments from the
- * appointmentMatrix to the file. Each appointment includes the date and customer name.
+ * @param quote The quote.
+ * @param partID The part.
+ * @return false if the part is not on the quote.
  */
-void writeAppointmentsToFile(const char* fileName) {
-    // Open the file in append mode
-    ofstream file(fileName, ios::app);
-
-    // Loop through the appointment matrix
-    for (int i = 0; i < appointmentMatrix.size(); ++i) {
-        for (int j = 0; j < appointmentMatrix[i].size(); ++j) {
-            for (int k = 0; k < appointmentMatrix[i][j].size(); ++k) {
-                auto& appointments = appointmentMatrix[i][j][k];
-                Date date{ i, j, k };
-
-                // Write each appointment to the file
-                while (!appointments.empty()) {
-                    file << date.day << ' ' << date.month << ' ' << date.year << ' ' << appointments.front().customerName << '\n';
-                    appointments.pop();
-                }
-            }
-        }
+bool removeQuotePart(Quote& quote, int partID) {
+    auto line = lower_bound(quote.lines.begin(), quote.lines.end(), partID,
+        [](const QuoteLine& entry, int id) { return entry.partID < id; });
+    if (line == quote.lines.end() || line->partID != partID) {
+        return false;
+    }
+    quote.partsAmount -= line->price;
+    quote.laborAmount -= laborFee(line->price);
+    if (--line->quantity == 0) {
+        quote.lines.erase(line);
+    }
+    if (quote.lines.empty()) {
+        // No rounding left over from the removed parts
+        quote.partsAmount = 0;
+        quote.laborAmount = 0;
     }
+    return true;
+}
 
-    // Close the file
-    file.close();
+/**
+ * @brief Returns the totals of a quote in the form calculateTotalPrice returns them.
+ *
+ * @param quote The quote.
+ * @return PriceResult The amount with labor and the amount of the parts alone.
+ */
+PriceResult quoteTotals(const Quote& quote) {
+    return { static_cast<float>(quote.partsAmount + quote.laborAmount), static_cast<float>(quote.partsAmount) };
 }
 
 /**
- * @brief Adds an appointment to the matrix.
+ * @brief Returns the key a job is cached under: the model and every part ID with its quantity.
  *
- * Checks if the date is within the matrix bounds and adds the appointment
- * to the appropriate location in the matrix.
+ * @param model The vehicle model.
+ * @param partIDs The parts of the job, in any order; repeated IDs count as quantities.
+ * @return string The key, the same for every order of the same parts.
+ */
+string quoteKey(const string& model, vector<int> partIDs) {
+    sort(partIDs.begin(), partIDs.end());
+    string key = model;
+    for (size_t i = 0; i < partIDs.size();) {
+        size_t next = i;
+        while (next < partIDs.size() && partIDs[next] == partIDs[i]) {
+            next++;
+        }
+        key += ' ' + to_string(partIDs[i]);
+        if (next - i > 1) {
+            key += '*' + to_string(next - i);
+        }
+        i = next;
+    }
+    return key;
+}
+
+/**
+ * @brief Returns the parts of a quote as a job, each part ID repeated by its quantity.
  *
- * @param date The date of the appointment.
- * @param appointment The appointment to be added.
+ * @param quote The quote.
+ * @return The part IDs, sorted.
  */
-void addAppointment(const Date& date, const Appointment& appointment) {
-    appointmentMatrix[date.year][date.month][date.day].push(appointment);
+vector<int> quotePartIDs(const Quote& quote) {
+    vector<int> partIDs;
+    for (const QuoteLine& line : quote.lines) {
+        partIDs.insert(partIDs.end(), line.quantity, line.partID);
+    }
+    return partIDs;
+}
 
+/**
+ * @brief Returns the key a quote is cached under.
+ *
+ * @param quote The quote.
+ * @return string The key quoteKey gives for the model and parts of the quote.
+ */
+string quoteKey(const Quote& quote) {
+    return quoteKey(quote.model, quotePartIDs(quote));
 }
 
 /**
- * @brief Lists appointments for a specific date.
+ * @brief Writes a quote to a file, replacing its contents.
  *
- * Prints the date for which appointments are listed and checks if
- * appointments exist for the given date. If appointments exist, it
- * prints each appointment for the date.
+ * The first line holds the model; each following line holds the part ID,
+ * quantity, quoted price and name of one part, separated by spaces.
  *
- * @param date The date for which appointments are listed.
+ * @param fileName The quote file.
+ * @param quote The quote.
+ * @return false if the file could not be written.
  */
-void listAppointments(const Date& date) {
-    // Print the date for which appointments are listed
-    cout << "Appointments " << date.day + 1 << "." << date.month + 1 << "." << date.year << ":\n";
-
-        int count = 1;
-        // Print each appointment for the date
-        while (!appointmentMatrix[date.year][date.month][date.day].empty()) {
-            cout << count << ". " << appointmentMatrix[date.year][date.month][date.day].front().customerName << "\n";
-            appointmentMatrix[date.year][date.month][date.day].pop();
-            count++;
-        }
+bool saveQuote(const char* fileName, const Quote& quote) {
+    ofstream file(fileName, ios::trunc);
+    file << quote.model << '\n';
+    for (const QuoteLine& line : quote.lines) {
+        file << line.partID << ' ' << line.quantity << ' ' << line.price << ' ' << line.name << '\n';
+    }
+    return static_cast<bool>(file);
 }
 
 /**
- * @brief Reads appointments from a file and adds them to the matrix.
+ * @brief Reads a quote written by saveQuote.
  *
- * This function reads each line from the appointments file, extracts date
- * and customer name information, and adds the appointment to the matrix using
- * the addAppointment function. If the file cannot be opened, an error message
- * is printed to the standard error stream. If the file format is incorrect,
- * an error message is printed for the specific line with incorrect format.
+ * The parts keep the prices they were quoted at, and the totals are summed again from them.
+ *
+ * @param fileName The quote file.
+ * @param quote Receives the quote.
+ * @return false if the file is missing or malformed; the quote is left empty then.
  */
-void readAppointmentsFromFile(const char* fileName) {
-    // Open the file for reading
-    ifstream file(fileName);
-
-    string line;
-    // Read each line from the file
-    while (getline(file, line)) {
-        istringstream iss(line);
-        int day, month, year;
-        string customerName;
-
-        // Extract date and customer name information from the line
-        if (iss >> day >> month >> year >> customerName) {
-            // Create Date and Appointment objects
-            Date date{ year, month, day };
-            Appointment appointment;
-            appointment.customerName = customerName;
-
-            // Add the appointment to the matrix
-            addAppointment(date, appointment);
+bool loadQuote(const char* fileName, Quote& quote) {
+    quote = Quote();
+    string text = readWholeFile(fileName);
+    LineScanner lines(text);
+    string_view line;
+    if (!lines.next(line) || line.empty()) {
+        return false;
+    }
+    quote.model.assign(line);
+
+    while (lines.next(line)) {
+        FieldScanner fields(line);
+        Part part{ 0, string(), ModelName(), 0.0f };
+        int quantity = 0;
+        string_view name;
+        if (!fields.readNumber(part.partID) || !fields.readNumber(quantity) || quantity < 1
+            || !fields.readNumber(part.price) || !fields.readWord(name)) {
+            quote = Quote();
+            return false;
         }
-        else {
-            // Print an error message for incorrect file format
-            cerr << "Incorrect file format: " << line << endl;
+        part.name.assign(name);
+        for (int i = 0; i < quantity; ++i) {
+            addQuotePart(quote, part);
         }
     }
-
-    // Close the file
-    file.close();
+    return true;
 }
 
 /**
- * @brief Creates a report and appends it to a file.
- *
- * This function creates a report with information about the appointment,
- * such as appointment type, customer name, vehicle ID, and date. It appends
- * the report to the specified file.
+ * @brief Returns the index of the lock shard guarding the appointments of a given month.
  *
- * @param filePath The path to the file where the report will be appended.
- * @param appointment The appointment information.
- * @param date The date of the appointment.
+ * @param year Year index of the appointment row.
+ * @param month Month index of the appointment row.
+ * @return Index into appointmentLocks.
  */
-void CreateReport(const string& filePath, const Appointment& appointment, const Date& date) {
-    ofstream outputFile(filePath, ios::app);
+size_t appointmentShardIndex(int year, int month) {
+    unsigned int row = static_cast<unsigned int>(year) * 13u + static_cast<unsigned int>(month);
+    return row % appointmentLockShards;
+}
 
-    stringstream report;
+/**
+ * @brief Returns the lock shard guarding the appointments of a given month.
+ *
+ * @param year Year index of the appointment row.
+ * @param month Month index of the appointment row.
+ * @return Reference to the reader-writer lock guarding that row.
+ */
+std::shared_mutex& appointmentShard(int year, int month) {
+    return appointmentLocks[appointmentShardIndex(year, month)].mutex;
+}
 
-    report << " | The following operation: " << appointment.appointmentType << ", performed to the customer : \n | " << appointment.customerName
-        << " with vehicle ID " << appointment.vehicleID << ", on this date: "
-        << date.day << "/" << date.month << "/" << date.year << "\n";
+/**
+ * @brief Returns the day number of a date, as stored in the archive.
+ *
+ * @param date The date.
+ * @return Days since 1970-01-01.
+ */
+int32_t dayNumber(const Date& date) {
+    return daysFromCivil(date.year, date.month, date.day);
+}
 
-    // Write the report to the specified file
-    outputFile << report.str() << endl;
+/**
+ * @brief Returns a date as a CalendarDay.
+ *
+ * @param date The date; it must exist on the calendar.
+ * @return The day of the date.
+ */
+CalendarDay calendarDay(const Date& date) {
+    return CalendarDay(dayNumber(date));
+}
 
-    // Close the file
-    outputFile.close();
+/**
+ * @brief Returns the calendar date of a day.
+ *
+ * @param day The day.
+ * @return The date with its year, month and day.
+ */
+Date civilDate(CalendarDay day) {
+    Date date{ 0, 0, 0 };
+    day.toCivil(date.year, date.month, date.day);
+    return date;
 }
 
 /**
- * @brief Creates a warranty document and appends it to a file.
+ * @brief Checks whether the appointment matrix has a cell for a date.
  *
- * This function creates a warranty document with information about the appointment,
- * such as appointment type, customer name, vehicle ID, date, and expiration date.
- * It calculates the expiration date (1 month later) and appends the warranty document
- * to the specified file.
+ * The date must exist on the calendar and fall within the dimensions the matrix
+ * was initialized with. The caller holds appointmentMatrixMutex.
  *
- * @param filePath The path to the file where the warranty document will be appended.
- * @param appointment The appointment information.
- * @param date The date of the appointment.
+ * @param date The date.
+ * @return true if the date can be used as a matrix index.
  */
-void CreateWarranty(const string& filePath, const Appointment& appointment, const Date& date) {
-    ofstream outputFile(filePath, ios::app);
-
-    stringstream warranty;
-
-    // Calculate the expiration date (1 month later)
-    Date expirationDate = date;
-    expirationDate.month += 1;
-    if (expirationDate.month > 12) {
-        expirationDate.month = 1;
-        expirationDate.year += 1;
+bool matrixHoldsDate(const Date& date) {
+    if (!isValidCivil(date.year, date.month, date.day) || date.year < 0 || date.year >= static_cast<int>(appointmentMatrix.size())) {
+        return false;
     }
+    const auto& months = appointmentMatrix[date.year];
+    return date.month < static_cast<int>(months.size()) && date.day < static_cast<int>(months[date.month].size());
+}
 
-    warranty << " | " << appointment.appointmentType << ", performed to the customer : \n | " << appointment.customerName
-        << " with vehicle ID " << appointment.vehicleID << ", on this date: "
-        << date.day << "/" << date.month << "/" << date.year << "\n";
+/**
+ * @brief Checks whether appointments can be booked on a date.
+ *
+ * @param date The date.
+ * @return true if the date exists and lies within the appointment matrix.
+ */
+bool isBookableDate(const Date& date) {
+    shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
+    return matrixHoldsDate(date);
+}
 
-    warranty << " | Warranty for repair valid until: " << expirationDate.day << "/" << expirationDate.month << "/"
-        << expirationDate.year << "\n";
+/**
+ * @brief Returns the priority new appointments of a type are booked with.
+ *
+ * @param appointmentType The appointment type.
+ * @return int The priority from appointmentTypePriorities, 0 for other types.
+ */
+int appointmentPriority(const string& appointmentType) {
+    auto priority = appointmentTypePriorities.find(appointmentType);
+    return priority != appointmentTypePriorities.end() ? priority->second : 0;
+}
 
-    // Write the warranty document to the specified file
-    outputFile << warranty.str() << endl;
+/**
+ * @brief Initialize the appointment matrix with given dimensions.
+ *
+ * This function initializes a 3D vector (appointmentMatrix) to store appointments based on date.
+ * The per-vehicle appointment index is reset along with it.
+ *
+ * @param years Number of years.
+ * @param months Number of months.
+ * @param days Number of days.
+ */
+void initializeAppointmentMatrix(int years, int months, int days) {
+    // Resizing changes the matrix shape, so no reader may be inside it.
+    unique_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
 
-    // Close the file
-    outputFile.close();
+    // Resize the appointmentMatrix to the specified dimensions.
+    appointmentMatrix.resize(years + 1);
+    for (int i = 0; i <= years; ++i) {
+        appointmentMatrix[i].resize(months + 1);
+        for (int j = 0; j <= months; ++j) {
+            appointmentMatrix[i][j].resize(days + 1);
+        }
+    }
+
+    unique_lock<shared_mutex> indexLock(vehicleAppointmentsMutex);
+    vehicleAppointments.clear();
 }
 
 /**
- * @brief Creates a maintenance document and appends it to a file.
+ * @brief Writes one appointment in the appointments file format.
  *
- * This function creates a maintenance document with information about the appointment,
- * such as appointment type, customer name, vehicle ID, date, and expiration date.
- * It calculates the expiration date (1 year later) and appends the maintenance document
- * to the specified file.
+ * The line holds the day, month, year and customer name separated by spaces,
+ * followed by the vehicle ID and appointment type when the appointment has a vehicle,
+ * and by the priority when that has a type and is not routine. A typed appointment
+ * with a booked bay also ends with the priority, the bay and the first slot, so the
+ * same slots are taken again when the file is replayed.
  *
- * @param filePath The path to the file where the maintenance document will be appended.
- * @param appointment The appointment information.
+ * @param out The stream to write to.
  * @param date The date of the appointment.
+ * @param appointment The appointment to write.
  */
-void CreateMaintenance(const string& filePath, const Appointment& appointment, const Date& date) {
-    ofstream outputFile(filePath, ios::app);
+void formatAppointmentLine(ostream& out, const Date& date, const Appointment& appointment) {
+    bool booked = appointment.bay >= 0 && !appointment.appointmentType.empty();
+    out << date.day << ' ' << date.month << ' ' << date.year << ' ' << appointment.customerName;
+    if (appointment.vehicleID > 0 || booked) {
+        out << ' ' << appointment.vehicleID;
+        if (!appointment.appointmentType.empty()) {
+            out << ' ' << appointment.appointmentType;
+            if (appointment.priority != 0 || booked) {
+                out << ' ' << appointment.priority;
+            }
+            if (booked) {
+                out << ' ' << appointment.bay << ' ' << appointment.firstSlot;
+            }
+        }
+    }
+    out << '\n';
+}
 
-    stringstream maintenance;
+/**
+ * @brief Writes the appointments to a file.
+ *
+ * This function opens the file in append mode and writes the appointments from the
+ * appointmentMatrix to the file. Each appointment includes the date and customer name.
+ * The appointments of a day are written in priority order. Each month row is
+ * taken out of the matrix under its own shard lock and written after the lock
+ * is released, so no booking waits for the file.
+ */
+void writeAppointmentsToFile(const char* fileName) {
+    VEHICLE_TIMED("writeAppointmentsToFile");
 
-    Date expirationDate = date;
-    expirationDate.year += 1;
+    // Open the file in append mode
+    ofstream file(fileName, ios::app);
 
-    maintenance << " | Maintenance appointment performed for the customer  \n | " << appointment.customerName
-        << " with vehicle ID " << appointment.vehicleID << ", on this date: "
-        << date.day << "/" << date.month << "/" << date.year << "\n";
+    shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
 
-    maintenance << " | Next maintenance date is : " << expirationDate.day << "/" << expirationDate.month << "/"
-        << expirationDate.year << "\n";
+    // Loop through the appointment matrix
+    for (size_t i = 0; i < appointmentMatrix.size(); ++i) {
+        for (size_t j = 0; j < appointmentMatrix[i].size(); ++j) {
+            // Swap the month's queues for empty ones under the shard lock
+            vector<PriorityQueue<Appointment>> days;
+            {
+                unique_lock<shared_mutex> rowLock(appointmentShard(static_cast<int>(i), static_cast<int>(j)));
+                vector<PriorityQueue<Appointment>>& row = appointmentMatrix[i][j];
+                if (all_of(row.begin(), row.end(), [](const PriorityQueue<Appointment>& appointments) { return appointments.empty(); })) {
+                    continue;
+                }
+                days.swap(row);
+                row.resize(days.size());
+            }
 
-    // Write the maintenance document to the specified file
-    outputFile << maintenance.str() << endl;
+            // Write each appointment to the file
+            for (size_t k = 0; k < days.size(); ++k) {
+                Date date{ static_cast<int>(i), static_cast<int>(j), static_cast<int>(k) };
+                while (!days[k].empty()) {
+                    formatAppointmentLine(file, date, days[k].front());
+                    days[k].pop();
+                }
+            }
+        }
+    }
 
     // Close the file
-    outputFile.close();
+    file.close();
 }
 
 /**
- * @brief Creates a feedback entry and appends it to a file.
+ * @brief Records an appointment in the per-vehicle appointment index.
  *
- * This function creates a feedback entry with the provided message and appends
- * it to the specified file.
+ * The vehicle's appointments stay sorted by date; booking the same type on the
+ * same date again, as re-reading the appointments file does, is recorded once.
  *
- * @param filePath The path to the file where the feedback entry will be appended.
- * @param message The feedback message.
+ * @param date The date of the appointment.
+ * @param appointment The appointment; ignored when it has no vehicle.
  */
-void CreateFeedback(const string& filePath, string message) {
-    ofstream outputFile(filePath, ios::app);
-    stringstream feedback;
-
-    feedback << message << "\n";
+void indexVehicleAppointment(const Date& date, const Appointment& appointment) {
+    if (appointment.vehicleID <= 0) {
+        return;
+    }
 
-    // Write the feedback entry to the specified file
-    outputFile << feedback.str() << endl;
+    unique_lock<shared_mutex> indexLock(vehicleAppointmentsMutex);
+    vector<VehicleAppointment>& booked = vehicleAppointments[appointment.vehicleID];
 
-    // Close the file
-    outputFile.close();
+    CalendarDay day = calendarDay(date);
+    auto position = lower_bound(booked.begin(), booked.end(), day,
+        [](const VehicleAppointment& entry, CalendarDay value) { return entry.day < value; });
+    for (auto it = position; it != booked.end() && it->day == day; ++it) {
+        if (it->appointmentType == appointment.appointmentType) {
+            return;
+        }
+    }
+    booked.insert(position, VehicleAppointment{ day, appointment.appointmentType });
 }
 
 /**
- * @brief Displays the content of a file.
+ * @brief Adds an appointment to the matrix.
  *
- * This function reads the content of the specified file and returns it as a string.
- * If the file can't be opened, an error message is returned.
+ * Checks if the date is within the matrix bounds and adds the appointment
+ * to the appropriate location in the matrix. Appointments with a vehicle are
+ * also recorded in the per-vehicle appointment index.
  *
- * @param filePath The path to the file whose content will be displayed.
- * @return A string containing the content of the file or an error message.
+ * @param date The date of the appointment.
+ * @param appointment The appointment to be added.
+ * @return false if the date does not exist or lies outside the matrix; nothing is added then.
  */
-string DisplayFileContent(const string& filePath) {
-    ifstream inputFile(filePath);
-
-    string line;
-    string output;
-
-        // Read and concatenate each line in the file
-        while (getline(inputFile, line)) {
-            output += line + "\n";
+bool addAppointment(const Date& date, const Appointment& appointment) {
+    {
+        shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
+        if (!matrixHoldsDate(date)) {
+            return false;
         }
+        unique_lock<shared_mutex> rowLock(appointmentShard(date.year, date.month));
+        appointmentMatrix[date.year][date.month][date.day].push(appointment);
+    }
 
-        // Close the file
-        inputFile.close();
+    indexVehicleAppointment(date, appointment);
+    return true;
+}
 
-    return output;
+/**
+ * @brief Writes one recurring appointment in the recurring contracts file format.
+ *
+ * The line holds the start day, month and year, the customer name, vehicle ID and
+ * appointment type, the interval followed by "days" or "months", the number of
+ * visits (0 for no limit) and the day, month and year of the last possible visit
+ * (0 0 0 for none), separated by spaces.
+ *
+ * @param out The stream to write to.
+ * @param rule The recurring appointment.
+ */
+void formatRecurringLine(ostream& out, const RecurringAppointment& rule) {
+    const Recurrence& recurrence = rule.recurrence;
+    Date start = civilDate(recurrence.start);
+    Date until = recurrence.hasLastDay() ? civilDate(recurrence.until) : Date{ 0, 0, 0 };
+    out << start.day << ' ' << start.month << ' ' << start.year << ' ' << rule.appointment.customerName << ' '
+        << rule.appointment.vehicleID << ' ' << rule.appointment.appointmentType << ' '
+        << recurrence.interval << ' ' << (recurrence.unit == RecurDays ? "days" : "months") << ' ' << recurrence.count << ' '
+        << until.day << ' ' << until.month << ' ' << until.year << '\n';
 }
 
 /**
- * @brief Loads parts information from a file into a hash map.
+ * @brief Parses one line of the recurring contracts file.
  *
- * This function reads parts information from the specified file and populates
- * a hash map with part names as keys and corresponding Part structures as values.
+ * @param line The line, as written by formatRecurringLine.
+ * @param rule Receives the recurring appointment.
+ * @param error Receives the column and description of the offending field when the line is rejected.
+ * @return true if every field is present and the dates exist.
  */
-void loadPartsFromFile(const char* fileName) {
-    ifstream file(partfileName);
+bool parseRecurringLine(string_view line, RecurringAppointment& rule, ParseError* error = nullptr) {
+    FieldScanner fields(line);
+    Date start{ 0, 0, 0 };
+    Date until{ 0, 0, 0 };
+    string_view customerName;
+    string_view appointmentType;
+    string_view unit;
+    Recurrence& recurrence = rule.recurrence;
+    auto reject = [&](const char* expected) {
+        if (error) {
+            error->column = fields.column();
+            error->expected = expected;
+        }
+        return false;
+    };
 
-    Part part;
-    while (file >> part.name >> part.compatiblemodel >> part.price) {
-        // Assign part information to the hash map using the part name as the key
-        partHash[to_string(part.partID)] = part;
+    if (!fields.readNumber(start.day) || !fields.readNumber(start.month) || !fields.readNumber(start.year)
+        || !isValidCivil(start.year, start.month, start.day)) {
+        return reject("start date");
+    }
+    if (!fields.readWord(customerName)) {
+        return reject("customer name");
+    }
+    if (!fields.readNumber(rule.appointment.vehicleID)) {
+        return reject("vehicle ID");
+    }
+    if (!fields.readWord(appointmentType)) {
+        return reject("appointment type");
+    }
+    if (!fields.readNumber(recurrence.interval) || recurrence.interval < 1) {
+        return reject("interval");
+    }
+    if (!fields.readWord(unit) || (unit != "days" && unit != "months")) {
+        return reject("days or months");
+    }
+    if (!fields.readNumber(recurrence.count)) {
+        return reject("visit count");
+    }
+    if (!fields.readNumber(until.day) || !fields.readNumber(until.month) || !fields.readNumber(until.year)
+        || (until.year != 0 && !isValidCivil(until.year, until.month, until.day))) {
+        return reject("last date");
     }
 
-    file.close();
+    rule.appointment.customerName.assign(customerName);
+    rule.appointment.appointmentType.assign(appointmentType);
+    rule.appointment.priority = appointmentPriority(rule.appointment.appointmentType);
+    recurrence.start = calendarDay(start);
+    recurrence.unit = unit == "days" ? RecurDays : RecurMonths;
+    recurrence.until = until.year != 0 ? calendarDay(until) : Recurrence().until;
+    return true;
 }
 
 /**
- * @brief Writes part information to a file.
+ * @brief Adds a recurring appointment contract.
  *
- * This function appends part information to the specified file.
+ * @param rule The contract.
+ * @return false if its interval is below 1; nothing is added then.
+ */
+bool addRecurringAppointment(const RecurringAppointment& rule) {
+    if (rule.recurrence.interval < 1) {
+        return false;
+    }
+    unique_lock<shared_mutex> rulesLock(recurringAppointmentsMutex);
+    recurringAppointments.push_back(rule);
+    return true;
+}
+
+/**
+ * @brief Adds a recurring appointment contract and appends it to a file.
  *
- * @param part The part information to be written to the file.
+ * @param fileName The recurring contracts file.
+ * @param rule The contract.
+ * @return false if the contract was refused by addRecurringAppointment.
  */
-void writePartToFile(const Part& part, const char* fileName) {
+bool saveRecurringAppointment(const char* fileName, const RecurringAppointment& rule) {
+    if (!addRecurringAppointment(rule)) {
+        return false;
+    }
     ofstream file(fileName, ios::app);
-
-    // Write part information to the file
-    file << part.name << " " << part.compatiblemodel << " " << part.price << endl;
-
-    // Close the file
-    file.close();
+    formatRecurringLine(file, rule);
+    return true;
 }
 
 /**
- * @brief Writes vehicle information to a binary file.
+ * @brief Reads the recurring appointment contracts of a file.
  *
- * This function appends binary vehicle information to the specified file.
+ * A missing file holds no contracts. For every line with an incorrect format, an
+ * error message giving the file, line, column and expected field is printed to
+ * the standard error stream.
  *
- * @param vehicle Pointer to the Vehicle object to be written to the file.
- * @throw runtime_error if the file cannot be opened for writing.
+ * @param fileName The recurring contracts file.
+ * @return size_t The number of contracts read.
  */
-void writeVehicleToFile(Vehicle* vehicle, const char* fileName) {
-    ofstream file(fileName, ios::binary | ios::app);
-
-    // Write the binary representation of the vehicle object to the file
-    file.write((char*)vehicle, sizeof(Vehicle));
-
-    // Close the file
-    file.close();
+size_t loadRecurringAppointments(const char* fileName) {
+    VEHICLE_TIMED("loadRecurringAppointments");
+
+    string text = readWholeFile(fileName);
+    LineScanner lines(text);
+    string_view line;
+    RecurringAppointment rule;
+    ParseError error;
+    size_t loaded = 0;
+    while (lines.next(line)) {
+        if (parseRecurringLine(line, rule, &error)) {
+            loaded += addRecurringAppointment(rule);
+        }
+        else {
+            error.line = lines.lineNumber();
+            cerr << "Incorrect file format: " << error.describe(fileName) << ": " << line << endl;
+        }
+    }
+    return loaded;
 }
 
 /**
- * @brief Updates the vehicle file by writing the linked list of vehicles to a temporary file.
+ * @brief Returns the visits of the recurring appointment contracts within a range of dates.
+ *
+ * Only the visits inside the range are computed, so the cost depends on the
+ * number of contracts and of visits shown, not on how long the contracts run.
+ *
+ * @param from First date of the range; it must exist.
+ * @param to Last date of the range; it must exist.
+ * @return Pairs of date and appointment, ordered by date and then by contract.
+ */
+vector<pair<Date, Appointment>> recurringAppointmentsBetween(const Date& from, const Date& to) {
+    VEHICLE_TIMED("recurringAppointmentsBetween");
+
+    vector<pair<CalendarDay, const Appointment*>> visits;
+    vector<pair<Date, Appointment>> appointments;
+
+    shared_lock<shared_mutex> rulesLock(recurringAppointmentsMutex);
+    for (const RecurringAppointment& rule : recurringAppointments) {
+        rule.recurrence.forEachBetween(calendarDay(from), calendarDay(to), [&](uint32_t, CalendarDay day) {
+            visits.push_back({ day, &rule.appointment });
+        });
+    }
+    stable_sort(visits.begin(), visits.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    appointments.reserve(visits.size());
+    for (const auto& visit : visits) {
+        appointments.push_back({ civilDate(visit.first), *visit.second });
+    }
+    VEHICLE_COUNT("recurringVisitsExpanded", appointments.size());
+    return appointments;
+}
+
+/**
+ * @brief Lists appointments for a specific date.
+ *
+ * Prints the date for which appointments are listed and checks if
+ * appointments exist for the given date. If appointments exist, it
+ * prints each appointment for the date in priority order; they stay booked.
+ * The visits of recurring contracts on that date follow them.
+ * A date outside the matrix has no appointments.
+ *
+ * @param date The date for which appointments are listed.
+ */
+void listAppointments(const Date& date) {
+    VEHICLE_TIMED("listAppointments");
+
+    // Print the date for which appointments are listed
+    cout << "Appointments " << date.day << "." << date.month << "." << date.year << ":\n";
+
+        shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
+        if (!matrixHoldsDate(date)) {
+            return;
+        }
+        shared_lock<shared_mutex> rowLock(appointmentShard(date.year, date.month));
+
+        int count = 1;
+        // Print each appointment for the date
+        appointmentMatrix[date.year][date.month][date.day].forEachInOrder([&count](const Appointment& appointment) {
+            cout << count << ". " << appointment.customerName << "\n";
+            count++;
+        });
+        for (const auto& visit : recurringAppointmentsBetween(date, date)) {
+            cout << count << ". " << visit.second.customerName << "\n";
+            count++;
+        }
+}
+
+/**
+ * @brief Collects the first appointment of every booked day.
+ *
+ * Each month row is read under its shard lock in shared mode, so listing
+ * runs concurrently with other readers and only waits for bookings on the same month.
+ *
+ * @return Pairs of date and first appointment, ordered by date.
+ */
+vector<pair<Date, Appointment>> collectAppointmentHeads() {
+    VEHICLE_TIMED("collectAppointmentHeads");
+
+    vector<pair<Date, Appointment>> heads;
+
+    shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
+
+    for (size_t i = 0; i < appointmentMatrix.size(); ++i) {
+        for (size_t j = 0; j < appointmentMatrix[i].size(); ++j) {
+            shared_lock<shared_mutex> rowLock(appointmentShard(static_cast<int>(i), static_cast<int>(j)));
+            for (size_t k = 0; k < appointmentMatrix[i][j].size(); ++k) {
+                const auto& appointments = appointmentMatrix[i][j][k];
+                if (!appointments.empty()) {
+                    heads.push_back({ Date{ static_cast<int>(i), static_cast<int>(j), static_cast<int>(k) }, appointments.front() });
+                }
+            }
+        }
+    }
+
+    return heads;
+}
+
+/**
+ * @brief Parses one line of the appointments file.
+ *
+ * The fields are read in place with from_chars; the strings of the appointment
+ * are assigned, so their buffers are reused from one line to the next.
+ *
+ * @param line The line, as written by formatAppointmentLine.
+ * @param date Receives the date of the appointment.
+ * @param appointment Receives the appointment; the vehicle ID is 0, the type empty, the priority 0 and the bay and first slot -1 when the line has none.
+ * @param error Receives the column and description of the offending field when the line is rejected.
+ * @return true if the line holds at least a date that exists and a customer name.
+ */
+bool parseAppointmentLine(string_view line, Date& date, Appointment& appointment, ParseError* error = nullptr) {
+    FieldScanner fields(line);
+    string_view customerName;
+    string_view appointmentType;
+    auto reject = [&](const char* expected) {
+        if (error) {
+            error->column = fields.column();
+            error->expected = expected;
+        }
+        return false;
+    };
+
+    // Extract date and customer name information from the line
+    if (!fields.readNumber(date.day)) {
+        return reject("day");
+    }
+    if (!fields.readNumber(date.month)) {
+        return reject("month");
+    }
+    if (!fields.readNumber(date.year)) {
+        return reject("year");
+    }
+    if (!isValidCivil(date.year, date.month, date.day)) {
+        return reject("valid date");
+    }
+    if (!fields.readWord(customerName)) {
+        return reject("customer name");
+    }
+
+    appointment.customerName.assign(customerName);
+    appointment.vehicleID = 0;
+    appointment.appointmentType.clear();
+    appointment.priority = 0;
+    appointment.bay = -1;
+    appointment.firstSlot = -1;
+    if (fields.readNumber(appointment.vehicleID) && fields.readWord(appointmentType)) {
+        appointment.appointmentType.assign(appointmentType);
+        int bay, firstSlot;
+        if (fields.readNumber(appointment.priority) && fields.readNumber(bay) && fields.readNumber(firstSlot)) {
+            appointment.bay = bay;
+            appointment.firstSlot = firstSlot;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the rejected lines of a loaded file in file order.
+ *
+ * @param prefix Start of every message.
+ * @param fileName Name of the loaded file.
+ * @param chunks The parsed pieces of the file, in file order.
+ * @return The number of rejected lines.
+ */
+template <typename Chunk>
+size_t reportRejectedLines(const char* prefix, const char* fileName, vector<Chunk>& chunks) {
+    size_t firstLine = 0;
+    size_t rejected = 0;
+    for (Chunk& chunk : chunks) {
+        for (RejectedLine& entry : chunk.rejected) {
+            entry.error.line += firstLine;
+            cerr << prefix << entry.error.describe(fileName) << ": " << entry.line << endl;
+        }
+        rejected += chunk.rejected.size();
+        firstLine += chunk.lines;
+    }
+    return rejected;
+}
+
+/**
+ * @brief Parses one piece of an appointments file.
+ *
+ * @param piece Whole lines of the file.
+ * @param chunk Receives the rejected lines and the number of lines of the piece.
+ * @param sink Receives every parsed appointment, in file order.
+ */
+template <typename Sink>
+void parseAppointmentPiece(string_view piece, AppointmentLoadChunk& chunk, Sink sink) {
+    LineScanner lines(piece);
+    string_view line;
+    PendingAppointment parsed;
+    ParseError error;
+    while (lines.next(line)) {
+        if (parseAppointmentLine(line, parsed.date, parsed.appointment, &error)) {
+            sink(parsed);
+        }
+        else {
+            error.line = lines.lineNumber();
+            chunk.rejected.push_back({ error, line });
+        }
+    }
+    chunk.lines = lines.lineNumber();
+}
+
+/**
+ * @brief Moves parsed appointments into the matrix in the order given.
+ *
+ * Consecutive appointments mostly share a month, so a row lock is kept until the month changes.
+ * Appointments dated outside the matrix are skipped.
+ *
+ * @param bookings The appointments; their appointments are moved out.
+ * @param vehicleBookings Receives copies of the appointments with a vehicle, to be indexed once no matrix lock is held.
+ * @return The number of appointments stored.
+ */
+size_t storeLoadedAppointments(vector<PendingAppointment>& bookings, vector<PendingAppointment>& vehicleBookings) {
+    shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
+    unique_lock<shared_mutex> rowLock;
+    Date lockedMonth{ -1, -1, -1 };
+    size_t stored = 0;
+    for (PendingAppointment& booking : bookings) {
+        const Date& date = booking.date;
+        if (!matrixHoldsDate(date)) {
+            continue;
+        }
+        if (date.year != lockedMonth.year || date.month != lockedMonth.month) {
+            if (rowLock.owns_lock()) {
+                rowLock.unlock();
+            }
+            rowLock = unique_lock<shared_mutex>(appointmentShard(date.year, date.month));
+            lockedMonth = date;
+        }
+        if (booking.appointment.vehicleID > 0) {
+            vehicleBookings.push_back(booking);
+        }
+        appointmentMatrix[date.year][date.month][date.day].push(std::move(booking.appointment));
+        stored++;
+    }
+    return stored;
+}
+
+/**
+ * @brief Reads appointments from a file and adds them to the matrix.
+ *
+ * This function reads each line from the appointments file, extracts date
+ * and customer name information, and adds the appointment to the matrix.
+ * The vehicle ID and appointment type that may follow the customer name are
+ * read when present. A missing file holds no appointments. For every line with
+ * an incorrect format, an error message giving the file, line, column and
+ * expected field is printed to the standard error stream.
+ *
+ * Large files are split at line boundaries and parsed on several threads. The
+ * parsed appointments are then stored by the same threads, each owning whole
+ * lock shards of the matrix and visiting the pieces in file order, so every day
+ * keeps its appointments in file order and no lock is shared between them.
+ *
+ * @param fileName The appointments file.
+ * @param threads Number of threads, 0 for one per hardware thread.
+ */
+void readAppointmentsFromFile(const char* fileName, int threads = 0) {
+    VEHICLE_TIMED("readAppointmentsFromFile");
+
+    // Read the whole file with one call and split it into pieces of whole lines
+    string text = readWholeFile(fileName);
+    vector<string_view> pieces = splitAtLines(text, parallelChunkCount(text.size(), threads));
+    size_t workers = pieces.size();
+    vector<AppointmentLoadChunk> chunks(workers);
+    size_t loaded = 0;
+
+    if (workers == 1) {
+        // A single piece is parsed and stored in batches small enough to stay in the cache
+        vector<PendingAppointment> batch;
+        vector<PendingAppointment> vehicleBookings;
+        batch.reserve(appointmentLoadBatch);
+        auto flush = [&]() {
+            loaded += storeLoadedAppointments(batch, vehicleBookings);
+            batch.clear();
+        };
+        parseAppointmentPiece(pieces[0], chunks[0], [&](const PendingAppointment& parsed) {
+            batch.push_back(parsed);
+            if (batch.size() == appointmentLoadBatch) {
+                flush();
+            }
+        });
+        flush();
+        for (const PendingAppointment& booking : vehicleBookings) {
+            indexVehicleAppointment(booking.date, booking.appointment);
+        }
+    }
+    else if (workers > 1) {
+        // Parse every piece, grouping its appointments by the worker that stores their month
+        runInParallel(workers, [&](size_t piece) {
+            AppointmentLoadChunk& chunk = chunks[piece];
+            chunk.byWorker.resize(workers);
+            size_t expected = static_cast<size_t>(count(pieces[piece].begin(), pieces[piece].end(), '\n')) / workers + 1;
+            for (vector<PendingAppointment>& group : chunk.byWorker) {
+                group.reserve(expected + expected / 8);
+            }
+            parseAppointmentPiece(pieces[piece], chunk, [&](const PendingAppointment& parsed) {
+                chunk.byWorker[appointmentShardIndex(parsed.date.year, parsed.date.month) % workers].push_back(parsed);
+            });
+        });
+
+        // Each worker stores the months of its lock shards, visiting the pieces in file order
+        atomic<size_t> stored(0);
+        runInParallel(workers, [&](size_t worker) {
+            vector<PendingAppointment> vehicleBookings;
+            for (AppointmentLoadChunk& chunk : chunks) {
+                stored += storeLoadedAppointments(chunk.byWorker[worker], vehicleBookings);
+            }
+
+            // The vehicle index is updated after the matrix locks are released, as addAppointment does
+            for (const PendingAppointment& booking : vehicleBookings) {
+                indexVehicleAppointment(booking.date, booking.appointment);
+            }
+        });
+        loaded = stored;
+    }
+
+    VEHICLE_COUNT("appointmentsLoaded", loaded);
+    VEHICLE_COUNT("appointmentLinesRejected", reportRejectedLines("Incorrect file format: ", fileName, chunks));
+}
+
+/**
+ * @brief Submits a booking to the appointment intake queue.
+ *
+ * The booking is queued without taking any lock. The committer thread later
+ * assigns it to its date in the appointment matrix and persists it together
+ * with the rest of its batch.
+ *
+ * @param date The date of the appointment.
+ * @param appointment The appointment to be booked.
+ */
+void submitAppointment(const Date& date, const Appointment& appointment) {
+    appointmentIntake.push(PendingAppointment{ date, appointment });
+    appointmentIntakeSignal.notify_one();
+}
+
+/**
+ * @brief Commits one batch of queued bookings.
+ *
+ * This function drains up to maxBatch bookings from the intake queue, adds each
+ * one to the appointment matrix and appends all of them to the file with one
+ * grouped write. Only one thread may drain the intake queue at a time, which is
+ * the committer thread while it is running.
+ *
+ * @param fileName The appointments file the batch is appended to.
+ * @param maxBatch Maximum number of bookings to commit.
+ * @return The number of bookings committed.
+ */
+size_t commitAppointmentBatch(const char* fileName, size_t maxBatch) {
+    VEHICLE_TIMED("commitAppointmentBatch");
+
+    ostringstream batch;
+    size_t committed = 0;
+
+    PendingAppointment pending;
+    while (committed < maxBatch && appointmentIntake.tryPop(pending)) {
+        // Assign the booking to its date slot; a date outside the matrix is dropped
+        if (!addAppointment(pending.date, pending.appointment)) {
+            continue;
+        }
+
+        formatAppointmentLine(batch, pending.date, pending.appointment);
+        committed++;
+    }
+
+    VEHICLE_COUNT("appointmentsCommitted", committed);
+
+    if (committed > 0) {
+        // Persist the whole batch with a single write
+        ofstream file(fileName, ios::app);
+        string lines = batch.str();
+        file.write(lines.data(), lines.size());
+        file.close();
+    }
+
+    return committed;
+}
+
+/**
+ * @brief Starts the committer thread draining the appointment intake queue.
+ *
+ * The committer commits batches while bookings are waiting and sleeps on
+ * appointmentIntakeSignal when the queue is empty. The sleep is bounded, so a
+ * wake-up that races with the emptiness check only delays a booking briefly.
+ *
+ * @param fileName The appointments file batches are appended to.
+ */
+void startAppointmentCommitter(const char* fileName) {
+    if (appointmentCommitterRunning.exchange(true)) {
+        return;
+    }
+
+    appointmentCommitter = thread([fileName]() {
+        while (appointmentCommitterRunning.load()) {
+            if (commitAppointmentBatch(fileName, appointmentCommitBatchSize) == 0) {
+                unique_lock<mutex> waitLock(appointmentIntakeWaitMutex);
+                appointmentIntakeSignal.wait_for(waitLock, chrono::milliseconds(10));
+            }
+        }
+
+        // Commit the bookings submitted before the stop request
+        while (commitAppointmentBatch(fileName, appointmentCommitBatchSize) > 0) {
+        }
+    });
+}
+
+/**
+ * @brief Stops the committer thread after it has committed every queued booking.
+ */
+void stopAppointmentCommitter() {
+    if (!appointmentCommitterRunning.exchange(false)) {
+        return;
+    }
+
+    appointmentIntakeSignal.notify_one();
+    appointmentCommitter.join();
+}
+
+/**
+ * @brief Appends a record to a text file and indexes its words.
+ *
+ * The record is terminated with an empty line. Its words are added to the index
+ * log of the file, which is compacted once it grows past textIndexLogCompactBytes.
+ *
+ * @param filePath The path to the text file.
+ * @param record The record, ending with a newline.
+ */
+void appendTextRecord(const string& filePath, const string& record) {
+    lock_guard<mutex> lock(textIndexMutex);
+
+    uint64_t offset = textFileSize(filePath);
+    string entry = record + "\n";
+
+    ofstream outputFile(filePath, ios::app | ios::binary);
+    outputFile << entry;
+    outputFile.close();
+
+    logTextRecord(filePath, offset, entry.size(), entry);
+    if (textFileSize(filePath + ".idx.log") > textIndexLogCompactBytes) {
+        compactTextIndex(filePath);
+    }
+}
+
+/**
+ * @brief Finds the records of a text file that contain every word of a query.
+ *
+ * @param filePath The path to the text file.
+ * @param query Words to search for; each matches the words it is a prefix of.
+ * @param limit Maximum number of records to return.
+ * @return The matching records, newest first.
+ */
+vector<string> searchTextRecords(const string& filePath, const string& query, size_t limit) {
+    VEHICLE_TIMED("searchTextRecords");
+
+    lock_guard<mutex> lock(textIndexMutex);
+
+    vector<uint64_t> offsets = searchTextIndex(filePath, query);
+    vector<string> records;
+    for (auto offset = offsets.rbegin(); offset != offsets.rend() && records.size() < limit; ++offset) {
+        records.push_back(readTextRecord(filePath, *offset));
+    }
+    return records;
+}
+
+/**
+ * @brief Writes a service report in the history file format.
+ *
+ * @param out The stream to write to.
+ * @param appointment The appointment information.
+ * @param date The date of the appointment.
+ */
+void formatReport(ostream& out, const Appointment& appointment, const Date& date) {
+    out << " | The following operation: " << appointment.appointmentType << ", performed to the customer : \n | " << appointment.customerName
+        << " with vehicle ID " << appointment.vehicleID << ", on this date: "
+        << date.day << "/" << date.month << "/" << date.year << "\n";
+}
+
+/**
+ * @brief Copies a string into a fixed-width, zero padded record field.
+ *
+ * @param field The record field to fill.
+ * @param length Size of the field, including the terminating zero.
+ * @param value The string to store; truncated to length - 1 characters.
+ */
+void copyRecordField(char* field, size_t length, string_view value) {
+    size_t count = min(value.size(), length - 1);
+    memcpy(field, value.data(), count);
+    memset(field + count, 0, length - count);
+}
+
+/**
+ * @brief Builds the service record of an appointment.
+ *
+ * @param kind The document the record stands for.
+ * @param appointment The appointment information.
+ * @param date The date of the appointment.
+ * @param parts Parts used by the service. All of them are priced, but only the first serviceRecordMaxParts IDs are kept.
+ * @return The fixed-width record.
+ */
+ServiceRecord makeServiceRecord(ServiceKind kind, const Appointment& appointment, const Date& date, const vector<Part>& parts) {
+    ServiceRecord record = {};
+    record.kind = kind;
+    record.vehicleID = appointment.vehicleID;
+    record.date = date;
+    record.partCount = static_cast<int32_t>(min(parts.size(), static_cast<size_t>(serviceRecordMaxParts)));
+    for (int i = 0; i < record.partCount; ++i) {
+        record.partIDs[i] = parts[i].partID;
+    }
+
+    PriceResult price = calculateTotalPrice(parts);
+    record.partsAmount = price.amountWithoutLabor;
+    record.laborAmount = price.totalAmount - price.amountWithoutLabor;
+
+    copyRecordField(record.customerName, sizeof(record.customerName), appointment.customerName);
+    copyRecordField(record.serviceType, sizeof(record.serviceType), appointment.appointmentType);
+    return record;
+}
+
+/**
+ * @brief Returns the appointment a service record was created for.
+ *
+ * @param record The service record.
+ * @return The appointment with the vehicle ID, customer name and type of the record.
+ */
+Appointment serviceAppointment(const ServiceRecord& record) {
+    return Appointment{ record.vehicleID,
+        string(record.customerName, strnlen(record.customerName, sizeof(record.customerName))),
+        string(record.serviceType, strnlen(record.serviceType, sizeof(record.serviceType))) };
+}
+
+/**
+ * @brief Returns the date a warranty expires or the next maintenance is due.
+ *
+ * Warranties run for one month and maintenance is due again after one year.
+ * A day the due month does not have moves to that month's last day.
+ * Reports have no due date and return the service date.
+ *
+ * @param record The service record.
+ * @return The due date.
+ */
+Date serviceDueDate(const ServiceRecord& record) {
+    if (!isValidCivil(record.date.year, record.date.month, record.date.day)) {
+        return record.date;
+    }
+    if (record.kind == ServiceWarranty) {
+        return civilDate(calendarDay(record.date).addMonths(1));
+    }
+    if (record.kind == ServiceMaintenance) {
+        return civilDate(calendarDay(record.date).addYears(1));
+    }
+    return record.date;
+}
+
+/**
+ * @brief Writes the text of a service record as shown to the user.
+ *
+ * @param out The stream to write to.
+ * @param record The service record.
+ */
+void renderServiceRecord(ostream& out, const ServiceRecord& record) {
+    Appointment appointment = serviceAppointment(record);
+    const Date& date = record.date;
+    Date due = serviceDueDate(record);
+
+    switch (record.kind) {
+    case ServiceWarranty:
+        out << " | " << appointment.appointmentType << ", performed to the customer : \n | " << appointment.customerName
+            << " with vehicle ID " << appointment.vehicleID << ", on this date: "
+            << date.day << "/" << date.month << "/" << date.year << "\n";
+        out << " | Warranty for repair valid until: " << due.day << "/" << due.month << "/" << due.year << "\n";
+        break;
+    case ServiceMaintenance:
+        out << " | Maintenance appointment performed for the customer  \n | " << appointment.customerName
+            << " with vehicle ID " << appointment.vehicleID << ", on this date: "
+            << date.day << "/" << date.month << "/" << date.year << "\n";
+        out << " | Next maintenance date is : " << due.day << "/" << due.month << "/" << due.year << "\n";
+        break;
+    default:
+        formatReport(out, appointment, date);
+        break;
+    }
+
+    if (record.partCount > 0) {
+        out << " | Parts used: " << record.partCount << ", parts amount: " << record.partsAmount << ", labor fee: " << record.laborAmount << "\n";
+    }
+}
+
+/**
+ * @brief Returns the text of a service record as shown to the user.
+ *
+ * @param record The service record.
+ * @return The rendered lines.
+ */
+string serviceRecordText(const ServiceRecord& record) {
+    stringstream text;
+    renderServiceRecord(text, record);
+    return text.str();
+}
+
+/**
+ * @brief Returns the current month of the local calendar.
+ *
+ * @return int The month as year * 12 + month - 1.
+ */
+int currentMonth() {
+    time_t now = time(nullptr);
+    tm local = {};
+#if defined(_WIN32)
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return (local.tm_year + 1900) * 12 + local.tm_mon;
+}
+
+/**
+ * @brief Returns a new service file header.
+ *
+ * @param openedMonth Month the live file is started in, as year * 12 + month - 1.
+ */
+ServiceFileHeader serviceFileHeader(int openedMonth = currentMonth()) {
+    ServiceFileHeader header = {};
+    memcpy(header.magic, serviceFileMagic, sizeof(header.magic));
+    header.version = serviceFileVersion;
+    header.openedMonth = openedMonth;
+    return header;
+}
+
+/**
+ * @brief Returns the length of the header the contents of a service file start with, 0 when there is none.
+ */
+size_t serviceHeaderBytes(string_view bytes) {
+    if (bytes.size() < sizeof(ServiceFileHeader) || memcmp(bytes.data(), serviceFileMagic, sizeof(serviceFileMagic)) != 0) {
+        return 0;
+    }
+    return sizeof(ServiceFileHeader);
+}
+
+/**
+ * @brief Splits the contents of a service file into records for the word index.
+ *
+ * @param bytes Contents of the service file.
+ * @param from Offset of the first record; the header is skipped in any case.
+ * @param visit Receives the offset, end and rendered text of every record.
+ */
+void forEachServiceRecord(string_view bytes, uint64_t from, const TextRecordVisitor& visit) {
+    ServiceRecord record;
+    for (uint64_t offset = max<uint64_t>(from, serviceHeaderBytes(bytes)); offset + sizeof(ServiceRecord) <= bytes.size(); offset += sizeof(ServiceRecord)) {
+        memcpy(&record, bytes.data() + offset, sizeof(ServiceRecord));
+        visit(offset, offset + sizeof(ServiceRecord), serviceRecordText(record));
+    }
+}
+
+/**
+ * @brief Lists the compressed segments of a service file.
+ *
+ * Segments are named "<file>.<sequence>.<year>-<month>.seg", where the month is the
+ * one the records were written in, so name order is rotation order.
+ *
+ * @param filePath The path to the live service file.
+ * @return The paths of the segments, oldest first.
+ */
+vector<string> serviceSegments(const string& filePath) {
+    vector<string> segments;
+    filesystem::path livePath(filePath);
+    string prefix = livePath.filename().string() + ".";
+    string suffix = serviceSegmentSuffix;
+
+    error_code error;
+    filesystem::path directory = livePath.has_parent_path() ? livePath.parent_path() : filesystem::path(".");
+    for (filesystem::directory_iterator entry(directory, error), end; !error && entry != end; entry.increment(error)) {
+        string name = entry->path().filename().string();
+        if (name.size() > prefix.size() + suffix.size() && name.compare(0, prefix.size(), prefix) == 0
+            && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            segments.push_back((livePath.parent_path() / name).string());
+        }
+    }
+    sort(segments.begin(), segments.end());
+    return segments;
+}
+
+/**
+ * @brief Moves a service file in the old text format out of the way of the records.
+ *
+ * A non-empty file that does not start with serviceFileMagic holds the rendered
+ * text of an older version. It is renamed unchanged to "<file>.legacy.txt", or
+ * "<file>.legacy.<n>.txt" when that exists, and its word index is dropped. A
+ * header cut short by an interrupted first write is removed instead. Must be
+ * called with textIndexMutex held.
+ *
+ * @param filePath The path to the live service file.
+ * @return true if a text file was moved aside.
+ */
+bool retireLegacyServiceFile(const string& filePath) {
+    uint64_t size = textFileSize(filePath);
+    if (size == 0) {
+        return false;
+    }
+
+    char magic[sizeof(serviceFileMagic)] = {};
+    ifstream inputFile(filePath, ios::binary);
+    inputFile.read(magic, sizeof(magic));
+    inputFile.close();
+    error_code error;
+    size_t compared = static_cast<size_t>(min<uint64_t>(size, sizeof(magic)));
+    if (memcmp(magic, serviceFileMagic, compared) == 0) {
+        if (size < sizeof(ServiceFileHeader)) {
+            filesystem::resize_file(filePath, 0, error);
+        }
+        return false;
+    }
+
+    string legacyPath = filePath + serviceLegacySuffix;
+    for (int copy = 2; filesystem::exists(legacyPath); ++copy) {
+        legacyPath = filePath + ".legacy." + to_string(copy) + ".txt";
+    }
+    filesystem::rename(filePath, legacyPath, error);
+    if (error) {
+        return false;
+    }
+    filesystem::remove(filePath + ".idx", error);
+    filesystem::remove(filePath + ".idx.log", error);
+    return true;
+}
+
+/**
+ * @brief Moves the records of a live service file into a new compressed segment.
+ *
+ * The compacted word index of the file moves along with the records, so the
+ * segment stays searchable without being decompressed. Must be called with
+ * textIndexMutex held.
+ *
+ * @param filePath The path to the live service file.
+ * @param month The month the live file was started in, as year * 12 + month - 1.
+ * @return true if the live file was emptied into a segment.
+ */
+bool rotateServiceFile(const string& filePath, int month) {
+    string records = readWholeFile(filePath);
+    compactTextIndex(filePath, forEachServiceRecord);
+
+    char name[32];
+    size_t sequence = serviceSegments(filePath).size() + 1;
+    string segmentPath;
+    do {
+        snprintf(name, sizeof(name), ".%06zu.%04d-%02d", sequence++, month / 12, month % 12 + 1);
+        segmentPath = filePath + name + serviceSegmentSuffix;
+    } while (filesystem::exists(segmentPath));
+
+    if (!writeLzSegment(segmentPath, records, sizeof(ServiceRecord))) {
+        return false;
+    }
+    error_code error;
+    filesystem::rename(filePath + ".idx", segmentPath + ".idx", error);
+    filesystem::resize_file(filePath, 0, error);
+    filesystem::remove(filePath + ".idx.log", error);
+    return true;
+}
+
+/**
+ * @brief Appends a service record to a service file and indexes the words of its text.
+ *
+ * A file in the old text format is moved aside first, and a partial record left at
+ * the end of the file by an interrupted write is dropped. A new live file starts
+ * with a ServiceFileHeader holding the current month. When that month has passed,
+ * the file is rotated into a compressed segment and the record starts a new live
+ * file. The dates of the records play no part: they may lie in any month, as a
+ * booking for next month writes its report today.
+ *
+ * @param filePath The path to the service file.
+ * @param record The record to append.
+ */
+void appendServiceRecord(const string& filePath, const ServiceRecord& record) {
+    lock_guard<mutex> lock(textIndexMutex);
+
+    retireLegacyServiceFile(filePath);
+    uint64_t size = textFileSize(filePath);
+    uint64_t offset = size < sizeof(ServiceFileHeader) ? 0 : size - (size - sizeof(ServiceFileHeader)) % sizeof(ServiceRecord);
+    error_code error;
+    if (offset != size) {
+        filesystem::resize_file(filePath, offset, error);
+    }
+
+    if (offset > sizeof(ServiceFileHeader)) {
+        ServiceFileHeader header;
+        ifstream inputFile(filePath, ios::binary);
+        inputFile.read(reinterpret_cast<char*>(&header), sizeof(ServiceFileHeader));
+        if (inputFile && header.openedMonth < currentMonth()) {
+            inputFile.close();
+            if (rotateServiceFile(filePath, header.openedMonth)) {
+                offset = 0;
+            }
+        }
+    }
+
+    ofstream outputFile(filePath, ios::app | ios::binary);
+    if (offset == 0) {
+        ServiceFileHeader header = serviceFileHeader();
+        outputFile.write(reinterpret_cast<const char*>(&header), sizeof(ServiceFileHeader));
+        offset = sizeof(ServiceFileHeader);
+    }
+    outputFile.write(reinterpret_cast<const char*>(&record), sizeof(ServiceRecord));
+    outputFile.close();
+
+    logTextRecord(filePath, offset, sizeof(ServiceRecord), serviceRecordText(record));
+    if (textFileSize(filePath + ".idx.log") > textIndexLogCompactBytes) {
+        compactTextIndex(filePath, forEachServiceRecord);
+    }
+}
+
+/**
+ * @brief Appends the whole records held in a byte buffer to a record list.
+ */
+void appendServiceRecordBytes(vector<ServiceRecord>& records, string_view bytes) {
+    size_t first = records.size();
+    size_t count = bytes.size() / sizeof(ServiceRecord);
+    records.resize(first + count);
+    memcpy(records.data() + first, bytes.data(), count * sizeof(ServiceRecord));
+}
+
+/**
+ * @brief Reads every record of a service file, from its compressed segments and the live file.
+ *
+ * A live file in the old text format is moved aside first, so it is not read as records.
+ *
+ * @param filePath The path to the service file.
+ * @return The records in the order they were appended.
+ */
+vector<ServiceRecord> readServiceRecords(const string& filePath) {
+    VEHICLE_TIMED("readServiceRecords");
+
+    lock_guard<mutex> lock(textIndexMutex);
+
+    vector<ServiceRecord> records;
+    LzSegmentReader segment;
+    string bytes;
+    for (const string& segmentPath : serviceSegments(filePath)) {
+        if (segment.open(segmentPath) && segment.readAll(bytes)) {
+            appendServiceRecordBytes(records, string_view(bytes).substr(serviceHeaderBytes(bytes)));
+        }
+    }
+
+    retireLegacyServiceFile(filePath);
+    ifstream inputFile(filePath, ios::binary);
+    inputFile.seekg(sizeof(ServiceFileHeader));
+    vector<ServiceRecord> block(serviceLoadBlockRecords);
+    while (inputFile.read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(ServiceRecord)) || inputFile.gcount() > 0) {
+        size_t count = static_cast<size_t>(inputFile.gcount()) / sizeof(ServiceRecord);
+        records.insert(records.end(), block.begin(), block.begin() + count);
+        if (count < block.size()) {
+            break;
+        }
+    }
+    return records;
+}
+
+/**
+ * @brief Empties a service file and removes its compressed segments and word indexes.
+ *
+ * @param filePath The path to the service file.
+ */
+void clearServiceFile(const string& filePath) {
+    lock_guard<mutex> lock(textIndexMutex);
+
+    error_code error;
+    for (const string& segmentPath : serviceSegments(filePath)) {
+        filesystem::remove(segmentPath, error);
+        filesystem::remove(segmentPath + ".idx", error);
+    }
+    ofstream(filePath, ios::trunc).close();
+    filesystem::remove(filePath + ".idx", error);
+    filesystem::remove(filePath + ".idx.log", error);
+}
+
+/**
+ * @brief Returns the bytes a service file occupies on disk, with its segments but without the word indexes.
+ *
+ * @param filePath The path to the service file.
+ * @return The size in bytes.
+ */
+uint64_t serviceFileDiskSize(const string& filePath) {
+    uint64_t size = textFileSize(filePath);
+    for (const string& segmentPath : serviceSegments(filePath)) {
+        size += textFileSize(segmentPath);
+    }
+    return size;
+}
+
+/**
+ * @brief Renders every record of a service file, each followed by an empty line.
+ *
+ * @param filePath The path to the service file.
+ * @return The text of the file as shown to the user.
+ */
+string renderServiceFile(const string& filePath) {
+    stringstream text;
+    for (const ServiceRecord& record : readServiceRecords(filePath)) {
+        renderServiceRecord(text, record);
+        text << "\n";
+    }
+    return text.str();
+}
+
+/**
+ * @brief Rebuilds the word index of a compressed segment whose index is missing.
+ *
+ * The segment is decompressed to a scratch file, which is indexed and removed.
+ *
+ * @param segmentPath The path to the segment.
+ */
+void indexServiceSegment(const string& segmentPath) {
+    LzSegmentReader segment;
+    string bytes;
+    if (!segment.open(segmentPath) || !segment.readAll(bytes)) {
+        return;
+    }
+    string scratchPath = segmentPath + ".raw";
+    ofstream(scratchPath, ios::binary | ios::trunc).write(bytes.data(), static_cast<streamsize>(bytes.size()));
+    compactTextIndex(scratchPath, forEachServiceRecord);
+
+    error_code error;
+    filesystem::rename(scratchPath + ".idx", segmentPath + ".idx", error);
+    filesystem::remove(scratchPath, error);
+}
+
+/**
+ * @brief Finds the records of a service file whose text contains every word of a query.
+ *
+ * The live file is searched first, then the compressed segments from the newest
+ * on; a segment is only opened to read the records its index points to, and
+ * only the blocks holding them are decompressed.
+ *
+ * @param filePath The path to the service file.
+ * @param query Words to search for; each matches the words it is a prefix of.
+ * @param limit Maximum number of records to return.
+ * @return The matching records, newest first.
+ */
+vector<ServiceRecord> searchServiceRecords(const string& filePath, const string& query, size_t limit) {
+    VEHICLE_TIMED("searchServiceRecords");
+
+    lock_guard<mutex> lock(textIndexMutex);
+
+    retireLegacyServiceFile(filePath);
+    vector<uint64_t> offsets = searchTextIndex(filePath, query, forEachServiceRecord);
+    vector<ServiceRecord> records;
+    ifstream inputFile(filePath, ios::binary);
+    ServiceRecord record;
+    for (auto offset = offsets.rbegin(); offset != offsets.rend() && records.size() < limit; ++offset) {
+        inputFile.seekg(static_cast<streamoff>(*offset));
+        if (inputFile.read(reinterpret_cast<char*>(&record), sizeof(ServiceRecord))) {
+            records.push_back(record);
+        }
+    }
+
+    vector<string> segments = serviceSegments(filePath);
+    LzSegmentReader segment;
+    string bytes;
+    for (auto segmentPath = segments.rbegin(); segmentPath != segments.rend() && records.size() < limit; ++segmentPath) {
+        if (!filesystem::exists(*segmentPath + ".idx")) {
+            indexServiceSegment(*segmentPath);
+        }
+        offsets = searchSealedTextIndex(*segmentPath + ".idx", query);
+        if (offsets.empty() || !segment.open(*segmentPath)) {
+            continue;
+        }
+        for (auto offset = offsets.rbegin(); offset != offsets.rend() && records.size() < limit; ++offset) {
+            if (segment.read(*offset, sizeof(ServiceRecord), bytes)) {
+                appendServiceRecordBytes(records, bytes);
+            }
+        }
+    }
+    return records;
+}
+
+/**
+ * @brief Creates a report and appends it to a file.
+ *
+ * This function creates a service record with information about the appointment,
+ * such as appointment type, customer name, vehicle ID, date, and the parts used
+ * with their amounts. It appends the record to the specified service file.
+ *
+ * @param filePath The path to the file where the report will be appended.
+ * @param appointment The appointment information.
+ * @param date The date of the appointment.
+ * @param parts The parts used by the service, if any.
+ */
+void CreateReport(const string& filePath, const Appointment& appointment, const Date& date, const vector<Part>& parts = {}) {
+    VEHICLE_TIMED("CreateReport");
+
+    // Write the report to the specified file
+    appendServiceRecord(filePath, makeServiceRecord(ServiceReport, appointment, date, parts));
+}
+
+/**
+ * @brief Creates a warranty document and appends it to a file.
+ *
+ * This function creates a warranty record with information about the appointment,
+ * such as appointment type, customer name, vehicle ID and date, and appends it
+ * to the specified service file. The expiration date (1 month later) is derived
+ * from the date when the record is rendered.
+ *
+ * @param filePath The path to the file where the warranty document will be appended.
+ * @param appointment The appointment information.
+ * @param date The date of the appointment.
+ */
+void CreateWarranty(const string& filePath, const Appointment& appointment, const Date& date) {
+    VEHICLE_TIMED("CreateWarranty");
+
+    // Write the warranty document to the specified file
+    appendServiceRecord(filePath, makeServiceRecord(ServiceWarranty, appointment, date, {}));
+}
+
+/**
+ * @brief Creates a maintenance document and appends it to a file.
+ *
+ * This function creates a maintenance record with information about the appointment,
+ * such as appointment type, customer name, vehicle ID and date, and appends it
+ * to the specified service file. The next maintenance date (1 year later) is derived
+ * from the date when the record is rendered.
+ *
+ * @param filePath The path to the file where the maintenance document will be appended.
+ * @param appointment The appointment information.
+ * @param date The date of the appointment.
+ */
+void CreateMaintenance(const string& filePath, const Appointment& appointment, const Date& date) {
+    VEHICLE_TIMED("CreateMaintenance");
+
+    // Write the maintenance document to the specified file
+    appendServiceRecord(filePath, makeServiceRecord(ServiceMaintenance, appointment, date, {}));
+}
+
+/**
+ * @brief Creates a feedback entry and appends it to a file.
+ *
+ * This function creates a feedback entry with the provided message and appends
+ * it to the specified file.
+ *
+ * @param filePath The path to the file where the feedback entry will be appended.
+ * @param message The feedback message.
+ */
+void CreateFeedback(const string& filePath, string message) {
+    VEHICLE_TIMED("CreateFeedback");
+
+    stringstream feedback;
+
+    feedback << message << "\n";
+
+    // Write the feedback entry to the specified file
+    appendTextRecord(filePath, feedback.str());
+}
+
+/**
+ * @brief Displays the content of a file.
+ *
+ * This function reads the content of the specified file and returns it as a string.
+ * If the file can't be opened, an error message is returned.
+ *
+ * @param filePath The path to the file whose content will be displayed.
+ * @return A string containing the content of the file or an error message.
+ */
+string DisplayFileContent(const string& filePath) {
+    VEHICLE_TIMED("DisplayFileContent");
+
+    ifstream inputFile(filePath);
+
+    string line;
+    string output;
+
+        // Read and concatenate each line in the file
+        while (getline(inputFile, line)) {
+            output += line + "\n";
+        }
+
+        // Close the file
+        inputFile.close();
+
+    return output;
+}
+
+/**
+ * @brief Adds a part to a model part index.
+ *
+ * @param index The index, grown to cover the model of the part.
+ * @param part The part to add.
+ */
+void indexPart(vector<vector<int>>& index, const Part& part) {
+    uint32_t model = part.compatiblemodel.value();
+    if (model >= index.size()) {
+        index.resize(model + 1);
+    }
+    index[model].push_back(part.partID);
+}
+
+/**
+ * @brief Parses one piece of a parts file.
+ *
+ * @param piece Whole lines of the file.
+ * @param chunk Receives the rejected lines and the number of lines of the piece.
+ * @param sink Receives every parsed part, not yet numbered, in file order; it may move the part away.
+ */
+template <typename Sink>
+void parsePartPiece(string_view piece, PartLoadChunk& chunk, Sink sink) {
+    LineScanner lines(piece);
+    Part part{};
+    string_view line;
+    string_view name;
+    string_view model;
+    string_view previousModel;
+    while (lines.next(line)) {
+        FieldScanner fields(line);
+        if (fields.atEnd()) {
+            continue;
+        }
+
+        ParseError error;
+        if (!fields.readWord(name)) {
+            error.expected = "part name";
+        }
+        else if (!fields.readWord(model)) {
+            error.expected = "model";
+        }
+        else if (!fields.readNumber(part.price)) {
+            error.expected = "price";
+        }
+        if (*error.expected) {
+            error.line = lines.lineNumber();
+            error.column = fields.column();
+            chunk.rejected.push_back({ error, line });
+            continue;
+        }
+
+        // Parts are grouped by model, so most lines reuse the model of the line before
+        part.name.assign(name);
+        if (model != previousModel) {
+            part.compatiblemodel = ModelName(model);
+            previousModel = model;
+        }
+        sink(part);
+    }
+    chunk.lines = lines.lineNumber();
+}
+
+/**
+ * @brief Loads parts information from a file into a hash map.
+ *
+ * This function reads parts information from the specified file and populates
+ * a hash map with part IDs as keys and corresponding Part structures as values.
+ * Parts are numbered from 1 in file order. Each line holds the name, model and
+ * price of one part; a malformed line is reported with its file, line and column
+ * on the standard error stream and skipped. Large files are parsed in pieces of
+ * whole lines on several threads; numbering and storing stay sequential.
+ * The file is parsed into a private map first; readers are only blocked for the swap.
+ * Both maps allocate their nodes from partPool, so the nodes of the replaced parts
+ * are reused by the next load.
+ *
+ * @param fileName The parts file.
+ * @param threads Number of parsing threads, 0 for one per hardware thread.
+ */
+void loadPartsFromFile(const char* fileName, int threads = 0) {
+    VEHICLE_TIMED("loadPartsFromFile");
+
+    // Read the whole file with one call and split it into pieces of whole lines
+    string text = readWholeFile(fileName);
+    vector<string_view> pieces = splitAtLines(text, parallelChunkCount(text.size(), threads));
+    vector<PartLoadChunk> chunks(pieces.size());
+
+    pmr::unordered_map<string, Part> loadedParts(&partPool);
+    vector<vector<int>> loadedIndex;
+    int nextPartID = 1;
+    auto store = [&](Part& part) {
+        part.partID = nextPartID;
+        indexPart(loadedIndex, part);
+        loadedParts.emplace(to_string(nextPartID++), std::move(part));
+    };
+
+    if (pieces.size() == 1) {
+        // A single piece is stored while it is parsed
+        loadedParts.reserve(static_cast<size_t>(count(text.begin(), text.end(), '\n')) + 1);
+        parsePartPiece(pieces[0], chunks[0], store);
+    }
+    else {
+        // Parse the pieces in parallel, then number the parts in file order
+        runInParallel(pieces.size(), [&](size_t piece) {
+            PartLoadChunk& chunk = chunks[piece];
+            chunk.parts.reserve(static_cast<size_t>(count(pieces[piece].begin(), pieces[piece].end(), '\n')) + 1);
+            parsePartPiece(pieces[piece], chunk, [&chunk](Part& part) { chunk.parts.push_back(std::move(part)); });
+        });
+        size_t total = 0;
+        for (const PartLoadChunk& chunk : chunks) {
+            total += chunk.parts.size();
+        }
+        loadedParts.reserve(total);
+        for (PartLoadChunk& chunk : chunks) {
+            for (Part& part : chunk.parts) {
+                store(part);
+            }
+        }
+    }
+    VEHICLE_COUNT("partLinesRejected", reportRejectedLines("Incorrect part format: ", fileName, chunks));
+
+    VEHICLE_COUNT("partsLoaded", loadedParts.size());
+
+    // Publish the loaded parts
+    unique_lock<shared_mutex> registryLock(partRegistryMutex);
+    partHash.swap(loadedParts);
+    modelPartIndex.swap(loadedIndex);
+    partID = nextPartID;
+    partRegistryVersion++;
+}
+
+/**
+ * @brief Adds a part to the part registry.
+ *
+ * Assigns the next part ID to the part and stores it in partHash.
+ *
+ * @param part The part to add; its partID is overwritten with the assigned ID.
+ * @return The assigned part ID.
+ */
+int addPart(Part& part) {
+    unique_lock<shared_mutex> registryLock(partRegistryMutex);
+    part.partID = partID++;
+    partHash[to_string(part.partID)] = part;
+    indexPart(modelPartIndex, part);
+    partRegistryVersion++;
+    return part.partID;
+}
+
+/**
+ * @brief Counts the parts in the part registry.
+ *
+ * @return The number of parts in partHash.
+ */
+int CountParts() {
+    VEHICLE_TIMED("CountParts");
+
+    shared_lock<shared_mutex> registryLock(partRegistryMutex);
+    return static_cast<int>(partHash.size());
+}
+
+/**
+ * @brief Keeps a priced quote for reuse by priceJob.
+ *
+ * @param key The key, as returned by quoteKey for the quoted job.
+ * @param quote The quote.
+ * @param partsVersion Value of partRegistryVersion the prices were read at.
+ */
+void cacheQuote(const string& key, const Quote& quote, uint64_t partsVersion) {
+    lock_guard<mutex> cacheLock(quoteCacheMutex);
+    if (quoteCache.size() >= quoteCacheLimit && quoteCache.find(key) == quoteCache.end()) {
+        quoteCache.clear();
+    }
+    quoteCache[key] = CachedQuote{ partsVersion, quote };
+}
+
+/**
+ * @brief Looks up a quote priced at the current part registry version.
+ *
+ * @param key The key, as returned by quoteKey.
+ * @param quote Receives the cached quote.
+ * @return true if the quote was cached and its prices are current.
+ */
+bool findCachedQuote(const string& key, Quote& quote) {
+    lock_guard<mutex> cacheLock(quoteCacheMutex);
+    auto cached = quoteCache.find(key);
+    if (cached == quoteCache.end() || cached->second.partsVersion != partRegistryVersion.load()) {
+        return false;
+    }
+    quote = cached->second.quote;
+    return true;
+}
+
+/**
+ * @brief Prices a job: a set of parts fitted to a vehicle model.
+ *
+ * A job priced before at the current part registry version is returned from
+ * quoteCache, so a standard job is priced once and then always the same way.
+ * Parts that are unknown or do not fit the model are left off the quote.
+ *
+ * @param model The vehicle model.
+ * @param partIDs The parts of the job; repeated IDs count as quantities.
+ * @return Quote The priced quote.
+ */
+Quote priceJob(const string& model, const vector<int>& partIDs) {
+    VEHICLE_TIMED("priceJob");
+
+    Quote quote;
+    string key = quoteKey(model, partIDs);
+    if (findCachedQuote(key, quote)) {
+        VEHICLE_COUNT("quoteCacheHits", 1);
+        return quote;
+    }
+
+    quote.model = model;
+    uint64_t partsVersion = 0;
+    {
+        shared_lock<shared_mutex> registryLock(partRegistryMutex);
+        partsVersion = partRegistryVersion.load();
+        ModelName symbol;
+        bool knownModel = ModelName::find(model, symbol);
+        for (int id : partIDs) {
+            auto found = partHash.find(to_string(id));
+            if (knownModel && found != partHash.end() && found->second.compatiblemodel == symbol) {
+                addQuotePart(quote, found->second);
+            }
+        }
+    }
+
+    // Cached under the requested parts, so a job with unusable parts is not priced again either
+    cacheQuote(key, quote, partsVersion);
+    return quote;
+}
+
+/**
+ * @brief Lists the standard jobs of a model: the jobs priced in quoteCache at the current part registry version.
+ *
+ * @param model The vehicle model.
+ * @return The cached quotes of the model that hold parts, ordered by their key.
+ */
+vector<Quote> standardJobs(const string& model) {
+    VEHICLE_TIMED("standardJobs");
+
+    vector<pair<string, Quote>> jobs;
+    {
+        lock_guard<mutex> cacheLock(quoteCacheMutex);
+        uint64_t partsVersion = partRegistryVersion.load();
+        for (const auto& cached : quoteCache) {
+            if (cached.second.partsVersion == partsVersion && cached.second.quote.model == model && !cached.second.quote.lines.empty()) {
+                jobs.emplace_back(cached.first, cached.second.quote);
+            }
+        }
+    }
+    sort(jobs.begin(), jobs.end(), [](const pair<string, Quote>& a, const pair<string, Quote>& b) { return a.first < b.first; });
+
+    vector<Quote> quotes;
+    quotes.reserve(jobs.size());
+    for (pair<string, Quote>& job : jobs) {
+        quotes.push_back(std::move(job.second));
+    }
+    return quotes;
+}
+
+/**
+ * @brief Finds all parts compatible with a vehicle model.
+ *
+ * Only the parts listed under the model in modelPartIndex are visited, and
+ * matching compares model IDs. A model that was never interned has no parts.
+ *
+ * @param model The vehicle model to search for.
+ * @return Copies of the parts whose compatible model matches, in the order they were added.
+ */
+vector<Part> findPartsByModel(const string& model) {
+    VEHICLE_TIMED("findPartsByModel");
+
+    vector<Part> parts;
+
+    ModelName symbol;
+    if (!ModelName::find(model, symbol)) {
+        return parts;
+    }
+
+    shared_lock<shared_mutex> registryLock(partRegistryMutex);
+    if (symbol.value() >= modelPartIndex.size()) {
+        return parts;
+    }
+    for (int id : modelPartIndex[symbol.value()]) {
+        auto found = partHash.find(to_string(id));
+        // Parts removed from partHash directly leave stale IDs behind
+        if (found != partHash.end() && found->second.compatiblemodel == symbol) {
+            parts.push_back(found->second);
+        }
+    }
+
+    return parts;
+}
+
+/**
+ * @brief Returns one page of the part registry.
+ *
+ * @param start Index of the first part on the page.
+ * @param count Maximum number of parts on the page.
+ * @return Copies of the parts on the requested page.
+ */
+vector<Part> listPartsPage(int start, int count) {
+    VEHICLE_TIMED("listPartsPage");
+
+    vector<Part> parts;
+
+    shared_lock<shared_mutex> registryLock(partRegistryMutex);
+    auto it = partHash.begin();
+    for (int i = 0; i < start && it != partHash.end(); ++i) {
+        ++it;
+    }
+    for (int i = 0; i < count && it != partHash.end(); ++i, ++it) {
+        parts.push_back(it->second);
+    }
+
+    return parts;
+}
+
+/**
+ * @brief Writes one part in the parts file format.
+ *
+ * The line holds the part name, compatible model and price separated by spaces.
+ *
+ * @param out The stream to write to.
+ * @param part The part to write.
+ */
+void formatPartLine(ostream& out, const Part& part) {
+    out << part.name << " " << part.compatiblemodel << " " << part.price << "\n";
+}
+
+/**
+ * @brief Writes part information to a file.
+ *
+ * This function appends part information to the specified file.
+ *
+ * @param part The part information to be written to the file.
+ */
+void writePartToFile(const Part& part, const char* fileName) {
+    VEHICLE_TIMED("writePartToFile");
+
+    lock_guard<mutex> fileLock(partFileMutex);
+    ofstream file(fileName, ios::app);
+
+    // Write part information to the file
+    formatPartLine(file, part);
+
+    // Close the file
+    file.close();
+}
+
+/**
+ * @brief Converts a vehicle into its on-disk record.
+ *
+ * @param vehicle The vehicle to convert.
+ * @return The fixed-width record of the vehicle.
+ */
+VehicleRecord toVehicleRecord(const Vehicle& vehicle) {
+    VehicleRecord record;
+    record.vehicleID = vehicle.vehicleID;
+    record.reserved = 0;
+    record.customerID = vehicle.customerID;
+    copyRecordField(record.customerName, sizeof(record.customerName), vehicle.customerName);
+    copyRecordField(record.model, sizeof(record.model), vehicle.model.str());
+    copyRecordField(record.plateNumber, sizeof(record.plateNumber), vehicle.plateNumber);
+    return record;
+}
+
+/**
+ * @brief Fills a vehicle from its on-disk record.
+ *
+ * @param record The record read from the vehicle file.
+ * @param vehicle The vehicle to fill; its list pointers are left untouched.
+ */
+void fromVehicleRecord(const VehicleRecord& record, Vehicle& vehicle) {
+    vehicle.vehicleID = record.vehicleID;
+    vehicle.customerID = record.customerID;
+    vehicle.customerName.assign(record.customerName, strnlen(record.customerName, sizeof(record.customerName)));
+    vehicle.model = ModelName(string_view(record.model, strnlen(record.model, sizeof(record.model))));
+    vehicle.plateNumber.assign(record.plateNumber, strnlen(record.plateNumber, sizeof(record.plateNumber)));
+}
+
+/**
+ * @brief Normalizes a plate number for lookups.
+ *
+ * Spaces, dashes and other separators are dropped and letters are upper-cased,
+ * so "34 abc-123" and "34ABC123" give the same key.
+ *
+ * @param plate The plate number as written.
+ * @return The normalized plate number.
+ */
+string normalizePlate(string_view plate) {
+    string key;
+    key.reserve(plate.size());
+    for (char c : plate) {
+        if (isalnum(static_cast<unsigned char>(c))) {
+            key.push_back(static_cast<char>(toupper(static_cast<unsigned char>(c))));
+        }
+    }
+    return key;
+}
+
+/**
+ * @brief Adds a vehicle to a vehicle index, a plate index and its customer's vehicle list.
+ *
+ * @param index The vehicle index.
+ * @param customers The customer table.
+ * @param plates The plate index; a plate shared with another vehicle now resolves to this one.
+ * @param vehicle The vehicle to add.
+ */
+void indexVehicle(unordered_map<int, Vehicle*>& index, unordered_map<long long, Customer>& customers, unordered_map<string, int>& plates, Vehicle* vehicle) {
+    index[vehicle->vehicleID] = vehicle;
+    plates[normalizePlate(vehicle->plateNumber)] = vehicle->vehicleID;
+
+    Customer& customer = customers[vehicle->customerID];
+    customer.customerID = vehicle->customerID;
+    customer.name.assign(vehicle->customerName.data(), vehicle->customerName.size());
+    customer.vehicleIDs.push_back(vehicle->vehicleID);
+}
+
+/**
+ * @brief Removes a vehicle from a vehicle index, a plate index and its customer's vehicle list.
+ *
+ * A customer left without vehicles is removed from the customer table.
+ *
+ * @param index The vehicle index.
+ * @param customers The customer table.
+ * @param plates The plate index.
+ * @param vehicle The vehicle to remove.
+ */
+void unindexVehicle(unordered_map<int, Vehicle*>& index, unordered_map<long long, Customer>& customers, unordered_map<string, int>& plates, const Vehicle* vehicle) {
+    index.erase(vehicle->vehicleID);
+
+    auto plate = plates.find(normalizePlate(vehicle->plateNumber));
+    if (plate != plates.end() && plate->second == vehicle->vehicleID) {
+        plates.erase(plate);
+    }
+
+    auto customer = customers.find(vehicle->customerID);
+    if (customer == customers.end()) {
+        return;
+    }
+    vector<int>& vehicleIDs = customer->second.vehicleIDs;
+    vehicleIDs.erase(remove(vehicleIDs.begin(), vehicleIDs.end(), vehicle->vehicleID), vehicleIDs.end());
+    if (vehicleIDs.empty()) {
+        customers.erase(customer);
+    }
+}
+
+/**
+ * @brief Creates an empty vehicle whose text fields keep their bytes in an arena.
+ *
+ * @param arena The arena the vehicle and its strings are allocated from.
+ * @return Pointer to the new vehicle.
+ */
+Vehicle* createArenaVehicle(RecordArena<Vehicle>& arena) {
+    pmr::memory_resource* strings = arena.resource();
+    return arena.create(0, 0LL, pmr::string(strings), ModelName(), pmr::string(strings), nullptr, nullptr);
+}
+
+/**
+ * @brief Writes vehicle information to a binary file.
+ *
+ * This function appends the fixed-width record of the vehicle to the specified file.
+ *
+ * @param vehicle Pointer to the Vehicle object to be written to the file.
+ * @throw runtime_error if the file cannot be opened for writing.
+ */
+void writeVehicleToFile(Vehicle* vehicle, const char* fileName) {
+    VEHICLE_TIMED("writeVehicleToFile");
+
+    lock_guard<mutex> fileLock(vehicleFileMutex);
+    ofstream file(fileName, ios::binary | ios::app);
+
+    // Write the fixed-width record of the vehicle to the file
+    VehicleRecord record = toVehicleRecord(*vehicle);
+    file.write((char*)&record, sizeof(VehicleRecord));
+
+    // Close the file
+    file.close();
+}
+
+/**
+ * @brief Updates the vehicle file by writing the linked list of vehicles to a temporary file.
  *
  * This function iterates through the linked list of vehicles, writes each vehicle to a temporary file,
  * removes the original vehicle file, and renames the temporary file to the original file.
  */
-void updateVehicleFile(const char* tempvehiclefileName, const char* vehiclefileName) {
-    // Create a temporary file.
-    fstream tempFile(tempvehiclefileName, ios::binary | ios::out);
+void updateVehicleFile(const char* tempvehiclefileName, const char* vehiclefileName) {
+    VEHICLE_TIMED("updateVehicleFile");
+
+    lock_guard<mutex> fileLock(vehicleFileMutex);
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    // Create a temporary file.
+    fstream tempFile(tempvehiclefileName, ios::binary | ios::out);
+
+    // Write all of the vehicles in the linked list to the temporary file.
+    Vehicle* current = headVehicle;
+    while (current != nullptr) {
+        VehicleRecord record = toVehicleRecord(*current);
+        tempFile.write((char*)&record, sizeof(VehicleRecord));
+        VEHICLE_COUNT("vehiclesWritten", 1);
+        current = current->next;
+    }
+
+    // Close the temporary file.
+    tempFile.close();
+
+    // Remove the save file.
+    remove(vehiclefileName);
+
+    // Rename the temporary file to the save file.
+    rename(tempvehiclefileName, vehiclefileName);
+}
+
+/**
+ * @brief Loads vehicles from a binary file into a linked list.
+ *
+ * This function reads vehicles from the specified file and creates a linked list
+ * of vehicles with the information loaded from the file. The list is built privately
+ * in a new arena sized from the file, and published in one short critical section.
+ * The arena of the replaced list is released at once after the lock is dropped.
+ * Records are read in blocks of vehicleLoadBlockRecords. The vehicle index, plate
+ * index and customer table are rebuilt in the same pass.
+ */
+void loadVehiclesFromFile(const char* fileName) {
+    VEHICLE_TIMED("loadVehiclesFromFile");
+
+    ifstream file(fileName, ios::binary);
+
+    if (!file.is_open()) {
+        return;
+    }
+
+    // Initialize the next vehicle ID to 0
+    int nextVehicleID = 0;
+
+    // Size the arena for the records in the file
+    file.seekg(0, ios::end);
+    size_t recordCount = static_cast<size_t>(file.tellg()) / sizeof(VehicleRecord);
+    file.seekg(0, ios::beg);
+    unique_ptr<RecordArena<Vehicle>> arena = make_unique<RecordArena<Vehicle>>(recordCount);
+
+    Vehicle* head = nullptr;    // Head of the privately built list
+    Vehicle* current = nullptr; // Initialize the current pointer to nullptr
+
+    unordered_map<int, Vehicle*> loadedIndex;
+    unordered_map<long long, Customer> loadedCustomers;
+    unordered_map<string, int> loadedPlates;
+    loadedIndex.reserve(recordCount);
+    loadedPlates.reserve(recordCount);
+
+    vector<VehicleRecord> block(vehicleLoadBlockRecords);
+    while (true) {
+        // Read the next block of records; a trailing partial record is ignored
+        file.read((char*)block.data(), block.size() * sizeof(VehicleRecord));
+        size_t records = static_cast<size_t>(file.gcount()) / sizeof(VehicleRecord);
+        if (records == 0) {
+            // If we can't read a record, we've reached the end of the file
+            break;
+        }
+
+        for (size_t i = 0; i < records; ++i) {
+            Vehicle* newVehicle = createArenaVehicle(*arena); // Allocate a new vehicle node in the arena
+            fromVehicleRecord(block[i], *newVehicle);
+
+            newVehicle->prev = current;
+
+            if (current) {
+                current->next = newVehicle;
+            }
+            else {
+                // If current is nullptr, this is the first node
+                head = newVehicle;
+            }
+
+            // A later record with the same vehicle ID replaces the earlier one in the indexes
+            auto duplicate = loadedIndex.find(newVehicle->vehicleID);
+            if (duplicate != loadedIndex.end()) {
+                unindexVehicle(loadedIndex, loadedCustomers, loadedPlates, duplicate->second);
+            }
+            indexVehicle(loadedIndex, loadedCustomers, loadedPlates, newVehicle);
+
+            current = newVehicle;
+            nextVehicleID = newVehicle->vehicleID + 1; // Update the vehicle ID from the loaded vehicle
+        }
+        VEHICLE_COUNT("vehiclesLoaded", records);
+    }
+
+    file.close();
+
+    // Publish the loaded list
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    if (head) {
+        headVehicle = head;
+        tailVehicle = current;
+        vehicleArena.swap(arena);
+        vehicleIndex.swap(loadedIndex);
+        customerTable.swap(loadedCustomers);
+        plateIndex.swap(loadedPlates);
+    }
+    vehicleID = nextVehicleID;
+}
+
+/**
+ * @brief Counts the number of vehicles in the linked list.
+ *
+ * This function traverses the linked list and counts the number of vehicles.
+ *
+ * @return The number of vehicles in the linked list.
+ */
+int CountVehicles() {
+    VEHICLE_TIMED("CountVehicles");
+
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    int count = 0;
+    Vehicle* current = headVehicle;
+    while (current != nullptr) {
+        count++;
+        current = current->next;
+    }
+    return count;
+}
+
+/**
+ * @brief Finds a vehicle by its vehicle ID.
+ *
+ * @param id The vehicle ID to search for.
+ * @param found Receives a copy of the vehicle when it exists.
+ * @return true if the vehicle was found, false otherwise.
+ */
+bool findVehicle(int id, Vehicle& found) {
+    VEHICLE_TIMED("findVehicle");
+
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    auto entry = vehicleIndex.find(id);
+    if (entry == vehicleIndex.end()) {
+        return false;
+    }
+
+    found = *entry->second;
+    return true;
+}
+
+/**
+ * @brief Finds a vehicle by its plate number.
+ *
+ * The plate is normalized first, so case, spaces and dashes do not matter.
+ *
+ * @param plate The plate number to search for.
+ * @param found Receives a copy of the vehicle when it exists.
+ * @return true if the vehicle was found, false otherwise.
+ */
+bool findVehicleByPlate(const string& plate, Vehicle& found) {
+    VEHICLE_TIMED("findVehicleByPlate");
+
+    string key = normalizePlate(plate);
+
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    auto entry = plateIndex.find(key);
+    if (entry == plateIndex.end()) {
+        return false;
+    }
+
+    found = *vehicleIndex.at(entry->second);
+    return true;
+}
+
+/**
+ * @brief Resolves a vehicle ID or plate number entered by the user.
+ *
+ * Input made only of digits is taken as a vehicle ID if such a vehicle exists;
+ * anything else, or an unknown ID, is looked up as a plate number.
+ *
+ * @param input The vehicle ID or plate number.
+ * @param found Receives a copy of the vehicle when it exists.
+ * @return true if the vehicle was found, false otherwise.
+ */
+bool findVehicleByIdOrPlate(const string& input, Vehicle& found) {
+    bool numeric = !input.empty() && input.size() < 10 && all_of(input.begin(), input.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)) != 0; });
+    if (numeric && findVehicle(stoi(input), found)) {
+        return true;
+    }
+
+    return findVehicleByPlate(input, found);
+}
+
+/**
+ * @brief Returns one page of the vehicle registry.
+ *
+ * @param start Index of the first vehicle on the page.
+ * @param count Maximum number of vehicles on the page.
+ * @return Copies of the vehicles on the requested page.
+ */
+vector<Vehicle> listVehiclesPage(int start, int count) {
+    VEHICLE_TIMED("listVehiclesPage");
+
+    vector<Vehicle> vehicles;
+
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    Vehicle* current = headVehicle;
+    for (int i = 0; i < start && current != nullptr; ++i) {
+        current = current->next;
+    }
+    for (int i = 0; i < count && current != nullptr; ++i) {
+        vehicles.push_back(*current);
+        current = current->next;
+    }
+
+    return vehicles;
+}
+
+/**
+ * @brief Links a vehicle at the end of the list, assigns the next vehicle ID and indexes the vehicle.
+ *
+ * The caller holds vehicleRegistryMutex exclusively.
+ *
+ * @param vehicle The vehicle to link.
+ * @return The assigned vehicle ID.
+ */
+int linkVehicle(Vehicle* vehicle) {
+    // An empty list has no indexed vehicles
+    if (!headVehicle) {
+        vehicleIndex.clear();
+        customerTable.clear();
+        plateIndex.clear();
+    }
+
+    vehicle->vehicleID = vehicleID++;
+    vehicle->next = nullptr;
+    vehicle->prev = nullptr;
+
+    if (!headVehicle) {
+        headVehicle = vehicle;
+    }
+    else {
+        tailVehicle->next = vehicle;
+        vehicle->prev = tailVehicle;
+    }
+    tailVehicle = vehicle;
+
+    indexVehicle(vehicleIndex, customerTable, plateIndex, vehicle);
+    return vehicle->vehicleID;
+}
+
+/**
+ * @brief Appends a vehicle to the vehicle registry.
+ *
+ * Assigns the next vehicle ID and links the vehicle at the end of the list.
+ *
+ * @param vehicle The vehicle to register; it stays owned by the caller and must outlive its registration.
+ * @return The assigned vehicle ID.
+ */
+int registerVehicle(Vehicle* vehicle) {
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    return linkVehicle(vehicle);
+}
+
+/**
+ * @brief Adds a copy of a vehicle to the vehicle registry.
+ *
+ * The copy is allocated in the vehicle arena, so the registry owns it.
+ *
+ * @param fields Vehicle carrying the customer ID, customer name, model and plate number.
+ * @return The assigned vehicle ID.
+ */
+int registerVehicle(const Vehicle& fields) {
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    Vehicle* vehicle = createArenaVehicle(*vehicleArena);
+    vehicle->customerID = fields.customerID;
+    vehicle->customerName = fields.customerName;
+    vehicle->model = fields.model;
+    vehicle->plateNumber = fields.plateNumber;
+    return linkVehicle(vehicle);
+}
+
+/**
+ * @brief Updates the customer and vehicle fields of a registered vehicle.
+ *
+ * @param id The vehicle ID to update.
+ * @param fields Vehicle carrying the new customer ID, customer name, model and plate number.
+ * @return true if the vehicle was found and updated, false otherwise.
+ */
+bool updateVehicle(int id, const Vehicle& fields) {
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    auto entry = vehicleIndex.find(id);
+    if (entry == vehicleIndex.end()) {
+        return false;
+    }
+
+    Vehicle* current = entry->second;
+    unindexVehicle(vehicleIndex, customerTable, plateIndex, current);
+    current->customerID = fields.customerID;
+    current->customerName = fields.customerName;
+    current->model = fields.model;
+    current->plateNumber = fields.plateNumber;
+    indexVehicle(vehicleIndex, customerTable, plateIndex, current);
+    return true;
+}
+
+/**
+ * @brief Unlinks a vehicle from the vehicle registry.
+ *
+ * A vehicle owned by the vehicle arena is destroyed and its slot reused by the next registration.
+ *
+ * @param id The vehicle ID to remove.
+ * @return true if the vehicle was found and removed, false otherwise.
+ */
+bool removeVehicle(int id) {
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    auto entry = vehicleIndex.find(id);
+    if (entry == vehicleIndex.end()) {
+        return false;
+    }
+
+    Vehicle* current = entry->second;
+    unindexVehicle(vehicleIndex, customerTable, plateIndex, current);
+    if (current->prev) {
+        current->prev->next = current->next;
+    }
+    else {
+        headVehicle = current->next;
+    }
+    if (current->next) {
+        current->next->prev = current->prev;
+    }
+    else {
+        tailVehicle = current->prev;
+    }
+    if (vehicleArena->owns(current)) {
+        vehicleArena->destroy(current);
+    }
+    return true;
+}
+
+/**
+ * @brief Empties the vehicle registry.
+ *
+ * The vehicles owned by the vehicle arena are released at once; vehicles
+ * registered by pointer are only unlinked.
+ */
+void clearVehicles() {
+    unique_ptr<RecordArena<Vehicle>> arena = make_unique<RecordArena<Vehicle>>();
+
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    headVehicle = nullptr;
+    tailVehicle = nullptr;
+    vehicleArena.swap(arena);
+    vehicleIndex.clear();
+    customerTable.clear();
+    plateIndex.clear();
+}
+
+/**
+ * @brief Finds a customer by customer ID.
+ *
+ * @param customerID The customer ID to search for.
+ * @param found Receives a copy of the customer, including their vehicle IDs, when it exists.
+ * @return true if the customer has registered vehicles, false otherwise.
+ */
+bool findCustomer(long long customerID, Customer& found) {
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+
+    auto entry = customerTable.find(customerID);
+    if (entry == customerTable.end()) {
+        return false;
+    }
+
+    found = entry->second;
+    return true;
+}
+
+/**
+ * @brief Returns the vehicles of a customer.
+ *
+ * Runs in time proportional to the size of the customer's fleet.
+ *
+ * @param customerID The customer ID.
+ * @return Copies of the customer's vehicles in registration order.
+ */
+vector<Vehicle> findVehiclesByCustomer(long long customerID) {
+    VEHICLE_TIMED("findVehiclesByCustomer");
+
+    vector<Vehicle> vehicles;
+
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    auto entry = customerTable.find(customerID);
+    if (entry == customerTable.end()) {
+        return vehicles;
+    }
+
+    vehicles.reserve(entry->second.vehicleIDs.size());
+    for (int id : entry->second.vehicleIDs) {
+        vehicles.push_back(*vehicleIndex.at(id));
+    }
+
+    return vehicles;
+}
+
+/**
+ * @brief Returns the appointments booked for the vehicles of a customer.
+ *
+ * Runs in time proportional to the customer's fleet and its appointments.
+ *
+ * @param customerID The customer ID.
+ * @return Pairs of date and appointment, grouped by vehicle in registration order and sorted by date within a vehicle.
+ */
+vector<pair<Date, Appointment>> findAppointmentsByCustomer(long long customerID) {
+    VEHICLE_TIMED("findAppointmentsByCustomer");
+
+    vector<pair<Date, Appointment>> appointments;
+
+    shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    auto entry = customerTable.find(customerID);
+    if (entry == customerTable.end()) {
+        return appointments;
+    }
+
+    shared_lock<shared_mutex> indexLock(vehicleAppointmentsMutex);
+    for (int id : entry->second.vehicleIDs) {
+        auto booked = vehicleAppointments.find(id);
+        if (booked == vehicleAppointments.end()) {
+            continue;
+        }
+        for (const VehicleAppointment& appointment : booked->second) {
+            appointments.push_back({ civilDate(appointment.day), Appointment{ id, entry->second.name, appointment.appointmentType } });
+        }
+    }
+
+    return appointments;
+}
+
+/**
+ * @brief Finds an appointment of a vehicle that a booking on a given date would conflict with.
+ *
+ * Looks up the vehicle's sorted appointments with one binary search, so the
+ * check takes O(log n) in the number of appointments of the vehicle.
+ *
+ * @param vehicleID The vehicle; appointments without a vehicle never conflict.
+ * @param date The date of the booking.
+ * @param conflict Receives the earliest appointment less than appointmentConflictDays from the date.
+ * @return true if there is such an appointment.
+ */
+bool findVehicleConflict(int vehicleID, const Date& date, VehicleAppointment& conflict) {
+    if (vehicleID <= 0) {
+        return false;
+    }
+
+    CalendarDay day = calendarDay(date);
+    shared_lock<shared_mutex> indexLock(vehicleAppointmentsMutex);
+    auto booked = vehicleAppointments.find(vehicleID);
+    if (booked == vehicleAppointments.end()) {
+        return false;
+    }
+
+    auto position = lower_bound(booked->second.begin(), booked->second.end(), day.addDays(1 - appointmentConflictDays),
+        [](const VehicleAppointment& entry, CalendarDay value) { return entry.day < value; });
+    if (position == booked->second.end() || position->day >= day.addDays(appointmentConflictDays)) {
+        return false;
+    }
+    conflict = *position;
+    return true;
+}
+
+/**
+ * @brief Lists every pair of appointments of the same vehicle less than appointmentConflictDays apart.
+ *
+ * The vehicles of the per-vehicle appointment index are split between the
+ * threads, and each thread walks the sorted appointments of its vehicles.
+ *
+ * @param threads Number of threads, 0 for one per hardware thread.
+ * @return The conflicts, sorted by vehicle ID and then by the dates of the two appointments.
+ */
+vector<AppointmentConflict> findAllConflicts(int threads = 0) {
+    VEHICLE_TIMED("findAllConflicts");
+
+    shared_lock<shared_mutex> indexLock(vehicleAppointmentsMutex);
+    vector<const pair<const int, vector<VehicleAppointment>>*> vehicles;
+    vehicles.reserve(vehicleAppointments.size());
+    for (const auto& booked : vehicleAppointments) {
+        if (booked.second.size() > 1) {
+            vehicles.push_back(&booked);
+        }
+    }
+
+    size_t workers = threads > 0 ? static_cast<size_t>(threads) : max(1u, thread::hardware_concurrency());
+    workers = max<size_t>(1, min(workers, vehicles.size()));
+    vector<vector<AppointmentConflict>> found(workers);
+    runInParallel(workers, [&](size_t worker) {
+        for (size_t i = vehicles.size() * worker / workers; i < vehicles.size() * (worker + 1) / workers; ++i) {
+            const vector<VehicleAppointment>& booked = vehicles[i]->second;
+            for (size_t first = 0; first < booked.size(); ++first) {
+                CalendarDay end = booked[first].day.addDays(appointmentConflictDays);
+                for (size_t second = first + 1; second < booked.size() && booked[second].day < end; ++second) {
+                    found[worker].push_back({ vehicles[i]->first, booked[first], booked[second] });
+                }
+            }
+        }
+    });
+
+    vector<AppointmentConflict> conflicts;
+    for (vector<AppointmentConflict>& part : found) {
+        conflicts.insert(conflicts.end(), make_move_iterator(part.begin()), make_move_iterator(part.end()));
+    }
+    sort(conflicts.begin(), conflicts.end(), [](const AppointmentConflict& a, const AppointmentConflict& b) {
+        if (a.vehicleID != b.vehicleID) {
+            return a.vehicleID < b.vehicleID;
+        }
+        return a.first.day != b.first.day ? a.first.day < b.first.day : a.second.day < b.second.day;
+    });
+    VEHICLE_COUNT("appointmentConflicts", conflicts.size());
+    return conflicts;
+}
+
+/**
+ * @brief Builds a search index over customer names, plates, models and part names.
+ *
+ * The index is a snapshot: vehicles and parts changed afterwards are not reflected
+ * until the index is built again. Plates are indexed in their normalized form.
+ *
+ * @return SearchIndex The built index.
+ */
+SearchIndex buildSearchIndex() {
+    VEHICLE_TIMED("buildSearchIndex");
+
+    SearchIndex index;
+    vector<bool> modelAdded;
+    auto addModel = [&](const ModelName& model) {
+        if (model.value() >= modelAdded.size()) {
+            modelAdded.resize(model.value() + 1);
+        }
+        if (!modelAdded[model.value()]) {
+            modelAdded[model.value()] = true;
+            index.add(SearchKind::Model, model.str(), model.value());
+        }
+    };
+
+    {
+        shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+        for (const auto& entry : customerTable) {
+            index.add(SearchKind::Customer, entry.second.name, entry.first);
+        }
+        for (const auto& entry : vehicleIndex) {
+            index.add(SearchKind::Plate, normalizePlate(entry.second->plateNumber), entry.first);
+            addModel(entry.second->model);
+        }
+    }
+
+    {
+        shared_lock<shared_mutex> registryLock(partRegistryMutex);
+        for (const auto& entry : partHash) {
+            index.add(SearchKind::Part, entry.second.name, entry.second.partID);
+            addModel(entry.second.compatiblemodel);
+        }
+    }
+
+    index.build();
+    return index;
+}
+
+/**
+ * @brief Returns the number of slots an appointment type occupies a bay for.
+ *
+ * @param appointmentType The appointment type.
+ * @return int The booked minutes of the type rounded up to whole slots, between 1 and slotsPerWorkday.
+ */
+int appointmentSlots(const string& appointmentType) {
+    auto minutes = appointmentTypeMinutes.find(appointmentType);
+    int length = minutes != appointmentTypeMinutes.end() ? minutes->second : defaultAppointmentMinutes;
+    return min(max((length + slotMinutes - 1) / slotMinutes, 1), slotsPerWorkday);
+}
+
+/**
+ * @brief Formats the start time of a slot as HH:MM.
+ *
+ * @param slot The slot of the day, from 0.
+ * @return string The time.
+ */
+string slotTime(int slot) {
+    int minute = workdayStartMinute + slot * slotMinutes;
+    ostringstream time;
+    time << setfill('0') << setw(2) << minute / 60 << ":" << setw(2) << minute % 60;
+    return time.str();
+}
 
-    // Write all of the vehicles in the linked list to the temporary file.
-    Vehicle* current = headVehicle;
-    while (current != nullptr) {
-        tempFile.write((char*)current, sizeof(Vehicle));
-        current = current->next;
+/**
+ * @brief Books an appointment on the first free bay slots on or after a date and queues it.
+ *
+ * The appointment occupies a bay for the slots of its type. The earliest start on
+ * the first day with room is taken, looking at most bookingHorizonDays ahead.
+ * The conflict check, the bay reservation and the entry in the per-vehicle
+ * appointment index happen under bayScheduleMutex. A second booking for the same
+ * vehicle therefore sees the first one, even before the committer has run. A
+ * booking moved past the last day of the appointment matrix takes no slots, as
+ * the committer could not add it.
+ *
+ * @param date The requested date; receives the booked date.
+ * @param appointment The appointment.
+ * @param booking Receives the booked bay and slots.
+ * @param conflict Receives the clashing appointment of the vehicle on BookingVehicleConflict.
+ * @return BookingOutcome Whether the appointment was booked, and why not otherwise.
+ */
+BookingOutcome bookAppointment(Date& date, const Appointment& appointment, SlotBooking& booking, VehicleAppointment& conflict) {
+    VEHICLE_TIMED("bookAppointment");
+
+    Date booked;
+    {
+        lock_guard<mutex> scheduleLock(bayScheduleMutex);
+        if (!bayScheduler.findFirstFree(dayNumber(date), appointmentSlots(appointment.appointmentType), booking, bookingHorizonDays)) {
+            return BookingNoFreeBay;
+        }
+
+        civilFromDays(booking.day, booked.year, booked.month, booked.day);
+        if (!isBookableDate(booked)) {
+            return BookingOutsideCalendar;
+        }
+
+        // The booked day must not clash with another appointment of the vehicle
+        if (findVehicleConflict(appointment.vehicleID, booked, conflict)) {
+            return BookingVehicleConflict;
+        }
+        bayScheduler.reserve(booking);
+        indexVehicleAppointment(booked, appointment);
     }
 
-    // Close the temporary file.
-    tempFile.close();
+    // The committer adds the appointment to the matrix and the file; indexing it again there records it once
+    Appointment confirmed = appointment;
+    confirmed.bay = booking.bay;
+    confirmed.firstSlot = booking.firstSlot;
+    date = booked;
+    submitAppointment(date, confirmed);
+    return BookingConfirmed;
+}
 
-    // Remove the save file.
-    remove(vehiclefileName);
+/**
+ * @brief Takes the bay slots of the appointments already in an appointments file.
+ *
+ * The file is replayed in order. An appointment that records its bay takes
+ * exactly the slots bookAppointment gave it; one written without a bay takes the
+ * earliest free slots of its own date. Appointments that no longer fit their
+ * date are counted, not moved.
+ * The appointments themselves are not added to the matrix, but those with a
+ * vehicle are recorded in the per-vehicle appointment index for conflict checks.
+ *
+ * @param fileName The appointments file.
+ * @return size_t The number of appointments that did not fit their date.
+ */
+size_t reserveBookedSlots(const char* fileName) {
+    VEHICLE_TIMED("reserveBookedSlots");
+
+    string text = readWholeFile(fileName);
+    LineScanner lines(text);
+    string_view line;
+    Date date;
+    Appointment appointment;
+    size_t overbooked = 0;
+    vector<PendingAppointment> vehicleBookings;
+
+    {
+        lock_guard<mutex> scheduleLock(bayScheduleMutex);
+        while (lines.next(line)) {
+            if (!parseAppointmentLine(line, date, appointment)) {
+                continue;
+            }
+            SlotBooking booking{ dayNumber(date), appointment.bay, appointment.firstSlot, appointmentSlots(appointment.appointmentType) };
+            bool reserved = appointment.bay >= 0
+                ? bayScheduler.reserve(booking)
+                : bayScheduler.findFreeOnDay(booking.day, booking.slotCount, booking) && bayScheduler.reserve(booking);
+            if (!reserved) {
+                overbooked++;
+            }
+            if (appointment.vehicleID > 0) {
+                vehicleBookings.push_back({ date, appointment });
+            }
+        }
+    }
 
-    // Rename the temporary file to the save file.
-    rename(tempvehiclefileName, vehiclefileName);
+    for (const PendingAppointment& booking : vehicleBookings) {
+        indexVehicleAppointment(booking.date, booking.appointment);
+    }
+    VEHICLE_COUNT("appointmentsOverbooked", overbooked);
+    return overbooked;
 }
 
 /**
- * @brief Loads vehicles from a binary file into a linked list.
+ * @brief Writes the appointments and service reports into a new columnar archive.
  *
- * This function reads vehicles from the specified file and creates a linked list
- * of vehicles with the information loaded from the file.
+ * Models are looked up in the vehicle registry by vehicle ID and stay empty for
+ * unregistered vehicles. The previous archive is replaced only once the new one
+ * is complete.
+ *
+ * @param archivePath The path of the archive.
+ * @param appointmentsPath The appointments file.
+ * @param historyPath The service file holding the reports.
+ * @return The number of archived rows, or -1 if the archive could not be written.
  */
-void loadVehiclesFromFile(const char* fileName) {
-    ifstream file(fileName, ios::binary);
+long long exportServiceArchive(const string& archivePath, const string& appointmentsPath, const string& historyPath) {
+    VEHICLE_TIMED("exportServiceArchive");
 
-    if (!file.is_open()) {
-        return;
+    vector<ArchiveRow> rows;
+
+    ifstream appointmentsFile(appointmentsPath);
+    string line;
+    Date date;
+    Appointment appointment;
+    while (getline(appointmentsFile, line)) {
+        if (parseAppointmentLine(line, date, appointment)) {
+            rows.push_back({ dayNumber(date), appointment.vehicleID, ArchiveAppointment, 0.0f, appointment.appointmentType, string(), appointment.customerName });
+        }
+    }
+
+    for (const ServiceRecord& record : readServiceRecords(historyPath)) {
+        Appointment service = serviceAppointment(record);
+        rows.push_back({ dayNumber(record.date), record.vehicleID, static_cast<uint8_t>(ArchiveReport + record.kind),
+            record.partsAmount + record.laborAmount, service.appointmentType, string(), service.customerName });
     }
 
-    // Initialize vehicleID to 0
-    vehicleID = 0;
+    {
+        shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+        for (ArchiveRow& row : rows) {
+            auto vehicle = vehicleIndex.find(row.vehicleID);
+            if (vehicle != vehicleIndex.end()) {
+                row.model = vehicle->second->model.str();
+            }
+        }
+    }
 
-    Vehicle* current = nullptr; // Initialize the current pointer to nullptr
+    long long count = static_cast<long long>(rows.size());
+    return writeColumnArchive(archivePath, rows) ? count : -1;
+}
 
-    while (true) {
-        Vehicle* newVehicle = new Vehicle; // Allocate memory for a new vehicle node
-        newVehicle->next = nullptr;
+/**
+ * @brief Returns the first day number of every month of a year, followed by that of the next year.
+ */
+array<int32_t, 13> monthStartDays(int year) {
+    array<int32_t, 13> starts;
+    for (int month = 1; month <= 12; ++month) {
+        starts[month - 1] = daysFromCivil(year, month, 1);
+    }
+    starts[12] = daysFromCivil(year + 1, 1, 1);
+    return starts;
+}
 
-        // Attempt to read a Vehicle from the file
-        if (!file.read((char*)newVehicle, sizeof(Vehicle))) {
-            // If we can't read a Vehicle, we've reached the end of the file
-            delete newVehicle; // Free the memory allocated for the last newVehicle
-            break;
+/**
+ * @brief Totals the appointments, service reports and revenue of every month of a year.
+ *
+ * Reads only the day, source and amount columns of the blocks overlapping the year.
+ *
+ * @param archivePath The path of the archive.
+ * @param year The year.
+ * @return Twelve entries, one per month; all zero when the archive cannot be read.
+ */
+vector<MonthlyServiceStats> monthlyServiceStats(const string& archivePath, int year) {
+    VEHICLE_TIMED("monthlyServiceStats");
+
+    vector<MonthlyServiceStats> stats;
+    for (int month = 1; month <= 12; ++month) {
+        stats.push_back({ month, 0, 0, 0.0 });
+    }
+
+    ColumnArchiveReader archive;
+    if (!archive.open(archivePath)) {
+        return stats;
+    }
+
+    array<int32_t, 13> starts = monthStartDays(year);
+    archive.scan(ColumnDay | ColumnSource | ColumnAmount, starts[0], starts[12] - 1, [&](const ArchiveBlock& block) {
+        for (size_t r = 0; r < block.rows; ++r) {
+            if (block.day[r] < starts[0] || block.day[r] >= starts[12]) {
+                continue;
+            }
+            MonthlyServiceStats& month = stats[upper_bound(starts.begin(), starts.end(), block.day[r]) - starts.begin() - 1];
+            if (block.source[r] == ArchiveAppointment) {
+                month.appointments++;
+            }
+            else if (block.source[r] == ArchiveReport) {
+                month.services++;
+                month.revenue += block.amount[r];
+            }
+        }
+    });
+
+    return stats;
+}
+
+/**
+ * @brief Totals the service revenue of every vehicle model in a year.
+ *
+ * Reads only the day, source, amount and model columns of the blocks overlapping the year.
+ *
+ * @param archivePath The path of the archive.
+ * @param year The year.
+ * @return Pairs of model and revenue, highest revenue first. Unregistered vehicles are listed under an empty model.
+ */
+vector<pair<string, double>> revenueByModel(const string& archivePath, int year) {
+    VEHICLE_TIMED("revenueByModel");
+
+    vector<pair<string, double>> revenue;
+    ColumnArchiveReader archive;
+    if (!archive.open(archivePath)) {
+        return revenue;
+    }
+
+    int32_t fromDay = daysFromCivil(year, 1, 1);
+    int32_t toDay = daysFromCivil(year, 12, 31);
+    vector<double> totals(archive.dictionary(ColumnModel).size());
+    archive.scan(ColumnDay | ColumnSource | ColumnAmount | ColumnModel, fromDay, toDay, [&](const ArchiveBlock& block) {
+        for (size_t r = 0; r < block.rows; ++r) {
+            if (block.source[r] == ArchiveReport && block.day[r] >= fromDay && block.day[r] <= toDay) {
+                totals[block.model[r]] += block.amount[r];
+            }
+        }
+    });
+
+    for (size_t code = 0; code < totals.size(); ++code) {
+        if (totals[code] > 0) {
+            revenue.push_back({ archive.dictionary(ColumnModel)[code], totals[code] });
+        }
+    }
+    sort(revenue.begin(), revenue.end(), [](const pair<string, double>& a, const pair<string, double>& b) {
+        return a.second > b.second;
+    });
+    return revenue;
+}
+
+/**
+ * @brief Counts the appointments and services of every type in a year.
+ *
+ * Reads only the day and type columns of the blocks overlapping the year.
+ *
+ * @param archivePath The path of the archive.
+ * @param year The year.
+ * @return Pairs of type and count, most common first.
+ */
+vector<pair<string, size_t>> serviceTypeCounts(const string& archivePath, int year) {
+    VEHICLE_TIMED("serviceTypeCounts");
+
+    vector<pair<string, size_t>> counts;
+    ColumnArchiveReader archive;
+    if (!archive.open(archivePath)) {
+        return counts;
+    }
+
+    int32_t fromDay = daysFromCivil(year, 1, 1);
+    int32_t toDay = daysFromCivil(year, 12, 31);
+    vector<size_t> totals(archive.dictionary(ColumnType).size());
+    archive.scan(ColumnDay | ColumnType, fromDay, toDay, [&](const ArchiveBlock& block) {
+        for (size_t r = 0; r < block.rows; ++r) {
+            if (block.day[r] >= fromDay && block.day[r] <= toDay) {
+                totals[block.type[r]]++;
+            }
+        }
+    });
+
+    for (size_t code = 0; code < totals.size(); ++code) {
+        if (totals[code] > 0 && !archive.dictionary(ColumnType)[code].empty()) {
+            counts.push_back({ archive.dictionary(ColumnType)[code], totals[code] });
+        }
+    }
+    sort(counts.begin(), counts.end(), [](const pair<string, size_t>& a, const pair<string, size_t>& b) {
+        return a.second > b.second;
+    });
+    return counts;
+}
+
+/**
+ * @brief Checks whether an archive is newer than every file it was exported from.
+ *
+ * @param archivePath The path of the archive.
+ * @param sources The files the archive is exported from; missing files are ignored.
+ * @return true if the archive exists and no source was modified after it.
+ */
+bool archiveIsCurrent(const string& archivePath, const vector<string>& sources) {
+    error_code error;
+    auto archiveTime = filesystem::last_write_time(archivePath, error);
+    if (error) {
+        return false;
+    }
+    for (const string& source : sources) {
+        auto sourceTime = filesystem::last_write_time(source, error);
+        if (!error && sourceTime > archiveTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the size and last write time of a file; both are 0 for a missing file.
+ *
+ * @param fileName The file.
+ * @param nextID Next ID of the registry loaded from the file.
+ * @return SnapshotSource The fingerprint.
+ */
+SnapshotSource fileFingerprint(const char* fileName, int64_t nextID) {
+    SnapshotSource source = { 0, 0, nextID };
+    error_code error;
+    uint64_t size = filesystem::file_size(fileName, error);
+    if (!error) {
+        source.size = size;
+    }
+    auto modified = filesystem::last_write_time(fileName, error);
+    if (!error) {
+        source.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    }
+    return source;
+}
+
+/**
+ * @brief Checks that a snapshot image holds a registry loaded from a file as it is now.
+ *
+ * @param image The snapshot image.
+ * @param tag SnapshotVehicleSource, SnapshotPartSource or SnapshotAppointmentSource.
+ * @param fileName The file the registry is loaded from.
+ * @param source Receives the fingerprint stored in the image.
+ * @return true if the file has not changed since the snapshot was taken.
+ */
+bool snapshotSourceIsCurrent(const SnapshotImage& image, SnapshotTag tag, const char* fileName, SnapshotSource& source) {
+    const SnapshotSource* stored;
+    size_t count;
+    if (!image.array(tag, stored, count) || count != 1) {
+        return false;
+    }
+    source = *stored;
+    SnapshotSource current = fileFingerprint(fileName, source.nextID);
+    return current.size == source.size && current.modified == source.modified;
+}
+
+/**
+ * @brief Interns the model names of a snapshot image.
+ *
+ * @param image The snapshot image.
+ * @param models Receives the model of every model ID of the image.
+ * @return false if the model sections are missing or damaged.
+ */
+bool restoreSnapshotModels(const SnapshotImage& image, vector<ModelName>& models) {
+    const SnapshotText* names;
+    size_t count;
+    string_view strings;
+    if (!image.array(SnapshotModels, names, count) || !image.section(SnapshotModelStrings, strings)) {
+        return false;
+    }
+
+    models.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        string_view name;
+        if (!snapshotText(strings, names[i], name)) {
+            return false;
+        }
+        models[i] = ModelName(name);
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the vehicle and part registries with their indexes, and the booked
+ *        appointments with the bay slots, into a snapshot image.
+ *
+ * Every record refers to its strings and models by offset and ID, so the image
+ * can be mapped at any address. The fingerprints of the vehicle, parts and
+ * appointments files are stored with it; a registry is only restored while its
+ * file is unchanged. Recurring contracts and saved quotes are not part of the
+ * image: they keep their own small files, which are read as they are.
+ *
+ * @param snapshotPath The path of the image.
+ * @param vehicleFile The file the vehicles are loaded from.
+ * @param partFile The file the parts are loaded from.
+ * @param appointmentFile The file the appointments are loaded from, nullptr to leave the appointments out.
+ * @return true if the image was written.
+ */
+bool saveStateSnapshot(const string& snapshotPath, const char* vehicleFile, const char* partFile, const char* appointmentFile = nullptr) {
+    VEHICLE_TIMED("saveStateSnapshot");
+
+    SnapshotWriter writer;
+    {
+        shared_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+        SnapshotStrings strings;
+        vector<SnapshotVehicle> vehicles;
+        vector<SnapshotPlate> plates;
+        vector<SnapshotCustomer> customers;
+        vector<int32_t> customerVehicles;
+        vehicles.reserve(vehicleIndex.size());
+        plates.reserve(plateIndex.size());
+        customers.reserve(customerTable.size());
+
+        for (const Vehicle* vehicle = headVehicle; vehicle != nullptr; vehicle = vehicle->next) {
+            auto indexed = vehicleIndex.find(vehicle->vehicleID);
+            vehicles.push_back({ vehicle->vehicleID, vehicle->model.value(), vehicle->customerID, strings.add(vehicle->customerName), strings.add(vehicle->plateNumber),
+                indexed != vehicleIndex.end() && indexed->second == vehicle ? 1u : 0u, 0 });
+        }
+        for (const auto& entry : plateIndex) {
+            plates.push_back({ strings.add(entry.first), entry.second });
+        }
+        for (const auto& entry : customerTable) {
+            customers.push_back({ entry.first, strings.add(entry.second.name), static_cast<uint32_t>(customerVehicles.size()), static_cast<uint32_t>(entry.second.vehicleIDs.size()) });
+            customerVehicles.insert(customerVehicles.end(), entry.second.vehicleIDs.begin(), entry.second.vehicleIDs.end());
+        }
+        if (!strings.fits()) {
+            return false;
+        }
+
+        writer.addArray(SnapshotVehicleSource, vector<SnapshotSource>{ fileFingerprint(vehicleFile, vehicleID) });
+        writer.addArray(SnapshotVehicles, vehicles);
+        writer.addArray(SnapshotPlates, plates);
+        writer.addArray(SnapshotCustomers, customers);
+        writer.addArray(SnapshotCustomerVehicles, customerVehicles);
+        writer.add(SnapshotVehicleStrings, strings.bytes());
+    }
+
+    {
+        shared_lock<shared_mutex> registryLock(partRegistryMutex);
+        SnapshotStrings strings;
+        vector<SnapshotPart> parts;
+        vector<SnapshotModelIndex> modelParts;
+        vector<int32_t> modelPartIDs;
+        parts.reserve(partHash.size());
+
+        for (const auto& entry : partHash) {
+            parts.push_back({ entry.second.partID, entry.second.compatiblemodel.value(), strings.add(entry.first), strings.add(entry.second.name), entry.second.price, 0 });
+        }
+        for (size_t model = 0; model < modelPartIndex.size(); ++model) {
+            if (!modelPartIndex[model].empty()) {
+                modelParts.push_back({ static_cast<uint32_t>(model), static_cast<uint32_t>(modelPartIDs.size()), static_cast<uint32_t>(modelPartIndex[model].size()) });
+                modelPartIDs.insert(modelPartIDs.end(), modelPartIndex[model].begin(), modelPartIndex[model].end());
+            }
+        }
+        if (!strings.fits()) {
+            return false;
+        }
+
+        writer.addArray(SnapshotPartSource, vector<SnapshotSource>{ fileFingerprint(partFile, partID) });
+        writer.addArray(SnapshotParts, parts);
+        writer.addArray(SnapshotModelParts, modelParts);
+        writer.addArray(SnapshotModelPartIDs, modelPartIDs);
+        writer.add(SnapshotPartStrings, strings.bytes());
+    }
+
+    if (appointmentFile != nullptr) {
+        // The file is measured first: a booking committed meanwhile makes the image stale, never incomplete
+        SnapshotSource source = fileFingerprint(appointmentFile, 0);
+        SnapshotStrings strings;
+        vector<SnapshotAppointment> appointments;
+        {
+            shared_lock<shared_mutex> matrixLock(appointmentMatrixMutex);
+            for (size_t i = 0; i < appointmentMatrix.size(); ++i) {
+                for (size_t j = 0; j < appointmentMatrix[i].size(); ++j) {
+                    shared_lock<shared_mutex> rowLock(appointmentShard(static_cast<int>(i), static_cast<int>(j)));
+                    for (size_t k = 0; k < appointmentMatrix[i][j].size(); ++k) {
+                        int32_t day = dayNumber(Date{ static_cast<int>(i), static_cast<int>(j), static_cast<int>(k) });
+                        appointmentMatrix[i][j][k].forEachInOrder([&](const Appointment& appointment) {
+                            appointments.push_back({ day, appointment.vehicleID, appointment.priority, static_cast<int16_t>(appointment.bay),
+                                static_cast<int16_t>(appointment.firstSlot), strings.add(appointment.customerName), strings.add(appointment.appointmentType) });
+                        });
+                    }
+                }
+            }
+        }
+        if (!strings.fits()) {
+            return false;
+        }
+
+        vector<SnapshotBays> bays;
+        vector<uint64_t> bayWords;
+        {
+            lock_guard<mutex> scheduleLock(bayScheduleMutex);
+            bays.push_back({ bayScheduler.firstWordDay(), bayScheduler.bays(), bayScheduler.slotsPerDay(), 0 });
+            bayWords = bayScheduler.words();
+        }
+
+        writer.addArray(SnapshotAppointmentSource, vector<SnapshotSource>{ source });
+        writer.addArray(SnapshotAppointments, appointments);
+        writer.add(SnapshotAppointmentStrings, strings.bytes());
+        writer.addArray(SnapshotBaySchedule, bays);
+        writer.addArray(SnapshotBayWords, bayWords);
+    }
+
+    // Every model a stored record refers to was interned before the record was stored
+    {
+        ModelSymbolTable& table = modelSymbols();
+        shared_lock<shared_mutex> lock(table.mutex);
+        SnapshotStrings strings;
+        vector<SnapshotText> models;
+        for (const string& name : table.names) {
+            models.push_back(strings.add(name));
         }
+        writer.addArray(SnapshotModels, models);
+        writer.add(SnapshotModelStrings, strings.bytes());
+    }
+
+    return writer.write(snapshotPath, snapshotVersion);
+}
+
+/**
+ * @brief Restores the vehicles, the vehicle and plate indexes and the customer table from a snapshot image.
+ *
+ * The image is mapped and its records are read in place. The list with the
+ * vehicle index, the plate index and the customer table are rebuilt on three
+ * threads; nothing is parsed, normalized or looked up in the model table per
+ * record. The registry is left untouched when the image is missing, damaged or
+ * older than the vehicle file.
+ *
+ * @param snapshotPath The path of the image.
+ * @param fileName The vehicle file the image must match.
+ * @return true if the vehicles were restored.
+ */
+bool restoreVehicleSnapshot(const string& snapshotPath, const char* fileName) {
+    VEHICLE_TIMED("restoreVehicleSnapshot");
+
+    SnapshotImage image;
+    SnapshotSource source;
+    vector<ModelName> models;
+    const SnapshotVehicle* vehicles;
+    const SnapshotPlate* plates;
+    const SnapshotCustomer* customers;
+    const int32_t* customerVehicles;
+    size_t vehicleCount, plateCount, customerCount, customerVehicleCount;
+    string_view strings;
+    if (!image.open(snapshotPath, snapshotVersion) || !snapshotSourceIsCurrent(image, SnapshotVehicleSource, fileName, source)
+        || !restoreSnapshotModels(image, models) || !image.array(SnapshotVehicles, vehicles, vehicleCount)
+        || !image.array(SnapshotPlates, plates, plateCount) || !image.array(SnapshotCustomers, customers, customerCount)
+        || !image.array(SnapshotCustomerVehicles, customerVehicles, customerVehicleCount) || !image.section(SnapshotVehicleStrings, strings)) {
+        return false;
+    }
 
-        newVehicle->prev = current;
+    unique_ptr<RecordArena<Vehicle>> arena = make_unique<RecordArena<Vehicle>>(vehicleCount);
+    Vehicle* head = nullptr;
+    Vehicle* tail = nullptr;
+    unordered_map<int, Vehicle*> loadedIndex;
+    unordered_map<long long, Customer> loadedCustomers;
+    unordered_map<string, int> loadedPlates;
+    atomic<bool> valid(true);
+
+    runInParallel(3, [&](size_t task) {
+        string_view text;
+        if (task == 0) {
+            loadedIndex.reserve(vehicleCount);
+            Vehicle* current = nullptr;
+            for (size_t i = 0; i < vehicleCount; ++i) {
+                const SnapshotVehicle& stored = vehicles[i];
+                Vehicle* vehicle = createArenaVehicle(*arena);
+                vehicle->vehicleID = stored.vehicleID;
+                vehicle->customerID = stored.customerID;
+                if (stored.model >= models.size() || !snapshotText(strings, stored.customerName, text)) {
+                    valid = false;
+                    return;
+                }
+                vehicle->model = models[stored.model];
+                vehicle->customerName.assign(text);
+                if (!snapshotText(strings, stored.plateNumber, text)) {
+                    valid = false;
+                    return;
+                }
+                vehicle->plateNumber.assign(text);
 
-        if (current) {
-            current->next = newVehicle;
+                vehicle->prev = current;
+                if (current) {
+                    current->next = vehicle;
+                }
+                else {
+                    head = vehicle;
+                }
+                current = vehicle;
+                if (stored.indexed) {
+                    loadedIndex.emplace(vehicle->vehicleID, vehicle);
+                }
+            }
+            tail = current;
+        }
+        else if (task == 1) {
+            loadedPlates.reserve(plateCount);
+            for (size_t i = 0; i < plateCount; ++i) {
+                if (!snapshotText(strings, plates[i].key, text)) {
+                    valid = false;
+                    return;
+                }
+                loadedPlates.emplace(text, plates[i].vehicleID);
+            }
         }
         else {
-            // If current is nullptr, this is the first node
-            headVehicle = newVehicle;
+            loadedCustomers.reserve(customerCount);
+            for (size_t i = 0; i < customerCount; ++i) {
+                const SnapshotCustomer& stored = customers[i];
+                if (!snapshotText(strings, stored.name, text) || stored.firstVehicle > customerVehicleCount || stored.vehicleCount > customerVehicleCount - stored.firstVehicle) {
+                    valid = false;
+                    return;
+                }
+                Customer& customer = loadedCustomers[stored.customerID];
+                customer.customerID = stored.customerID;
+                customer.name.assign(text);
+                customer.vehicleIDs.assign(customerVehicles + stored.firstVehicle, customerVehicles + stored.firstVehicle + stored.vehicleCount);
+            }
         }
+    });
+    if (!valid) {
+        return false;
+    }
+    VEHICLE_COUNT("vehiclesLoaded", vehicleCount);
+
+    // Publish the restored list
+    unique_lock<shared_mutex> registryLock(vehicleRegistryMutex);
+    if (head) {
+        headVehicle = head;
+        tailVehicle = tail;
+        vehicleArena.swap(arena);
+        vehicleIndex.swap(loadedIndex);
+        customerTable.swap(loadedCustomers);
+        plateIndex.swap(loadedPlates);
+    }
+    vehicleID = static_cast<int>(source.nextID);
+    return true;
+}
 
-        current = newVehicle;
-        vehicleID = newVehicle->vehicleID + 1; // Update the vehicle ID from the loaded vehicle
+/**
+ * @brief Restores the parts and the model part index from a snapshot image.
+ *
+ * The registry is left untouched when the image is missing, damaged or older
+ * than the parts file.
+ *
+ * @param snapshotPath The path of the image.
+ * @param fileName The parts file the image must match.
+ * @return true if the parts were restored.
+ */
+bool restorePartSnapshot(const string& snapshotPath, const char* fileName) {
+    VEHICLE_TIMED("restorePartSnapshot");
+
+    SnapshotImage image;
+    SnapshotSource source;
+    vector<ModelName> models;
+    const SnapshotPart* parts;
+    const SnapshotModelIndex* modelParts;
+    const int32_t* modelPartIDs;
+    size_t partCount, modelPartsCount, modelPartIDCount;
+    string_view strings;
+    if (!image.open(snapshotPath, snapshotVersion) || !snapshotSourceIsCurrent(image, SnapshotPartSource, fileName, source)
+        || !restoreSnapshotModels(image, models) || !image.array(SnapshotParts, parts, partCount)
+        || !image.array(SnapshotModelParts, modelParts, modelPartsCount) || !image.array(SnapshotModelPartIDs, modelPartIDs, modelPartIDCount)
+        || !image.section(SnapshotPartStrings, strings)) {
+        return false;
     }
 
-    file.close();
+    pmr::unordered_map<string, Part> loadedParts(&partPool);
+    loadedParts.reserve(partCount);
+    for (size_t i = 0; i < partCount; ++i) {
+        const SnapshotPart& stored = parts[i];
+        string_view key;
+        string_view name;
+        if (stored.model >= models.size() || !snapshotText(strings, stored.key, key) || !snapshotText(strings, stored.name, name)) {
+            return false;
+        }
+        loadedParts.emplace(key, Part{ stored.partID, string(name), models[stored.model], stored.price });
+    }
+
+    vector<vector<int>> loadedIndex;
+    for (size_t i = 0; i < modelPartsCount; ++i) {
+        const SnapshotModelIndex& stored = modelParts[i];
+        if (stored.model >= models.size() || stored.firstPart > modelPartIDCount || stored.partCount > modelPartIDCount - stored.firstPart) {
+            return false;
+        }
+        uint32_t model = models[stored.model].value();
+        if (model >= loadedIndex.size()) {
+            loadedIndex.resize(model + 1);
+        }
+        loadedIndex[model].assign(modelPartIDs + stored.firstPart, modelPartIDs + stored.firstPart + stored.partCount);
+    }
+    VEHICLE_COUNT("partsLoaded", partCount);
+
+    // Publish the restored parts
+    unique_lock<shared_mutex> registryLock(partRegistryMutex);
+    partHash.swap(loadedParts);
+    modelPartIndex.swap(loadedIndex);
+    partID = static_cast<int>(source.nextID);
+    partRegistryVersion++;
+    return true;
 }
 
 /**
- * @brief Counts the number of vehicles in the linked list.
+ * @brief Restores the booked appointments, their vehicle index and the bay slots from a snapshot image.
  *
- * This function traverses the linked list and counts the number of vehicles.
+ * The appointments are stored day by day in the order they were queued, so every
+ * day keeps its order without reading the appointments file. The matrix must be
+ * initialized and empty. Nothing is restored when the image is missing, damaged,
+ * older than the appointments file or made for other bays.
  *
- * @return The number of vehicles in the linked list.
+ * @param snapshotPath The path of the image.
+ * @param fileName The appointments file the image must match.
+ * @return true if the appointments were restored.
  */
-int CountVehicles() {
-    int count = 0;
-    Vehicle* current = headVehicle;
-    while (current != nullptr) {
-        count++;
-        current = current->next;
+bool restoreAppointmentSnapshot(const string& snapshotPath, const char* fileName) {
+    VEHICLE_TIMED("restoreAppointmentSnapshot");
+
+    SnapshotImage image;
+    SnapshotSource source;
+    const SnapshotAppointment* appointments;
+    const SnapshotBays* bays;
+    const uint64_t* bayWords;
+    size_t appointmentCount, bayCount, bayWordCount;
+    string_view strings;
+    if (!image.open(snapshotPath, snapshotVersion) || !snapshotSourceIsCurrent(image, SnapshotAppointmentSource, fileName, source)
+        || !image.array(SnapshotAppointments, appointments, appointmentCount) || !image.section(SnapshotAppointmentStrings, strings)
+        || !image.array(SnapshotBaySchedule, bays, bayCount) || !image.array(SnapshotBayWords, bayWords, bayWordCount)) {
+        return false;
     }
-    return count;
-}
\ No newline at end of file
+    if (bayCount != 1 || bays->bays != serviceBays || bays->slotsPerDay != slotsPerWorkday) {
+        return false;
+    }
+
+    SlotScheduler loadedBays(serviceBays, slotsPerWorkday);
+    if (!loadedBays.assign(bays->firstDay, vector<uint64_t>(bayWords, bayWords + bayWordCount))) {
+        return false;
+    }
+
+    vector<PendingAppointment> bookings(appointmentCount);
+    for (size_t i = 0; i < appointmentCount; ++i) {
+        const SnapshotAppointment& stored = appointments[i];
+        PendingAppointment& booking = bookings[i];
+        string_view customerName;
+        string_view appointmentType;
+        if (!snapshotText(strings, stored.customerName, customerName) || !snapshotText(strings, stored.appointmentType, appointmentType)) {
+            return false;
+        }
+        civilFromDays(stored.day, booking.date.year, booking.date.month, booking.date.day);
+        booking.appointment = Appointment{ stored.vehicleID, string(customerName), string(appointmentType), stored.priority, stored.bay, stored.firstSlot };
+    }
+
+    // Publish the restored appointments and bay slots
+    vector<PendingAppointment> vehicleBookings;
+    size_t restored = storeLoadedAppointments(bookings, vehicleBookings);
+    for (const PendingAppointment& booking : vehicleBookings) {
+        indexVehicleAppointment(booking.date, booking.appointment);
+    }
+    {
+        lock_guard<mutex> scheduleLock(bayScheduleMutex);
+        bayScheduler = std::move(loadedBays);
+    }
+    VEHICLE_COUNT("appointmentsLoaded", restored);
+    return true;
+}
+
+/**
+ * @brief Checks whether a snapshot image matches the current vehicle, parts and appointments files.
+ *
+ * @param snapshotPath The path of the image.
+ * @param vehicleFile The vehicle file.
+ * @param partFile The parts file.
+ * @param appointmentFile The appointments file, nullptr when the appointments are not checked.
+ * @return true if every registry checked can be restored from the image.
+ */
+bool snapshotIsCurrent(const string& snapshotPath, const char* vehicleFile, const char* partFile, const char* appointmentFile = nullptr) {
+    SnapshotImage image;
+    SnapshotSource source;
+    return image.open(snapshotPath, snapshotVersion) && snapshotSourceIsCurrent(image, SnapshotVehicleSource, vehicleFile, source)
+        && snapshotSourceIsCurrent(image, SnapshotPartSource, partFile, source)
+        && (appointmentFile == nullptr || snapshotSourceIsCurrent(image, SnapshotAppointmentSource, appointmentFile, source));
+}
+
+/**
+ * @brief Loads the vehicles unless they are loaded already, from the snapshot while it is current.
+ */
+void ensureVehiclesLoaded() {
+    vehicleSubsystem.ensure([]() {
+        if (!restoreVehicleSnapshot(snapshotfileName, vehiclefileName)) {
+            loadVehiclesFromFile(vehiclefileName);
+        }
+    });
+}
+
+/**
+ * @brief Initializes the appointment matrix, fills it with the booked appointments,
+ *        takes their bay slots and starts the committer unless done already.
+ *
+ * The appointments and bay slots come from the snapshot while it is current and
+ * from the appointments file otherwise. Either is read only here. Afterwards the
+ * committer adds every new booking to the matrix and appends it to the file, so
+ * the two stay in step.
+ */
+void ensureAppointmentsLoaded() {
+    appointmentSubsystem.ensure([]() {
+        initializeAppointmentMatrix(2050, 12, 31);
+        if (!restoreAppointmentSnapshot(snapshotfileName, appointmentsfileName)) {
+            readAppointmentsFromFile(appointmentsfileName);
+            reserveBookedSlots(appointmentsfileName);
+        }
+        loadRecurringAppointments(recurringfileName);
+        startAppointmentCommitter(appointmentsfileName);
+    });
+}
+
+/**
+ * @brief Loads the parts unless they are loaded already, from the snapshot while it is current.
+ */
+void ensurePartsLoaded() {
+    partSubsystem.ensure([]() {
+        if (!restorePartSnapshot(snapshotfileName, partfileName)) {
+            loadPartsFromFile(partfileName);
+        }
+    });
+}
+
+/**
+ * @brief Starts the prefetch thread and queues every subsystem in the order the menus use them.
+ */
+void startSubsystemPrefetch() {
+    subsystemPrefetcher.start();
+    subsystemPrefetcher.hint(ensureVehiclesLoaded);
+    subsystemPrefetcher.hint(ensureAppointmentsLoaded);
+    subsystemPrefetcher.hint(ensurePartsLoaded);
+}
+
+/**
+ * @brief Stops the prefetch thread, then the appointment committer if it was started.
+ *
+ * When the vehicles and parts are both loaded and the snapshot no longer matches
+ * their files, a new snapshot is written for the next start. The appointments are
+ * included when they were loaded too; the committer has stopped by then, so the
+ * matrix holds exactly the appointments of the file.
+ */
+void stopSubsystems() {
+    subsystemPrefetcher.stop();
+    stopAppointmentCommitter();
+    const char* appointmentFile = appointmentSubsystem.isLoaded() ? appointmentsfileName : nullptr;
+    if (vehicleSubsystem.isLoaded() && partSubsystem.isLoaded() && !snapshotIsCurrent(snapshotfileName, vehiclefileName, partfileName, appointmentFile)) {
+        saveStateSnapshot(snapshotfileName, vehiclefileName, partfileName, appointmentFile);
+    }
+}
+
+/**
+ * @brief Describes how long startup and each subsystem load took.
+ *
+ * @param firstMenuMilliseconds Time from program start until the first menu was drawn.
+ * @return string One line for the first menu and one per subsystem.
+ */
+string startupTimingReport(double firstMenuMilliseconds) {
+    ostringstream report;
+    report << fixed << setprecision(2);
+    report << "first menu: " << firstMenuMilliseconds << " ms\n";
+    for (const LazySubsystem* subsystem : { &vehicleSubsystem, &appointmentSubsystem, &partSubsystem }) {
+        report << subsystem->name() << ": ";
+        if (subsystem->isLoaded()) {
+            report << "loaded in " << subsystem->loadMilliseconds() << " ms " << (subsystem->loadedInBackground() ? "in the background" : "in the foreground");
+        }
+        else {
+            report << "not loaded";
+        }
+        report << ", menus waited " << subsystem->waitMilliseconds() << " ms\n";
+    }
+    return report.str();
+}
@@ -28,4 +28,14 @@ int windowWidth = 21;
  * @brief Height of the terminal window used in the application.
  *        Adjusting this value can affect the layout of the application.
  */
-int windowHeight = 9;
\ No newline at end of file
+int windowHeight = 9;
+
+/**
+ * @brief Set by the --startup-timing argument; the startup timing report is then printed on exit.
+ */
+bool printStartupTiming = false;
+
+/**
+ * @brief Time from program start until the main menu was called, in milliseconds.
+ */
+double firstMenuMilliseconds = 0;
\ No newline at end of file
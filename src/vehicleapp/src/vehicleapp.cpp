@@ -150,42 +150,26 @@ void Registration() {
     showText("Registration", options);
 
     // Create a new vehicle
-    Vehicle* newVehicle = new Vehicle;
-
-    // Assign a unique vehicle ID
-    newVehicle->vehicleID = vehicleID++;
+    Vehicle newVehicle{};
 
     // Collect customer information
     gotoxy(45, 9);
-    cin >> newVehicle->customerID;
+    cin >> newVehicle.customerID;
     gotoxy(45, 12);
-    cin >> newVehicle->customerName;
+    cin >> newVehicle.customerName;
 
     // Collect vehicle information
     gotoxy(45, 15);
-    cin >> newVehicle->model;
+    cin >> newVehicle.model;
     gotoxy(45, 18);
-    cin >> newVehicle->plateNumber;
-
-    // Set pointers for linked list
-    newVehicle->next = nullptr;
-    newVehicle->prev = nullptr;
+    cin >> newVehicle.plateNumber;
 
-    // Add the new vehicle to the linked list
-    if (!headVehicle) {
-        headVehicle = newVehicle;
-    }
-    else {
-        Vehicle* current = headVehicle;
-        while (current->next != nullptr) {
-            current = current->next;
-        }
-        current->next = newVehicle;
-        newVehicle->prev = current;
-    }
+    // Assign a unique vehicle ID and add a copy of the new vehicle to the linked list
+    ensureVehiclesLoaded();
+    newVehicle.vehicleID = registerVehicle(newVehicle);
 
     // Write the new vehicle information to a file
-    writeVehicleToFile(newVehicle, vehiclefileName);
+    writeVehicleToFile(&newVehicle, vehiclefileName);
 }
 
 /**
@@ -198,6 +182,7 @@ void Registration() {
  * to return to the main menu.
  */
 void ListVehicles() {
+    ensureVehiclesLoaded();
     int page = 1;
     int pageSize = 14;
     int totalVehicles = CountVehicles();
@@ -213,18 +198,10 @@ void ListVehicles() {
         cout << "Vehicle ID | Customer ID | Customer Name | Vehicle Model | Plate Number\n";
 
         int startVehicle = (page - 1) * pageSize;
-        int endVehicle = min(startVehicle + pageSize, totalVehicles);
 
-        Vehicle* current = headVehicle;
-        for (int i = 0; i < endVehicle; i++) {
-            if (current == nullptr) {
-                break;
-            }
-            if (i >= startVehicle) {
-                // Display vehicle details in a formatted manner
-                cout << " | " << setw(12) << current->vehicleID << " | " << setw(11) << current->customerID << " | " << setw(13) << current->customerName << " | " << setw(13) << current->model << " | " << current->plateNumber << endl;
-            }
-            current = current->next;
+        for (const Vehicle& vehicle : listVehiclesPage(startVehicle, pageSize)) {
+            // Display vehicle details in a formatted manner
+            cout << " | " << setw(12) << vehicle.vehicleID << " | " << setw(11) << vehicle.customerID << " | " << setw(13) << vehicle.customerName << " | " << setw(13) << vehicle.model << " | " << vehicle.plateNumber << endl;
         }
 
         // Display page information
@@ -258,114 +235,191 @@ void ListVehicles() {
 /**
  * @brief Updates information for a specific vehicle.
  *
- * This function prompts the user to enter the Vehicle ID of the
- * vehicle they want to update. If the vehicle is found, it then
+ * This function prompts the user to enter the Vehicle ID or plate number
+ * of the vehicle they want to update. If the vehicle is found, it then
  * prompts the user for new information such as Customer ID,
  * Customer Name, Vehicle Model, and Plate Number. The information
  * is updated in-memory, and the corresponding file is also updated.
  */
 void UpdateVehicle() {
-    int vehicleID;
-
-    // Prompt the user to enter the Vehicle ID
-    showText("Update Vehicle", { "Enter Vehicle ID: " });
-    gotoxy(45, 9);
-    cin >> vehicleID;
-
-    // Search for the vehicle with the specified ID
-    Vehicle* current = headVehicle;
-    while (current != nullptr) {
-        if (current->vehicleID == vehicleID) {
-            // Prompt the user for updated information
-            showText("Update Vehicle", { "New Customer ID  : ","New Customer Name : ","New Vehicle Model : ", "New Plate Number : " });
-            gotoxy(65, 9);
-            cin >> current->customerID;
-            gotoxy(65, 12);
-            cin >> current->customerName;
-            gotoxy(65, 15);
-            cin >> current->model;
-            gotoxy(65, 18);
-            cin >> current->plateNumber;
-
-            // Update the vehicle information in the file
-            updateVehicleFile(tempvehiclefileName, vehiclefileName);
-
-            // Display a confirmation message
-            showText("Update Vehicle", { "Vehicle has been updated." , "Press any key to return..." });
-            getch();
-            return;
-        }
-        current = current->next;
+    string input;
+
+    // Prompt the user to enter the Vehicle ID or plate number
+    showText("Update Vehicle", { "Enter Vehicle ID or Plate: " });
+    gotoxy(52, 9);
+    cin >> input;
+    ensureVehiclesLoaded();
+
+    // Search for the vehicle with the specified ID or plate number
+    Vehicle current;
+    if (findVehicleByIdOrPlate(input, current)) {
+        int vehicleID = current.vehicleID;
+
+        // Prompt the user for updated information
+        showText("Update Vehicle", { "New Customer ID  : ","New Customer Name : ","New Vehicle Model : ", "New Plate Number : " });
+        gotoxy(65, 9);
+        cin >> current.customerID;
+        gotoxy(65, 12);
+        cin >> current.customerName;
+        gotoxy(65, 15);
+        cin >> current.model;
+        gotoxy(65, 18);
+        cin >> current.plateNumber;
+
+        // Update the vehicle information in memory and in the file
+        updateVehicle(vehicleID, current);
+        updateVehicleFile(tempvehiclefileName, vehiclefileName);
+
+        // Display a confirmation message
+        showText("Update Vehicle", { "Vehicle has been updated." , "Press any key to return..." });
+        getch();
+        return;
     }
 
-    // If the vehicle with the given ID was not found
-    showText("Update Vehicle", { "Vehicle with ID " + to_string(vehicleID) + " not found!" , "Press any key to return..." });
+    // If the vehicle with the given ID or plate number was not found
+    showText("Update Vehicle", { "Vehicle " + input + " not found!" , "Press any key to return..." });
     getch();
 }
 
 
 
 /**
- * @brief Deletes a vehicle with the specified Vehicle ID.
+ * @brief Deletes a vehicle with the specified Vehicle ID or plate number.
  *
- * This function prompts the user to enter the Vehicle ID of the
- * vehicle they want to delete. If the vehicle is found, it removes
+ * This function prompts the user to enter the Vehicle ID or plate number
+ * of the vehicle they want to delete. If the vehicle is found, it removes
  * the vehicle from the linked list. The corresponding file is also
  * updated, and a confirmation message is displayed.
  */
 void DeleteVehicle() {
-    int vehicleID;
-
-    // Prompt the user to enter the Vehicle ID
-    showText("Delete Vehicle", { "Enter Vehicle ID to delete: " });
-    gotoxy(53, 9);
-    cin >> vehicleID;
-
-    // Search for the vehicle with the specified ID
-    Vehicle* current = headVehicle;
-    while (current != nullptr) {
-        if (current->vehicleID == vehicleID) {
-            // Remove the vehicle from the linked list
-            if (current->prev && current->next) {
-                current->prev->next = current->next;
-                current->next->prev = current->prev;
-            }
-            else if (current->prev) {
-                current->prev->next = nullptr;
-            }
-            else {
-                headVehicle = current->next;
-            }
+    string input;
+
+    // Prompt the user to enter the Vehicle ID or plate number
+    showText("Delete Vehicle", { "Enter Vehicle ID or Plate to delete: " });
+    gotoxy(62, 9);
+    cin >> input;
+    ensureVehiclesLoaded();
+
+    // Remove the vehicle with the specified ID or plate number from the linked list
+    Vehicle found;
+    int vehicleID = findVehicleByIdOrPlate(input, found) ? found.vehicleID : -1;
+    if (vehicleID >= 0 && removeVehicle(vehicleID)) {
+        // Update the vehicle information in the file
+        updateVehicleFile(tempvehiclefileName, vehiclefileName);
+
+        // Display a confirmation message
+        showText("Delete Vehicle", { "Vehicle with ID " + to_string(vehicleID) + " has been deleted." });
+        getch();
+        return;
+    }
 
-            // Update the vehicle information in the file
-            updateVehicleFile(tempvehiclefileName, vehiclefileName);
+    // If the vehicle with the given ID or plate number was not found
+    showText("Delete Vehicle", { "Vehicle " + input + " not found!" , "Press any key to return..." });
+    getch();
+}
 
-            // Display a confirmation message
-            showText("Delete Vehicle", { "Vehicle with ID " + to_string(vehicleID) + " has been deleted." });
-            //delete current; // Free the memory associated with the deleted vehicle
-            getch();
-            return;
-        }
-        current = current->next;
+
+
+/**
+ * @brief Displays the fleet of a customer and its booked appointments.
+ *
+ * This function prompts the user to enter a customer ID, then lists the
+ * customer's vehicles followed by the appointments booked for them.
+ * It waits for user input before returning.
+ */
+void CustomerFleet() {
+    long long customerID;
+
+    // Prompt the user to enter the Customer ID
+    showText("Customer Fleet", { "Enter Customer ID: " });
+    gotoxy(45, 9);
+    cin >> customerID;
+    ensureVehiclesLoaded();
+    ensureAppointmentsLoaded();
+
+    Customer customer;
+    if (!findCustomer(customerID, customer)) {
+        showText("Customer Fleet", { "Customer with ID " + to_string(customerID) + " not found!" , "Press any key to return..." });
+        getch();
+        return;
+    }
+
+    system(CLEAR_SCREEN);
+    showText("Customer Fleet", { customer.name + " owns " + to_string(customer.vehicleIDs.size()) + " vehicles" });
+    gotoxy(5, 10);
+    cout << "Vehicle ID | Vehicle Model | Plate Number\n";
+    for (const Vehicle& vehicle : findVehiclesByCustomer(customerID)) {
+        cout << " | " << setw(12) << vehicle.vehicleID << " | " << setw(13) << vehicle.model << " | " << vehicle.plateNumber << endl;
+    }
+
+    cout << "\n | Appointments\n";
+    for (const auto& booked : findAppointmentsByCustomer(customerID)) {
+        const Date& date = booked.first;
+        cout << " | " << setw(12) << booked.second.vehicleID << " | " << date.day << "/" << date.month << "/" << date.year << " | " << booked.second.appointmentType << endl;
     }
 
-    // If the vehicle with the given ID was not found
-    showText("Delete Vehicle", { "Vehicle with ID " + to_string(vehicleID) + " not found!" , "Press any key to return..." });
     getch();
 }
 
+/**
+ * @brief Searches customers, plates, models and parts while the user types.
+ *
+ * The search index is built once when the screen opens. Every keystroke reruns
+ * the search and redraws the hits together with the time the search took.
+ * Backspace deletes a character; Enter or Esc returns.
+ */
+void QuickSearch() {
+    const vector<string> kindNames = { "Customer", "Plate", "Model", "Part" };
+    const size_t maxHits = 12;
+
+    showText("Quick Search", { "Building the search index..." });
+    ensureVehiclesLoaded();
+    ensurePartsLoaded();
+    SearchIndex index = buildSearchIndex();
 
+    string query;
+    while (true) {
+        auto start = chrono::steady_clock::now();
+        vector<SearchHit> hits = index.search(query, maxHits);
+        auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+
+        showText("Quick Search", { "Search: " + query });
+        gotoxy(5, 11);
+        cout << to_string(hits.size()) << " hits in " << elapsed.count() << " us (Enter or Esc to return)\n";
+        for (const SearchHit& hit : hits) {
+            cout << " | " << setw(8) << kindNames[static_cast<int>(hit.kind)] << " | " << setw(10) << hit.id << " | " << hit.text;
+            if (hit.distance > 0) {
+                cout << "  (~" << hit.distance << ")";
+            }
+            cout << endl;
+        }
+        gotoxy(19 + static_cast<int>(query.size()), 9);
+
+        char input = getch();
+        if (input == 13 || input == '\n' || input == 27) {
+            return;
+        }
+        else if (input == 8 || input == 127) {
+            if (!query.empty()) {
+                query.pop_back();
+            }
+        }
+        else if (isprint(static_cast<unsigned char>(input))) {
+            query.push_back(input);
+        }
+    }
+}
 
 /**
  * @brief Displays the service history.
  *
- * This function shows the service history by displaying the content
- * of the file specified by `historyfileName`. It uses the `DisplayFileContent`
- * function to retrieve and display the file content.
+ * This function shows the service history by rendering the records
+ * of the file specified by `historyfileName`. It uses the `renderServiceFile`
+ * function to turn the stored records into text.
  */
 void Service_History() {
     showText("Service History", {});
-    cout << DisplayFileContent(historyfileName);
+    cout << renderServiceFile(historyfileName);
     getch();
 };
 
@@ -373,10 +427,12 @@ void Service_History() {
  * @brief Creates a new appointment.
  *
  * This function prompts the user to enter details for a new appointment,
- * including vehicle ID, customer name, appointment type, and date. It then
- * creates a report, warranty, and maintenance file entries using the provided
- * information. The appointment is added to the appointment matrix, and the
- * appointments are written to the file.
+ * including vehicle ID, customer name, appointment type, and date. The first
+ * free bay on or after that date is booked for the duration of the type, unless the
+ * vehicle has another appointment within appointmentConflictDays of that day. The
+ * appointment is submitted to the intake queue, whose committer adds it to the
+ * appointment matrix and appends it to the file. It then creates a report,
+ * warranty, and maintenance file entries for the booked date.
  */
 void Create_Appointment() {
     showText("Create Appointment", { "Enter the vehicle ID: " , "Enter the customer name: " ,"Enter the appointment type" , "Enter the date: " });
@@ -400,6 +456,35 @@ void Create_Appointment() {
     cin >> newDate.month;
     gotoxy(60, 18);
     cin >> newDate.year;
+    newAppointment.priority = appointmentPriority(newAppointment.appointmentType);
+
+    // Book the first free bay, which may move the appointment to a later day
+    ensureAppointmentsLoaded();
+    if (!isBookableDate(newDate)) {
+        showText("Create Appointment", { "That date cannot be booked.", "Press any key to return..." });
+        getch();
+        return;
+    }
+    SlotBooking booking;
+    VehicleAppointment conflict;
+    BookingOutcome outcome = bookAppointment(newDate, newAppointment, booking, conflict);
+    if (outcome == BookingNoFreeBay) {
+        showText("Create Appointment", { "No bay is free within a year of that date.", "Press any key to return..." });
+        getch();
+        return;
+    }
+    if (outcome == BookingOutsideCalendar) {
+        showText("Create Appointment", { "No bay is free before the end of the calendar.", "Press any key to return..." });
+        getch();
+        return;
+    }
+    if (outcome == BookingVehicleConflict) {
+        Date conflictDate = civilDate(conflict.day);
+        showText("Create Appointment", { "Vehicle " + to_string(newAppointment.vehicleID) + " already has a " + conflict.appointmentType + " appointment on "
+            + to_string(conflictDate.day) + "/" + to_string(conflictDate.month) + "/" + to_string(conflictDate.year) + ".", "Press any key to return..." });
+        getch();
+        return;
+    }
 
     // Create report, warranty, and maintenance file entries
     CreateReport(historyfileName, newAppointment, newDate);
@@ -407,78 +492,189 @@ void Create_Appointment() {
     if (newAppointment.appointmentType == "Maintenance")
         CreateMaintenance(maintenancefileName, newAppointment, newDate);
 
-    // Add appointment to the appointment matrix and write to file
-    addAppointment(newDate, newAppointment);
-    writeAppointmentsToFile(appointmentsfileName);
+    showText("Create Appointment", { "Booked bay " + to_string(booking.bay + 1) + " at " + slotTime(booking.firstSlot) + " on "
+        + to_string(newDate.day) + "/" + to_string(newDate.month) + "/" + to_string(newDate.year) + ".", "Press any key to return..." });
+    getch();
 };
 
 /**
  * @brief Lists appointments and displays dates and customer names.
  *
- * This function reads appointments from a file, then displays a list of
- * appointments along with their corresponding dates and customer names.
+ * This function displays a list of the booked appointments along with their
+ * corresponding dates and customer names. The appointments file is read once,
+ * when the appointments are first loaded.
  */
 void List_Appointments() {
-    // Read appointments from file
-    readAppointmentsFromFile(appointmentsfileName);
+    // Load the appointments unless done already
+    ensureAppointmentsLoaded();
 
     // Display a list of appointments along with dates and customer names
     showText("List Appointments", { "   Date   | Customer Name " });
 
-    for (int i = 0; i < appointmentMatrix.size(); ++i) {
-        for (int j = 0; j < appointmentMatrix[i].size(); ++j) {
-            for (int k = 0; k < appointmentMatrix[i][j].size(); ++k) {
-                auto& appointments = appointmentMatrix[i][j][k];
-                Date date{ i, j, k };
-                if (!appointments.empty()) {
-                    cout << " | " << setw(19) << date.day << "/" << date.month << "/" << date.year << " | " << appointments.front().customerName << "\n";
-                }
-            }
-        }
+    for (const auto& head : collectAppointmentHeads()) {
+        const Date& date = head.first;
+        cout << " | " << setw(19) << date.day << "/" << date.month << "/" << date.year << " | " << head.second.customerName << "\n";
+    }
+
+    getch();
+}
+
+
+/**
+ * @brief Creates a recurring appointment contract for a vehicle.
+ *
+ * This function prompts the user for the vehicle ID, customer name, appointment
+ * type, first date, interval and number of visits, or a last date when the number
+ * is 0. The contract is saved to the recurring contracts file; its visits are
+ * computed when a month is viewed and take no bay slots.
+ */
+void Recurring_Contract() {
+    showText("Recurring Contract", { "Enter the vehicle ID: ", "Enter the customer name: ", "Enter the appointment type: ", "Enter the first date: ",
+        "Repeat every (e.g. 6 months): ", "Number of visits (0 for a last date): ", "Enter the last date: " });
+
+    // Input variables
+    RecurringAppointment rule;
+    Date start{ 0, 0, 0 };
+    Date until{ 0, 0, 0 };
+    string unit;
+
+    // User input for the contract details
+    gotoxy(50, 9);
+    cin >> rule.appointment.vehicleID;
+    gotoxy(50, 12);
+    cin >> rule.appointment.customerName;
+    gotoxy(50, 15);
+    cin >> rule.appointment.appointmentType;
+    gotoxy(50, 18);
+    cout << ".. / .. / ....";
+    gotoxy(50, 18);
+    cin >> start.day;
+    gotoxy(55, 18);
+    cin >> start.month;
+    gotoxy(60, 18);
+    cin >> start.year;
+    gotoxy(50, 21);
+    cin >> rule.recurrence.interval >> unit;
+    gotoxy(50, 24);
+    cin >> rule.recurrence.count;
+    if (rule.recurrence.count == 0) {
+        gotoxy(50, 27);
+        cout << ".. / .. / ....";
+        gotoxy(50, 27);
+        cin >> until.day;
+        gotoxy(55, 27);
+        cin >> until.month;
+        gotoxy(60, 27);
+        cin >> until.year;
+    }
+
+    if (!isValidCivil(start.year, start.month, start.day) || (rule.recurrence.count == 0 && !isValidCivil(until.year, until.month, until.day))
+        || rule.recurrence.interval < 1) {
+        showText("Recurring Contract", { "The dates or the interval are not valid.", "Press any key to return..." });
+        getch();
+        return;
+    }
+
+    rule.appointment.priority = appointmentPriority(rule.appointment.appointmentType);
+    rule.recurrence.start = calendarDay(start);
+    rule.recurrence.unit = unit.rfind("day", 0) == 0 ? RecurDays : RecurMonths;
+    if (rule.recurrence.count == 0) {
+        rule.recurrence.until = calendarDay(until);
+    }
+
+    ensureAppointmentsLoaded();
+    saveRecurringAppointment(recurringfileName, rule);
+
+    showText("Recurring Contract", { "Contract saved for vehicle " + to_string(rule.appointment.vehicleID) + ".", "Press any key to return..." });
+    getch();
+}
+
+/**
+ * @brief Lists the visits of the recurring contracts in a month.
+ *
+ * This function prompts the user for a month and year and displays the date,
+ * vehicle ID, customer name and type of every contract visit in that month.
+ */
+void Contract_Visits() {
+    int month;
+    int year;
+    showText("Contract Visits", { "Enter the month and year: " });
+    gotoxy(50, 9);
+    cin >> month >> year;
+    if (daysInMonth(year, month) == 0) {
+        return;
+    }
+
+    ensureAppointmentsLoaded();
+    vector<pair<Date, Appointment>> visits = recurringAppointmentsBetween(Date{ year, month, 1 }, Date{ year, month, daysInMonth(year, month) });
+
+    showText("Contract Visits", { to_string(visits.size()) + " visits", "   Date   | Vehicle | Customer Name | Type " });
+    for (const auto& visit : visits) {
+        const Date& date = visit.first;
+        cout << " | " << date.day << "/" << date.month << "/" << date.year << " | " << setw(7) << visit.second.vehicleID << " | "
+            << visit.second.customerName << " | " << visit.second.appointmentType << "\n";
     }
 
     getch();
 }
 
+/**
+ * @brief Lists the vehicles booked more than once within appointmentConflictDays.
+ *
+ * This function checks every vehicle's appointments and displays each pair that
+ * lies too close together, with the dates and types of both appointments.
+ */
+void Appointment_Conflicts() {
+    ensureAppointmentsLoaded();
+    vector<AppointmentConflict> conflicts = findAllConflicts();
+
+    showText("Appointment Conflicts", { to_string(conflicts.size()) + " conflicting pairs", " Vehicle | First | Second " });
+    for (const AppointmentConflict& conflict : conflicts) {
+        Date first = civilDate(conflict.first.day);
+        Date second = civilDate(conflict.second.day);
+        cout << " | " << setw(7) << conflict.vehicleID << " | " << first.day << "/" << first.month << "/" << first.year << " " << conflict.first.appointmentType
+            << " | " << second.day << "/" << second.month << "/" << second.year << " " << conflict.second.appointmentType << "\n";
+    }
+
+    getch();
+}
 
 /**
  * @brief Allows the user to select parts for labor cost estimation.
  *
  * This function displays a list of parts compatible with a given vehicle model.
- * The user can add parts to the invoice, calculate the total price, or quit the selection process.
+ * The user can add parts to the invoice or remove them, save the invoice as a quote
+ * or load the saved one, load one of the model's standard jobs, calculate the total
+ * price, or quit the selection process. The totals are kept up to date as parts are
+ * added and removed. A calculated job is priced through priceJob, which answers a
+ * job priced before from the quote cache; every job priced at the current part
+ * prices is offered as a standard job.
  */
 
 void partSelection(const string& searchModel) {
     // Vector to store parts compatible with the specified vehicle model
-    vector<Part> displayedParts;
-    auto it = partHash.begin();
+    ensurePartsLoaded();
+    vector<Part> displayedParts = findPartsByModel(searchModel);
 
-    // Iterate through partHash to find compatible parts
-    while (it != partHash.end()) {
-        if (it->second.compatiblemodel == searchModel) {
-            displayedParts.push_back(it->second);
-        }
-        ++it;
-    }
-
-    // Vector to store selected parts
-    vector<Part> selectedParts;
-    // Vector to store the names and prices of selected parts for display
-    vector<string> selectedList;
-    int currentIndex = 0;
+    // Quote of the selected parts; it holds current registry prices until a saved quote is loaded
+    Quote quote;
+    quote.model = searchModel;
+    bool registryPrices = true;
+    size_t currentIndex = 0;
+    size_t nextStandardJob = 0;
 
     // Loop for part selection
     while (true) {
         // Display the header and options for part selection
         showText("Labor Cost Estimation", {});
         gotoxy(7, 9);
-        cout << "Press A to add to invoice, enter to calculate total price, and Q to quit.";
+        cout << "Press A to add to invoice, R to remove, S to save, L to load the saved quote, J for the next standard job, enter to calculate total price, and Q to quit.";
         gotoxy(12, 11);
         cout << "Part name | Price ";
         gotoxy(0, 12);
 
         // Display the list of parts with a cursor indicating the current selection
-        for (int i = 0; i < displayedParts.size(); ++i) {
+        for (size_t i = 0; i < displayedParts.size(); ++i) {
             if (i == currentIndex) {
                 cout << " | ->";
             }
@@ -492,23 +688,49 @@ void partSelection(const string& searchModel) {
         gotoxy(36, 11);
         cout << "Selected parts \n";
 
-        for (int i = 0; i < selectedList.size(); ++i) {
-            gotoxy(36, 12 + i);
-            cout << selectedList[i];
+        for (size_t i = 0; i < quote.lines.size(); ++i) {
+            gotoxy(36, 12 + static_cast<int>(i));
+            cout << quote.lines[i].name << "  " << to_string(quote.lines[i].price) << " x" << quote.lines[i].quantity;
         }
 
         // Get user input
         char input = getch();
 
         // Process user input
-        if (input == 'A' || input == 'a') {
+        if ((input == 'A' || input == 'a') && !displayedParts.empty()) {
             // Add the selected part to the invoice
-            selectedParts.push_back(displayedParts[currentIndex]);
-            selectedList.push_back(displayedParts[currentIndex].name + "  " + to_string(displayedParts[currentIndex].price));
+            addQuotePart(quote, displayedParts[currentIndex]);
+        }
+        else if ((input == 'R' || input == 'r') && !displayedParts.empty()) {
+            // Remove one of the selected part from the invoice
+            removeQuotePart(quote, displayedParts[currentIndex].partID);
+        }
+        else if (input == 'S' || input == 's') {
+            // Save the invoice as the quote file
+            saveQuote(quotefileName, quote);
+        }
+        else if (input == 'L' || input == 'l') {
+            // Load the saved quote, at the prices it was quoted at, when it is for this model
+            Quote saved;
+            if (loadQuote(quotefileName, saved) && saved.model == searchModel) {
+                quote = saved;
+                registryPrices = false;
+            }
+        }
+        else if (input == 'J' || input == 'j') {
+            // Load the next job priced for this model at the current part prices, from the quote cache
+            vector<Quote> jobs = standardJobs(searchModel);
+            if (!jobs.empty()) {
+                quote = jobs[nextStandardJob++ % jobs.size()];
+                registryPrices = true;
+            }
         }
         else if (input == 13 || input == 'O' || input == 'o') {
-            // Calculate and display the total price
-            PriceResult result = calculateTotalPrice(selectedParts);
+            // Price the job at the current part prices, from the quote cache when it was priced before
+            if (registryPrices) {
+                quote = priceJob(searchModel, quotePartIDs(quote));
+            }
+            PriceResult result = quoteTotals(quote);
 
             float totalPrice = result.totalAmount;
             float partPrice = result.amountWithoutLabor;
@@ -529,7 +751,7 @@ void partSelection(const string& searchModel) {
         }
         else if (input == 80) {
             // Move the cursor down
-            if (currentIndex < displayedParts.size() - 1) {
+            if (currentIndex + 1 < displayedParts.size()) {
                 ++currentIndex;
             }
         }
@@ -591,15 +813,15 @@ void Service_Feedback() {
 /**
  * @brief Displays warranty expiration alerts to the user.
  *
- * This function shows a screen with information about warranty expirations by reading the content
- * from a file and printing it on the screen.
+ * This function shows a screen with information about warranty expirations by rendering the
+ * records of the warranty file and printing them on the screen.
  */
 void Warranty_Expiration_Alerts() {
     // Display screen for warranty expirations
     showText("Warranty Expirations", {});
 
     // Print content of the warranty file on the screen
-    cout << DisplayFileContent(warrantyfileName);
+    cout << renderServiceFile(warrantyfileName);
 
     // Wait for user input before returning
     getch();
@@ -608,12 +830,12 @@ void Warranty_Expiration_Alerts() {
 /**
  * @brief Displays preventive maintenance reminders.
  *
- * This function shows the next maintenance dates and displays the content
+ * This function shows the next maintenance dates by rendering the records
  * of the maintenance file. It waits for user input before returning.
  */
 void Preventive_Maintenance_Reminders() {
     showText("Next Maintenance Dates", {}); // Display a heading for maintenance dates
-    cout << DisplayFileContent(maintenancefileName); // Display content from the maintenance file
+    cout << renderServiceFile(maintenancefileName); // Display the records of the maintenance file
     getch(); // Wait for user input
 };
 
@@ -645,13 +867,116 @@ void Customer_feedback() {
     CreateFeedback(feedbackfileName, feedback); // Store the feedback in a file
 };
 
+/**
+ * @brief Searches the feedback and service history by words.
+ *
+ * This function prompts the user for one or more words and lists the newest
+ * feedback entries and service reports containing all of them, along with the
+ * time the indexed search took. It waits for user input before returning.
+ */
+void Search_records() {
+    const size_t maxRecords = 5;
+    string query;
+
+    showText("Search Feedback and History", { "Enter words to search for: " });
+    gotoxy(55, 9);
+    getline(cin >> ws, query);
+
+    auto start = chrono::steady_clock::now();
+    vector<string> feedback = searchTextRecords(feedbackfileName, query, maxRecords);
+    vector<ServiceRecord> history = searchServiceRecords(historyfileName, query, maxRecords);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    showText("Search Feedback and History", { "Results for: " + query });
+    gotoxy(5, 11);
+    cout << "Searched in " << elapsed.count() << " ms\n\n | Feedback\n";
+    for (const string& record : feedback) {
+        cout << record;
+    }
+    cout << "\n | Service History\n";
+    for (const ServiceRecord& record : history) {
+        renderServiceRecord(cout, record);
+        cout << "\n";
+    }
+
+    getch();
+}
+
 
 /**
  * @brief Displays monthly service statistics.
  *
- * This function outputs a message indicating monthly service statistics.
+ * This function prompts the user for a year and shows the appointments, service
+ * reports and revenue of every month, followed by the revenue per model and the
+ * most common service types. The figures are read from the columnar archive,
+ * which is exported again first when the appointments or history changed.
+ * It waits for user input before returning.
  */
-void Monthly_service_stats() { cout << "Monthly Service Stats" << endl; };
+void Monthly_service_stats() {
+    int year;
+    showText("Monthly Service Stats", { "Enter the year: " });
+    gotoxy(45, 9);
+    cin >> year;
+    ensureVehiclesLoaded();
+
+    if (!archiveIsCurrent(archivefileName, { appointmentsfileName, historyfileName })) {
+        exportServiceArchive(archivefileName, appointmentsfileName, historyfileName);
+    }
+
+    showText("Monthly Service Stats", { "Year " + to_string(year) });
+    gotoxy(5, 11);
+    cout << "Month | Appointments | Services | Revenue\n";
+    for (const MonthlyServiceStats& month : monthlyServiceStats(archivefileName, year)) {
+        cout << " | " << setw(5) << month.month << " | " << setw(12) << month.appointments << " | " << setw(8) << month.services
+            << " | " << fixed << setprecision(2) << month.revenue << defaultfloat << endl;
+    }
+
+    cout << "\n | Revenue per model\n";
+    vector<pair<string, double>> revenue = revenueByModel(archivefileName, year);
+    for (size_t i = 0; i < revenue.size() && i < 5; ++i) {
+        cout << " | " << setw(16) << (revenue[i].first.empty() ? "(unregistered)" : revenue[i].first) << " | "
+            << fixed << setprecision(2) << revenue[i].second << defaultfloat << endl;
+    }
+
+    cout << "\n | Most common services\n";
+    vector<pair<string, size_t>> types = serviceTypeCounts(archivefileName, year);
+    for (size_t i = 0; i < types.size() && i < 5; ++i) {
+        cout << " | " << setw(16) << types[i].first << " | " << types[i].second << endl;
+    }
+
+    getch();
+}
+
+/**
+ * @brief Displays and exports the performance metrics.
+ *
+ * This function writes the current timers and counters to the Prometheus and JSON
+ * metrics files and lists the call count and mean duration of every timed function.
+ * It waits for user input before returning.
+ */
+void Performance_metrics() {
+    showText("Performance Metrics", {});
+
+    bool exported = dumpMetrics(metricsPrometheusfileName, MetricsFormat::Prometheus);
+    exported = dumpMetrics(metricsJsonfileName, MetricsFormat::Json) && exported;
+
+    for (const MetricSnapshot& snapshot : collectMetrics()) {
+        if (snapshot.kind == MetricKind::Timer) {
+            double meanMicroseconds = snapshot.count ? snapshot.sum / 1000.0 / snapshot.count : 0;
+            cout << left << setw(26) << snapshot.name << right << setw(8) << snapshot.count << " calls "
+                << fixed << setprecision(1) << setw(10) << meanMicroseconds << " us\n";
+        }
+        else {
+            cout << left << setw(26) << snapshot.name << right << setw(8) << snapshot.sum << "\n";
+        }
+    }
+    cout << defaultfloat << right;
+
+    if (!exported) {
+        cout << ANSI_COLOR_RED << "Metrics files could not be written" << ANSI_COLOR_RESET << "\n";
+    }
+    getch(); // Wait for user input
+};
 
 /**
  * @brief Adds a new part to the inventory.
@@ -661,7 +986,6 @@ void Monthly_service_stats() { cout << "Monthly Service Stats" << endl; };
  */
 void AddParts() {
     Part newPart;
-    newPart.partID = partID++; // Assign a unique part ID
 
     showText("Add Parts", { "Enter the part name: ", "Enter the car model: ", "Enter the price of the part:" });
 
@@ -672,7 +996,8 @@ void AddParts() {
     gotoxy(50, 15);
     cin >> newPart.price;
 
-    partHash[to_string(newPart.partID)] = newPart; // Add part to the inventory
+    ensurePartsLoaded();
+    addPart(newPart); // Assign a unique part ID and add part to the inventory
     writePartToFile(newPart, partfileName); // Write part information to a file
 
     cout << "Part successfully added." << endl;
@@ -685,9 +1010,10 @@ void AddParts() {
  * through pages, search for parts by model, or return to the main menu.
  */
 void ListParts() {
+    ensurePartsLoaded();
     int page = 1;
     int pageSize = 14;
-    int totalParts = partHash.size();
+    int totalParts = CountParts();
     int totalPages = (totalParts + pageSize - 1) / pageSize;
 
     while (true) {
@@ -697,17 +1023,9 @@ void ListParts() {
         cout << "          Part Name | Vehicle Model | Price\n";
 
         int startPart = (page - 1) * pageSize;
-        int endPart = min(startPart + pageSize, totalParts);
 
-        auto it = partHash.begin();
-        advance(it, startPart);
-
-        for (int i = startPart; i < endPart; i++) {
-            if (it == partHash.end()) {
-                break;
-            }
-            cout << " | " << setw(21) << it->second.name << " | " << setw(13) << it->second.compatiblemodel << " | " << it->second.price << endl;
-            ++it;
+        for (const Part& part : listPartsPage(startPart, pageSize)) {
+            cout << " | " << setw(21) << part.name << " | " << setw(13) << part.compatiblemodel << " | " << part.price << endl;
         }
 
         gotoxy(11, 24);
@@ -736,17 +1054,13 @@ void ListParts() {
             cin >> searchModel;
 
             gotoxy(9, 12);
-            it = partHash.begin();
             int count = 1;
             gotoxy(21, 11);
             cout << "Part name | Price ";
-            while (it != partHash.end()) {
-                if (it->second.compatiblemodel == searchModel) {
-                    gotoxy(9, 11 + count);
-                    cout << setw(21) << it->second.name << " | " << it->second.price;
-                    count++;
-                }
-                ++it;
+            for (const Part& part : findPartsByModel(searchModel)) {
+                gotoxy(9, 11 + count);
+                cout << setw(21) << part.name << " | " << part.price;
+                count++;
             }
 
             gotoxy(11, 26);
@@ -800,7 +1114,7 @@ void Customer_Communication_Platforms() { cout << "Customer Communication Platfo
  * @brief Manages customer and vehicle information.
  *
  * This function presents a menu with options for registration, updating, deleting, viewing service history,
- * listing current vehicles, or returning to the main menu. It utilizes the showMenu function to display the menu options
+ * listing current vehicles, viewing a customer's fleet, or returning to the main menu. It utilizes the showMenu function to display the menu options
  * and calls corresponding functions based on the user's choice.
  */
 void Customer_and_vehicle_management() {
@@ -810,9 +1124,13 @@ void Customer_and_vehicle_management() {
         "Deleting",
         "Service History",
         "List Current Vehicles",
+        "Customer Fleet",
+        "Quick Search",
         "Main Menu"
     };
 
+    subsystemPrefetcher.hint(ensureVehiclesLoaded, true); // Every screen of this menu but one needs the vehicles
+
     while (true) {
         int choice = showMenu("Customer and Vehicle Management", options);
 
@@ -833,6 +1151,12 @@ void Customer_and_vehicle_management() {
             ListVehicles(); // Call function to list current vehicles
             break;
         case 5:
+            CustomerFleet(); // Call function to list a customer's vehicles and appointments
+            break;
+        case 6:
+            QuickSearch(); // Call function to search customers, plates, models and parts
+            break;
+        case 7:
             return; // Return to the main menu
         }
     }
@@ -842,7 +1166,8 @@ void Customer_and_vehicle_management() {
  * @brief Manages service appointment scheduling.
  *
  * This function presents a menu with options to create an appointment, list appointments,
- * estimate labor costs, provide service feedback, or return to the main menu.
+ * estimate labor costs, provide service feedback, list appointment conflicts, manage recurring contracts,
+ * or return to the main menu.
  * It utilizes the showMenu function to display the menu options and calls corresponding functions
  * based on the user's choice.
  */
@@ -852,9 +1177,15 @@ void Service_appointment_scheduling() {
         "List appointments",
         "Labor Cost Estimation",
         "Service Feedback",
+        "Appointment Conflicts",
+        "Recurring Contract",
+        "Contract Visits",
         "Main Menu"
     };
 
+    subsystemPrefetcher.hint(ensurePartsLoaded, true); // Needed by the labor cost estimation
+    subsystemPrefetcher.hint(ensureAppointmentsLoaded, true); // Needed by creating and listing appointments
+
     while (true) {
         int choice = showMenu("Service Appointment Scheduling", options);
 
@@ -872,6 +1203,15 @@ void Service_appointment_scheduling() {
             Service_Feedback(); // Call function to provide service feedback
             break;
         case 4:
+            Appointment_Conflicts(); // Call function to list vehicles booked too close together
+            break;
+        case 5:
+            Recurring_Contract(); // Call function to create a recurring appointment contract
+            break;
+        case 6:
+            Contract_Visits(); // Call function to list the contract visits of a month
+            break;
+        case 7:
             return; // Return to the main menu
             break;
         }
@@ -914,7 +1254,7 @@ void Warranty_and_maintenance_tracking() {
  * @brief Manages reporting functions.
  *
  * This function presents a menu with options for common issues, customer feedback,
- * monthly service statistics, or returning to the main menu.
+ * monthly service statistics, performance metrics, or returning to the main menu.
  * It utilizes the showMenu function to display the menu options and calls corresponding functions
  * based on the user's choice.
  */
@@ -923,6 +1263,8 @@ void Reporting() {
         "Common Issues",
         "Customer Feedback",
         "Monthly Service Stats",
+        "Performance Metrics",
+        "Search Feedback and History",
         "Main Menu"
     };
 
@@ -940,6 +1282,12 @@ void Reporting() {
             Monthly_service_stats(); // Call function to display monthly service statistics
             break;
         case 3:
+            Performance_metrics(); // Call function to display and export performance metrics
+            break;
+        case 4:
+            Search_records(); // Call function to search feedback and service history
+            break;
+        case 5:
             return; // Return to the main menu
             break;
         }
@@ -1019,6 +1367,10 @@ int mainMenu() {
             Integrations(); // Call function for integrations
             break;
         case 5:
+            stopSubsystems(); // Stop prefetching and commit the queued appointments
+            if (printStartupTiming) {
+                cerr << startupTimingReport(firstMenuMilliseconds);
+            }
             exit(0); // Exit the program
         }
     }
@@ -1029,12 +1381,18 @@ int mainMenu() {
 /**
  * @brief Main entry point of the program.
  *
- * This function loads vehicle and part information from files, initializes appointment matrices,
- * and calls the main menu function to start the program.
+ * This function starts loading vehicles, the appointment matrix and parts in the
+ * background and calls the main menu function at once; each screen waits only for
+ * the data it uses. With --startup-timing, the time to the first menu and the load
+ * time of every subsystem are printed to stderr on exit.
  */
-int main() {
-    loadVehiclesFromFile(vehiclefileName); // Load vehicle information from a file
-    initializeAppointmentMatrix(2050, 13, 30); // Initialize appointment matrices
-    loadPartsFromFile(partfileName); // Load part information from a file
+int main(int argc, char* argv[]) {
+    auto programStart = chrono::steady_clock::now();
+    for (int i = 1; i < argc; ++i) {
+        printStartupTiming = printStartupTiming || string(argv[i]) == "--startup-timing";
+    }
+
+    startSubsystemPrefetch(); // Load vehicles, appointments and parts in the background
+    firstMenuMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - programStart).count();
     mainMenu(); // Call the main menu function to start the program
 }